@@ -7,6 +7,7 @@
 #ifndef INCLUDE_HUBBLE_BLE_H
 #define INCLUDE_HUBBLE_BLE_H
 
+#include <errno.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -37,6 +38,19 @@ extern "C" {
  */
 #define HUBBLE_BLE_MAX_DATA_LEN 13
 
+/**
+ * @brief Size in bytes of each frame filled by
+ *        @ref hubble_ble_advertise_batch_get
+ *
+ * It is the maximum length of a legacy advertisement data.
+ */
+#define HUBBLE_BLE_ADV_FRAME_SIZE 31
+
+/**
+ * @brief Size in bytes of the authentication tag of an advertisement
+ */
+#define HUBBLE_BLE_AUTH_TAG_SIZE 4U
+
 /**
  * @brief Retrieves advertisements from the provided data.
  *
@@ -82,6 +96,317 @@ extern "C" {
 int hubble_ble_advertise_get(const uint8_t *input, size_t input_len,
 			     uint8_t *out, size_t *out_len);
 
+/**
+ * @brief Retrieves several consecutive advertisements in one call.
+ *
+ * Builds @p count advertisements of the same payload for the sequence
+ * numbers [@p seq_no, @p seq_no + @p count), wrapping at 1023, into
+ * @p out. Each frame is what @ref hubble_ble_advertise_get would return
+ * for that sequence number. The keys derived from the master key are
+ * derived once for the whole batch and the nonce check is done once for
+ * the whole range.
+ *
+ * It is meant to load a whole advertisement schedule at once, e.g. into
+ * periodic advertising sets or device emulators.
+ *
+ * Example:
+ *
+ * @code
+ * uint8_t frames[8][HUBBLE_BLE_ADV_FRAME_SIZE];
+ * size_t frame_len;
+ * int status = hubble_ble_advertise_batch_get(data, data_len, seq_no,
+ *                                             ARRAY_SIZE(frames), frames,
+ *                                             &frame_len);
+ * @endcode
+ *
+ * @note - This function is neither thread-safe nor reentrant. The caller must
+ *         ensure proper synchronization.
+ *       - The sequence numbers are given by the caller,
+ *         hubble_sequence_counter_get() is not called.
+ *       - All frames use the current time counter.
+ *
+ * @param input Pointer to the input data.
+ * @param input_len Length of the input data.
+ * @param seq_no Sequence number of the first advertisement [0-1023].
+ * @param count Number of advertisements to build [1-1024].
+ * @param out Array of at least @p count frames.
+ * @param out_len Length of each advertisement in @p out.
+ *
+ * @return
+ *          - 0 on success
+ *          - -EPERM if any sequence number would re-use a nonce
+ *          - Non-zero on failure
+ */
+int hubble_ble_advertise_batch_get(const uint8_t *input, size_t input_len,
+				   uint16_t seq_no, size_t count,
+				   uint8_t out[][HUBBLE_BLE_ADV_FRAME_SIZE],
+				   size_t *out_len);
+
+#if defined(CONFIG_HUBBLE_BLE_NETWORK_PRECOMPUTE) || defined(__DOXYGEN__)
+
+/**
+ * @brief Pre-compute the cryptographic material of upcoming advertisements.
+ *
+ * Derives the nonce, encryption key and device ID for the sequence numbers
+ * [@p seq_no, @p seq_no + @p count) ahead of time. A later call to
+ * @ref hubble_ble_advertise_get with one of these sequence numbers (in the
+ * same time counter period) then only encrypts and authenticates the
+ * payload. For an empty payload the advertisement is fully ready and no
+ * cryptographic operation is done.
+ *
+ * This is meant to be called when the system is idle, off the
+ * advertisement rotation path.
+ *
+ * @code
+ * // Next advertisement will use sequence number seq_no
+ * int ret = hubble_ble_advertise_precompute(seq_no, 4);
+ * @endcode
+ *
+ * @note - This function is only available when
+ *         @kconfig{CONFIG_HUBBLE_BLE_NETWORK_PRECOMPUTE} is enabled.
+ *         When the option is disabled, calls to this function return
+ *         @c -ENOSYS.
+ *       - It may be preempted by @ref hubble_ble_advertise_get on a
+ *         single core system. It must not preempt it.
+ *       - Pre-computed values are dropped when the key or the UTC time
+ *         is set.
+ *
+ * @param seq_no First sequence number to pre-compute [0-1023].
+ * @param count  Number of consecutive sequence numbers. It can not be
+ *               bigger than
+ *               @kconfig{CONFIG_HUBBLE_BLE_NETWORK_PRECOMPUTE_SLOTS}.
+ *
+ * @return
+ *          - 0 on success
+ *          - Non-zero on failure
+ */
+int hubble_ble_advertise_precompute(uint16_t seq_no, uint8_t count);
+
+/**
+ * @brief Schedule @ref hubble_ble_advertise_precompute in background.
+ *
+ * Submits the pre-computation to a work queue running at the lowest
+ * application priority, so it only runs when the CPU is otherwise idle.
+ * A new request replaces a pending one.
+ *
+ * @note This function is provided by the Zephyr port. Other platforms
+ *       should call @ref hubble_ble_advertise_precompute from their own
+ *       low priority context.
+ *
+ * @param seq_no First sequence number to pre-compute [0-1023].
+ * @param count  Number of consecutive sequence numbers.
+ *
+ * @return
+ *          - 0 on success
+ *          - Non-zero on failure
+ */
+int hubble_ble_advertise_precompute_submit(uint16_t seq_no, uint8_t count);
+
+#else
+
+static inline int hubble_ble_advertise_precompute(uint16_t seq_no,
+						  uint8_t count)
+{
+	(void)seq_no;
+	(void)count;
+
+	return -ENOSYS;
+}
+
+static inline int hubble_ble_advertise_precompute_submit(uint16_t seq_no,
+							 uint8_t count)
+{
+	(void)seq_no;
+	(void)count;
+
+	return -ENOSYS;
+}
+
+#endif /* CONFIG_HUBBLE_BLE_NETWORK_PRECOMPUTE */
+
+#if defined(CONFIG_HUBBLE_BLE_NETWORK_DECODER) || defined(__DOXYGEN__)
+
+/**
+ * @brief Fields of an advertisement, as returned by
+ *        @ref hubble_ble_frame_parse
+ */
+struct hubble_ble_frame {
+	/** Protocol version */
+	uint8_t version;
+	/** Sequence number [0-1023] */
+	uint16_t seq_no;
+	/** Ephemeral device ID, in the byte order it is carried on air */
+	uint32_t eid;
+	/** Authentication tag, @ref HUBBLE_BLE_AUTH_TAG_SIZE bytes */
+	const uint8_t *auth_tag;
+	/** Encrypted payload */
+	const uint8_t *data;
+	/** Length of the encrypted payload in bytes */
+	size_t data_len;
+};
+
+/** @cond INTERNAL_HIDDEN */
+
+/* Same as HUBBLE_NONCE_BUFFER_SIZE, checked in hubble_ble.c */
+#define HUBBLE_BLE_DECODER_NONCE_SIZE 16
+
+struct hubble_ble_decoder_day {
+	const void *key;
+	uint32_t time_counter;
+	uint32_t device_id;
+	uint32_t last_used;
+	uint8_t nonce_key[CONFIG_HUBBLE_KEY_SIZE];
+	uint8_t encryption_key[CONFIG_HUBBLE_KEY_SIZE];
+};
+
+struct hubble_ble_decoder_seq {
+	const void *key;
+	uint32_t time_counter;
+	uint32_t device_id;
+	uint32_t last_used;
+	uint16_t seq_no;
+	/* Last authenticated advertisement, adv_len is 0 if none */
+	uint8_t adv_len;
+	uint8_t adv[HUBBLE_BLE_ADV_FRAME_SIZE];
+	uint8_t plaintext[HUBBLE_BLE_MAX_DATA_LEN];
+	uint8_t nonce_counter[HUBBLE_BLE_DECODER_NONCE_SIZE];
+	uint8_t encryption_key[CONFIG_HUBBLE_KEY_SIZE];
+};
+
+/** @endcond */
+
+/**
+ * @brief Advertisement decoder.
+ *
+ * Remembers the keys derived for the most recent (key, time counter)
+ * and (key, time counter, sequence number) combinations, and the last
+ * frame authenticated for each of the latter. Receiving again a frame
+ * already decoded only costs a comparison.
+ *
+ * The number of entries is set by
+ * @kconfig{CONFIG_HUBBLE_BLE_NETWORK_DECODER_DAY_SLOTS} and
+ * @kconfig{CONFIG_HUBBLE_BLE_NETWORK_DECODER_SEQ_SLOTS}.
+ */
+struct hubble_ble_decoder {
+	/** @cond INTERNAL_HIDDEN */
+	uint32_t clock;
+	struct hubble_ble_decoder_day
+		days[CONFIG_HUBBLE_BLE_NETWORK_DECODER_DAY_SLOTS];
+	struct hubble_ble_decoder_seq
+		seqs[CONFIG_HUBBLE_BLE_NETWORK_DECODER_SEQ_SLOTS];
+	/** @endcond */
+};
+
+/**
+ * @brief One advertisement of a batch given to
+ *        @ref hubble_ble_decode_batch
+ */
+struct hubble_ble_decode_job {
+	/** Key the advertisement is expected to be encrypted with */
+	const void *key;
+	/** Time counter the advertisement is expected to be built for */
+	uint32_t time_counter;
+	/** Advertisement (service data starting with the UUID) */
+	const uint8_t *adv;
+	/** Length of the advertisement in bytes */
+	size_t adv_len;
+	/** Output decrypted payload */
+	uint8_t data[HUBBLE_BLE_MAX_DATA_LEN];
+	/** Output length of the decrypted payload */
+	size_t data_len;
+	/** Output result, same as @ref hubble_ble_decode */
+	int err;
+};
+
+/**
+ * @brief Split an advertisement in its fields.
+ *
+ * @param adv     Service data as returned by @ref hubble_ble_advertise_get,
+ *                starting with the 16-bit UUID.
+ * @param adv_len Length of @p adv in bytes.
+ * @param frame   Output fields, pointing into @p adv.
+ *
+ * @return
+ *          - 0 on success
+ *          - -EINVAL if @p adv is not a Hubble advertisement
+ */
+int hubble_ble_frame_parse(const uint8_t *adv, size_t adv_len,
+			   struct hubble_ble_frame *frame);
+
+/**
+ * @brief Initialize an advertisement decoder.
+ *
+ * @param decoder Decoder to initialize.
+ */
+void hubble_ble_decoder_init(struct hubble_ble_decoder *decoder);
+
+/**
+ * @brief Forget everything a decoder remembers.
+ *
+ * The derived keys are cleared with hubble_crypto_zeroize(). It must be
+ * called before a key known by the decoder is freed or changed.
+ *
+ * @param decoder Decoder to clear.
+ */
+void hubble_ble_decoder_clear(struct hubble_ble_decoder *decoder);
+
+/**
+ * @brief Authenticate and decrypt an advertisement.
+ *
+ * Checks that the advertisement was built with @p key for
+ * @p time_counter and decrypts its payload. The key is identified by its
+ * address, it must stay valid and unchanged until the decoder is cleared.
+ *
+ * @note This function is neither thread-safe nor reentrant for the same
+ *       decoder.
+ *
+ * @param decoder      Decoder.
+ * @param key          Master key of the device (CONFIG_HUBBLE_KEY_SIZE
+ *                     bytes).
+ * @param time_counter Time counter the advertisement was built for.
+ * @param adv          Service data, starting with the 16-bit UUID.
+ * @param adv_len      Length of @p adv in bytes.
+ * @param out          Output buffer of at least
+ *                     @ref HUBBLE_BLE_MAX_DATA_LEN bytes.
+ * @param out_len      Output length of the decrypted payload.
+ *
+ * @return
+ *          - 0 on success
+ *          - -EINVAL if @p adv is not a Hubble advertisement
+ *          - -ENOTSUP if the protocol version is not supported
+ *          - -EBADMSG if the advertisement was not built with @p key for
+ *            @p time_counter or was modified
+ *          - Other negative error code on failure
+ */
+int hubble_ble_decode(struct hubble_ble_decoder *decoder, const void *key,
+		      uint32_t time_counter, const uint8_t *adv,
+		      size_t adv_len, uint8_t *out, size_t *out_len);
+
+/**
+ * @brief Authenticate and decrypt a batch of advertisements.
+ *
+ * Same results as calling @ref hubble_ble_decode for each job, in order.
+ * The jobs are processed in groups of up to 8 (fewer if
+ * @kconfig{CONFIG_HUBBLE_BLE_NETWORK_DECODER_SEQ_SLOTS} is smaller): all
+ * the frames of a group are parsed and matched with the decoder entries
+ * first, then the missing per-packet keys are derived with one request
+ * per day, then the frames are authenticated and decrypted. With
+ * @kconfig{CONFIG_HUBBLE_NETWORK_CRYPTO_CMAC_MULTI} the crypto provider
+ * computes the derivations of a day together.
+ *
+ * @param decoder Decoder.
+ * @param jobs    Advertisements to decode, the results are written in
+ *                each job.
+ * @param count   Number of jobs.
+ *
+ * @return Number of advertisements successfully decoded.
+ */
+size_t hubble_ble_decode_batch(struct hubble_ble_decoder *decoder,
+			       struct hubble_ble_decode_job *jobs,
+			       size_t count);
+
+#endif /* CONFIG_HUBBLE_BLE_NETWORK_DECODER */
+
 /**
  * @}
  */
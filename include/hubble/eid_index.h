@@ -0,0 +1,312 @@
+/*
+ * Copyright (c) 2026 Hubble Network, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef INCLUDE_HUBBLE_EID_INDEX_H
+#define INCLUDE_HUBBLE_EID_INDEX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Hubble EID resolver index APIs
+ * @defgroup hubble_eid_index_api EID resolver index APIs
+ * @{
+ *
+ * Backend side helper to find which master key produced the ephemeral
+ * device ID (EID) carried by a BLE advertisement or a satellite packet.
+ *
+ * The index holds the EID of every key of a fleet for a sliding window
+ * of time counters in an open addressing hash table. It is a single
+ * flat buffer without pointers, so it can live in a file mapped in
+ * memory and be shared by several processes. When the day rolls only
+ * the EIDs of the time counters entering the window are derived.
+ *
+ * The index does not hold the keys. They are passed as an array where
+ * each key is identified by its position.
+ *
+ * Lookups can run concurrently on the same index, updates need
+ * exclusive access.
+ */
+
+/** @brief Value of @ref hubble_eid_index.magic */
+#define HUBBLE_EID_INDEX_MAGIC 0x58444945U
+
+/** @brief Value of @ref hubble_eid_index.version */
+#define HUBBLE_EID_INDEX_VERSION 1U
+
+/** @brief Key index of an unused slot */
+#define HUBBLE_EID_INDEX_KEY_NONE UINT32_MAX
+
+/**
+ * @brief EID of one key for one time counter.
+ */
+struct hubble_eid_index_entry {
+	/** EID, in the byte order it is carried on air */
+	uint32_t eid;
+	/** Position of the key in the key array */
+	uint32_t key_index;
+	/** Time counter the EID was derived for */
+	uint32_t time_counter;
+};
+
+/**
+ * @brief EID resolver index.
+ *
+ * Header followed by the hash table slots. All fields are in host byte
+ * order, a file is only portable between hosts of the same endianness.
+ */
+struct hubble_eid_index {
+	/** @ref HUBBLE_EID_INDEX_MAGIC */
+	uint32_t magic;
+	/** @ref HUBBLE_EID_INDEX_VERSION */
+	uint16_t version;
+	/** Size of the keys the EIDs were derived from */
+	uint16_t key_size;
+	/** Number of keys */
+	uint32_t key_count;
+	/** Number of time counters in the window */
+	uint32_t window;
+	/** First time counter of the window */
+	uint32_t time_counter;
+	/** Number of time counters currently indexed (0 or window) */
+	uint32_t days;
+	/** log2 of the number of slots */
+	uint32_t slot_bits;
+	/** Number of slots in use */
+	uint32_t entry_count;
+	/** Hash table, unused slots have @ref HUBBLE_EID_INDEX_KEY_NONE */
+	struct hubble_eid_index_entry slots[];
+};
+
+/**
+ * @brief Size of an index.
+ *
+ * The hash table is sized to stay at most 75% full.
+ *
+ * @param key_count Number of keys.
+ * @param window    Number of time counters.
+ *
+ * @return Size in bytes of the index, 0 if the parameters are invalid or
+ *         the index would be too big.
+ */
+size_t hubble_eid_index_size(uint32_t key_count, uint32_t window);
+
+/**
+ * @brief Initialize an empty index.
+ *
+ * @param index     Buffer of at least hubble_eid_index_size() bytes,
+ *                  aligned on 4 bytes.
+ * @param size      Size of @p index in bytes.
+ * @param key_count Number of keys.
+ * @param window    Number of time counters.
+ *
+ * @return 0 on success, -EINVAL if a parameter is invalid or the buffer
+ *         too small.
+ */
+int hubble_eid_index_init(struct hubble_eid_index *index, size_t size,
+			  uint32_t key_count, uint32_t window);
+
+/**
+ * @brief Check that a buffer holds a valid index.
+ *
+ * Meant for indexes loaded from a file.
+ *
+ * @param index Buffer holding the index.
+ * @param size  Size of the buffer in bytes.
+ *
+ * @return 0 if the index is valid and was built for
+ *         CONFIG_HUBBLE_KEY_SIZE keys, -EINVAL otherwise.
+ */
+int hubble_eid_index_check(const struct hubble_eid_index *index, size_t size);
+
+/**
+ * @brief Move the window of an index.
+ *
+ * After this call the index holds the EIDs of all keys for the time
+ * counters [@p time_counter, @p time_counter + window). EIDs already
+ * indexed for those time counters are kept, only the missing ones are
+ * derived, so moving the window by one day costs one derivation per key.
+ *
+ * @param index        Index to update.
+ * @param keys         Keys, @ref hubble_eid_index.key_count of them.
+ * @param time_counter First time counter of the window.
+ *
+ * @return 0 on success, negative error code on failure. On failure the
+ *         index is left empty.
+ */
+int hubble_eid_index_update(struct hubble_eid_index *index,
+			    const uint8_t (*keys)[CONFIG_HUBBLE_KEY_SIZE],
+			    uint32_t time_counter);
+
+/**
+ * @brief Find the entries matching an EID.
+ *
+ * Different keys (or days) can give the same 32 bits EID, so several
+ * entries can match. They are only candidates, use
+ * hubble_eid_index_resolve() to know which one produced a packet.
+ *
+ * @param index       Index to search.
+ * @param eid         EID to look for.
+ * @param matches     Output entries, can be NULL if @p max_matches is 0.
+ * @param max_matches Maximum number of entries written to @p matches.
+ *
+ * @return Number of entries matching @p eid, it can be bigger than
+ *         @p max_matches.
+ */
+size_t hubble_eid_index_lookup(const struct hubble_eid_index *index,
+			       uint32_t eid,
+			       struct hubble_eid_index_entry *matches,
+			       size_t max_matches);
+
+/**
+ * @brief Find the key that produced a BLE advertisement.
+ *
+ * Looks up @p eid and checks the authentication tag of the
+ * advertisement with each candidate until one matches.
+ *
+ * Advertisements carry the encrypted payload. For satellite packets,
+ * which carry the payload in clear, use hubble_eid_index_resolve_sat().
+ *
+ * @param index    Index to search.
+ * @param keys     Keys the index was built with.
+ * @param eid      EID carried by the packet.
+ * @param seq_no   Sequence number carried by the packet.
+ * @param data     Encrypted payload.
+ * @param data_len Length of the encrypted payload in bytes.
+ * @param tag      Authentication tag carried by the packet.
+ * @param tag_len  Length of the authentication tag in bytes.
+ * @param match    Output entry of the key that produced the packet.
+ *
+ * @return 0 on success, -ENOENT if no key produced the packet, other
+ *         negative error code on failure.
+ */
+int hubble_eid_index_resolve(const struct hubble_eid_index *index,
+			     const uint8_t (*keys)[CONFIG_HUBBLE_KEY_SIZE],
+			     uint32_t eid, uint16_t seq_no,
+			     const uint8_t *data, size_t data_len,
+			     const uint8_t *tag, size_t tag_len,
+			     struct hubble_eid_index_entry *match);
+
+/**
+ * @brief Find the key that produced a satellite packet.
+ *
+ * Same as hubble_eid_index_resolve() for satellite packets: they carry
+ * the payload in clear and the tag is computed over its encryption, so
+ * the payload is encrypted with the keys of each candidate before
+ * checking the tag.
+ *
+ * @param index       Index to search.
+ * @param keys        Keys the index was built with.
+ * @param eid         EID carried by the packet.
+ * @param seq_no      Sequence number carried by the packet.
+ * @param payload     Payload carried by the packet.
+ * @param payload_len Length of the payload in bytes, at most
+ *                    HUBBLE_SAT_PAYLOAD_MAX.
+ * @param tag         Authentication tag carried by the packet.
+ * @param tag_len     Length of the authentication tag in bytes.
+ * @param match       Output entry of the key that produced the packet.
+ *
+ * @return 0 on success, -ENOENT if no key produced the packet, other
+ *         negative error code on failure.
+ */
+int hubble_eid_index_resolve_sat(const struct hubble_eid_index *index,
+				 const uint8_t (*keys)[CONFIG_HUBBLE_KEY_SIZE],
+				 uint32_t eid, uint16_t seq_no,
+				 const uint8_t *payload, size_t payload_len,
+				 const uint8_t *tag, size_t tag_len,
+				 struct hubble_eid_index_entry *match);
+
+/**
+ * @brief Derive the EIDs of many keys for a range of time counters.
+ *
+ * The work is spread over several threads which steal work from each
+ * other when they run out of it. The EIDs are the ones
+ * hubble_internal_device_id_get() gives on a device using the key.
+ *
+ * The output is column oriented, one column of @p key_count EIDs per
+ * time counter: the EID of key @c k for time counter
+ * @p time_counter + @c d is at @p eids[@c d * @p key_count + @c k].
+ *
+ * @note Only implemented by the POSIX port. The crypto provider must be
+ *       reentrant, the built-in software provider is.
+ *
+ * @param keys         Keys, @p key_count of them.
+ * @param key_count    Number of keys.
+ * @param time_counter First time counter.
+ * @param days         Number of time counters.
+ * @param eids         Output buffer of @p key_count * @p days EIDs.
+ * @param threads      Number of threads to use, 0 for one per online
+ *                     CPU. The calling thread is one of them.
+ *
+ * @return 0 on success, negative error code on failure.
+ */
+int hubble_eid_batch_get(const uint8_t (*keys)[CONFIG_HUBBLE_KEY_SIZE],
+			 uint32_t key_count, uint32_t time_counter,
+			 uint32_t days, uint32_t *eids, unsigned int threads);
+
+/**
+ * @brief Create an index backed by a file.
+ *
+ * Creates (or truncates) @p path, initializes an empty index in it and
+ * maps it in memory. Changes made to the index are written to the file.
+ *
+ * @note Only implemented by the POSIX port.
+ *
+ * @param path      Path of the file.
+ * @param key_count Number of keys.
+ * @param window    Number of time counters.
+ * @param index     Output mapped index.
+ * @param size      Output size of the mapping.
+ *
+ * @return 0 on success, negative error code on failure.
+ */
+int hubble_eid_index_create(const char *path, uint32_t key_count,
+			    uint32_t window, struct hubble_eid_index **index,
+			    size_t *size);
+
+/**
+ * @brief Map an index previously written to a file.
+ *
+ * @note Only implemented by the POSIX port.
+ *
+ * @param path     Path of the file.
+ * @param writable Whether the index is going to be updated.
+ * @param index    Output mapped index.
+ * @param size     Output size of the mapping.
+ *
+ * @return 0 on success, -EINVAL if the file does not hold a valid index,
+ *         other negative error code on failure.
+ */
+int hubble_eid_index_open(const char *path, bool writable,
+			  struct hubble_eid_index **index, size_t *size);
+
+/**
+ * @brief Unmap an index mapped with hubble_eid_index_create() or
+ *        hubble_eid_index_open().
+ *
+ * @note Only implemented by the POSIX port.
+ *
+ * @param index Mapped index.
+ * @param size  Size of the mapping.
+ *
+ * @return 0 on success, negative error code on failure.
+ */
+int hubble_eid_index_close(struct hubble_eid_index *index, size_t size);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_HUBBLE_EID_INDEX_H */
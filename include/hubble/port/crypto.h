@@ -53,6 +53,17 @@ void hubble_crypto_zeroize(void *buf, size_t len);
  */
 int hubble_crypto_init(void);
 
+/**
+ * @brief Release the key material kept by the crypto provider.
+ *
+ * Providers may keep keys loaded (e.g. imported key handles or keyed
+ * contexts) across operations. This function is called when the master
+ * key or the time counter changes, so that keys that will not be used
+ * anymore are destroyed. Implementing it is optional, a weak default
+ * doing nothing is used by providers that do not keep any key.
+ */
+void hubble_crypto_keys_release(void);
+
 /**
  * @brief Perform AES encryption in Counter (CTR) mode.
  *
@@ -89,6 +100,57 @@ int hubble_crypto_cmac(const uint8_t key[CONFIG_HUBBLE_KEY_SIZE],
 		       const uint8_t *data, size_t len,
 		       uint8_t output[HUBBLE_AES_BLOCK_SIZE]);
 
+/**
+ * @brief Computes the CMAC of several messages under the same key.
+ *
+ * Optional operation, only used when CONFIG_HUBBLE_NETWORK_CRYPTO_CMAC_MULTI
+ * is enabled. It must give the same result as calling hubble_crypto_cmac()
+ * on every message. The messages are independent, so providers
+ * implementing it can process them in parallel, e.g. interleaving the
+ * AES blocks of the different messages.
+ *
+ * @param key The secret key used for CMAC calculation (size:
+ *            CONFIG_HUBBLE_KEY_SIZE).
+ * @param data The input messages.
+ * @param len The length in bytes of every message.
+ * @param count Number of messages.
+ * @param output The CMAC of every message.
+ *
+ * @return 0 on success, non-zero on error.
+ */
+int hubble_crypto_cmac_multi(const uint8_t key[CONFIG_HUBBLE_KEY_SIZE],
+			     const uint8_t *const data[], const size_t len[],
+			     size_t count,
+			     uint8_t output[][HUBBLE_AES_BLOCK_SIZE]);
+
+/**
+ * @brief Encrypt with AES-CTR and compute the CMAC of the ciphertext.
+ *
+ * Optional operation, only used when CONFIG_HUBBLE_NETWORK_CRYPTO_CTR_CMAC
+ * is enabled. It must give the same result as hubble_crypto_aes_ctr()
+ * followed by hubble_crypto_cmac() over the encrypted data, using the
+ * same key for both. Providers implementing it can do both operations
+ * with a single key setup and a single pass over the data.
+ *
+ * @param key A pointer to the key (size: CONFIG_HUBBLE_KEY_SIZE).
+ * @param nonce_counter A pointer to the nonce and counter buffer (size:
+ *                      HUBBLE_NONCE_BUFFER_SIZE).
+ * @param data A pointer to the input data buffer to be encrypted.
+ * @param len The length of the input data in bytes. It can be zero, the
+ *            tag is then the CMAC of an empty message.
+ * @param output A pointer to the output buffer where the encrypted data
+ *               will be stored. It must be at least the size of the input
+ *               data in bytes.
+ * @param tag Pointer to the buffer where the CMAC of the encrypted data
+ *            will be stored (size: HUBBLE_AES_BLOCK_SIZE).
+ *
+ * @return Returns 0 on success, or a non-zero error code on failure.
+ */
+int hubble_crypto_ctr_cmac(const uint8_t key[CONFIG_HUBBLE_KEY_SIZE],
+			   uint8_t nonce_counter[HUBBLE_NONCE_BUFFER_SIZE],
+			   const uint8_t *data, size_t len, uint8_t *output,
+			   uint8_t tag[HUBBLE_AES_BLOCK_SIZE]);
+
 /**
  * @}
  */ /* hubble_crypto */
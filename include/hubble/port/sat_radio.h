@@ -15,7 +15,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
-#include <hubble/sat/packet.h>
+#include <hubble/sat.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -127,6 +127,58 @@ int hubble_sat_channel_next_hop_get(uint8_t hopping_sequence, uint8_t channel,
 int hubble_sat_port_packet_send(const struct hubble_sat_packet *packet,
 				uint8_t retries, uint8_t interval_s);
 
+#ifdef CONFIG_HUBBLE_SAT_NETWORK_ASYNC
+/**
+ * @brief Queue a packet for transmission over the satellite radio.
+ *
+ * Same as hubble_sat_port_packet_send(), but the transmissions are done
+ * from a transmit thread owned by the port and this function returns as
+ * soon as the packet is queued. @p packet must be copied.
+ *
+ * @note This API is thread safe.
+ *
+ * @param packet Pointer to the packet structure containing the data to
+ *               transmit.
+ * @param retries The number of times this packet must be transmit.
+ * @param interval_s The time interval between transmissions.
+ * @param cb Called from the transmit thread with the result, can be NULL.
+ * @param user_data Passed to @p cb.
+ *
+ * @return 0 if the packet was queued, -EAGAIN if the queue is full.
+ */
+int hubble_sat_port_packet_send_async(const struct hubble_sat_packet *packet,
+				      uint8_t retries, uint8_t interval_s,
+				      hubble_sat_packet_sent_cb_t cb,
+				      void *user_data);
+#endif
+
+#ifdef CONFIG_HUBBLE_SAT_NETWORK_PRIORITY
+/**
+ * @brief Queue a packet for transmission by priority.
+ *
+ * Same as hubble_sat_port_packet_send_async(), the packet waits with the
+ * @p options given to hubble_sat_packet_enqueue(). The transmit thread adds
+ * the retries covering the clock drift.
+ *
+ * @note This API does not block and can be called from an interrupt
+ *       handler, but not concurrently from several contexts.
+ *
+ * @param packet Pointer to the packet structure containing the data to
+ *               transmit.
+ * @param retries The number of times this packet must be transmit.
+ * @param interval_s The time interval between transmissions.
+ * @param options Priority, lifetime and coalescing key of the packet.
+ * @param cb Called from the transmit thread with the result, can be NULL.
+ * @param user_data Passed to @p cb.
+ *
+ * @return 0 if the packet was queued, -EAGAIN if the queue is full.
+ */
+int hubble_sat_port_packet_enqueue(
+	const struct hubble_sat_packet *packet, uint8_t retries,
+	uint8_t interval_s, const struct hubble_sat_packet_options *options,
+	hubble_sat_packet_sent_cb_t cb, void *user_data);
+#endif
+
 /**
  * @}
  */
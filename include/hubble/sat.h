@@ -10,6 +10,7 @@
 #include <errno.h>
 #include <stdint.h>
 
+#include <hubble/sat/ephemeris.h>
 #include <hubble/sat/packet.h>
 
 #ifdef __cplusplus
@@ -57,6 +58,286 @@ enum hubble_sat_transmission_mode {
 int hubble_sat_packet_send(const struct hubble_sat_packet *packet,
 			   enum hubble_sat_transmission_mode mode);
 
+/**
+ * @brief Callback reporting the end of an asynchronous transmission.
+ *
+ * It is called from the transmit thread once all the retries of the packet
+ * were done, or as soon as one of them failed. It must not block, and in
+ * particular must not call @ref hubble_sat_packet_send.
+ *
+ * @param status    0 on successful transmission, or a negative error code
+ *                  on failure.
+ * @param user_data Pointer given to @ref hubble_sat_packet_send_async.
+ */
+typedef void (*hubble_sat_packet_sent_cb_t)(int status, void *user_data);
+
+#if defined(CONFIG_HUBBLE_SAT_NETWORK_ASYNC) || defined(__DOXYGEN__)
+
+/**
+ * @brief Queue a packet for transmission and return immediately.
+ *
+ * Same as @ref hubble_sat_packet_send, except that the retries run from a
+ * dedicated transmit thread. The packet is copied, the caller can reuse it
+ * as soon as this function returns.
+ *
+ * The transmit thread keeps several packets in flight: while a packet
+ * waits for its next retry, the ones of the other packets are transmitted.
+ * @ref hubble_sat_packet_send goes through the same thread when this
+ * option is enabled.
+ *
+ * @note This function is only available when
+ *       @kconfig{CONFIG_HUBBLE_SAT_NETWORK_ASYNC} is enabled. When the
+ *       option is disabled, calls to this function return @c -ENOSYS.
+ *
+ * @param packet    Packet to transmit.
+ * @param mode      Desired reliability for the transmission.
+ * @param cb        Called when the transmission is over, can be NULL.
+ * @param user_data Passed to @p cb.
+ *
+ * @retval 0       If the packet was queued.
+ * @retval -EINVAL If @p packet is NULL or @p mode is invalid.
+ * @retval -EAGAIN If the transmit queue is full.
+ */
+int hubble_sat_packet_send_async(const struct hubble_sat_packet *packet,
+				 enum hubble_sat_transmission_mode mode,
+				 hubble_sat_packet_sent_cb_t cb,
+				 void *user_data);
+
+#else
+
+static inline int
+hubble_sat_packet_send_async(const struct hubble_sat_packet *packet,
+			     enum hubble_sat_transmission_mode mode,
+			     hubble_sat_packet_sent_cb_t cb, void *user_data)
+{
+	(void)packet;
+	(void)mode;
+	(void)cb;
+	(void)user_data;
+
+	return -ENOSYS;
+}
+
+#endif /* CONFIG_HUBBLE_SAT_NETWORK_ASYNC */
+
+/**
+ * @brief Options of a packet queued with @ref hubble_sat_packet_enqueue.
+ */
+struct hubble_sat_packet_options {
+	/** The higher, the sooner the packet is transmitted. */
+	uint8_t priority;
+	/**
+	 * Time in milliseconds the packet can wait for its first
+	 * transmission, 0 for no limit.
+	 */
+	uint32_t lifetime_ms;
+	/**
+	 * Coalescing key, 0 for none. A packet supersedes the one with the
+	 * same key not transmitted yet (e.g. a newer reading of the same
+	 * sensor).
+	 */
+	uint16_t key;
+};
+
+#if defined(CONFIG_HUBBLE_SAT_NETWORK_PRIORITY) || defined(__DOXYGEN__)
+
+/**
+ * @brief Queue a packet for transmission by priority.
+ *
+ * Same as @ref hubble_sat_packet_send_async, except that the packets
+ * waiting for the transmit thread are not handed to it in FIFO order: the
+ * packet with the highest priority goes first, the most recent one among
+ * the same priority. Under backlog the airtime goes to the freshest, most
+ * important data:
+ *
+ * - a packet still waiting when its lifetime is over is dropped and @p cb
+ *   is called with @c -ETIMEDOUT;
+ * - a packet with the same non-zero key as one not transmitted yet (e.g.
+ *   held until a pass window opens) replaces it, the callback of the older
+ *   one is called with @c -ECANCELED;
+ * - when @kconfig{CONFIG_HUBBLE_SAT_NETWORK_PRIORITY_QUEUE_SIZE} packets
+ *   are waiting, the oldest one with the lowest priority is dropped to make
+ *   room for a packet with at least that priority, or the new packet is
+ *   dropped. The callback of the packet dropped is called with
+ *   @c -ENOBUFS.
+ *
+ * Packets queued with @ref hubble_sat_packet_send and
+ * @ref hubble_sat_packet_send_async have priority 0, no lifetime and no
+ * key.
+ *
+ * This function does not block nor take any lock, it can be called from
+ * an interrupt handler. It must not be called concurrently from several
+ * contexts (single producer). On FreeRTOS outside of ESP-IDF, the board
+ * must implement hubble_sat_board_in_isr() to tell the two cases apart,
+ * the link fails otherwise.
+ *
+ * @note This function is only available when
+ *       @kconfig{CONFIG_HUBBLE_SAT_NETWORK_PRIORITY} is enabled. When the
+ *       option is disabled, calls to this function return @c -ENOSYS.
+ *
+ * @param packet    Packet to transmit.
+ * @param mode      Desired reliability for the transmission.
+ * @param options   Priority, lifetime and key of the packet, NULL for the
+ *                  defaults (all 0).
+ * @param cb        Called from the transmit thread when the transmission
+ *                  is over or the packet was dropped, can be NULL.
+ * @param user_data Passed to @p cb.
+ *
+ * @retval 0       If the packet was queued.
+ * @retval -EINVAL If @p packet is NULL or @p mode is invalid.
+ * @retval -EAGAIN If the packets are queued faster than the transmit
+ *                 thread picks them up.
+ */
+int hubble_sat_packet_enqueue(const struct hubble_sat_packet *packet,
+			      enum hubble_sat_transmission_mode mode,
+			      const struct hubble_sat_packet_options *options,
+			      hubble_sat_packet_sent_cb_t cb, void *user_data);
+
+#else
+
+static inline int
+hubble_sat_packet_enqueue(const struct hubble_sat_packet *packet,
+			  enum hubble_sat_transmission_mode mode,
+			  const struct hubble_sat_packet_options *options,
+			  hubble_sat_packet_sent_cb_t cb, void *user_data)
+{
+	(void)packet;
+	(void)mode;
+	(void)options;
+	(void)cb;
+	(void)user_data;
+
+	return -ENOSYS;
+}
+
+#endif /* CONFIG_HUBBLE_SAT_NETWORK_PRIORITY */
+
+#if defined(CONFIG_HUBBLE_SAT_NETWORK_SESSION) || defined(__DOXYGEN__)
+
+/**
+ * @brief Begin a transmission session.
+ *
+ * Outside of a session, the radio power amplifier and front-end module
+ * are powered down as soon as no transmission is due. Within a session,
+ * they stay powered while the radio is idle for less than
+ * @kconfig{CONFIG_HUBBLE_SAT_NETWORK_SESSION_IDLE_MS}, so packets sent
+ * back to back (e.g. a backlog flushed during a satellite pass) do not pay
+ * for power cycling and settling time each.
+ *
+ * Sessions can be nested, the radio goes back to the default behavior
+ * when all of them ended.
+ *
+ * @code
+ * hubble_sat_session_begin();
+ * for (int i = 0; i < count; i++) {
+ *         hubble_sat_packet_send_async(&packets[i], mode, NULL, NULL);
+ * }
+ * hubble_sat_session_end();
+ * @endcode
+ *
+ * @note This function is only available when
+ *       @kconfig{CONFIG_HUBBLE_SAT_NETWORK_SESSION} is enabled. When the
+ *       option is disabled, calls to this function return @c -ENOSYS.
+ *
+ * @return 0 on success, or a negative error code on failure.
+ */
+int hubble_sat_session_begin(void);
+
+/**
+ * @brief End a transmission session.
+ *
+ * Packets queued during the session are still transmitted, the radio is
+ * powered down between them.
+ *
+ * @retval 0         On success.
+ * @retval -EALREADY If no session was begun.
+ */
+int hubble_sat_session_end(void);
+
+#else
+
+static inline int hubble_sat_session_begin(void)
+{
+	return -ENOSYS;
+}
+
+static inline int hubble_sat_session_end(void)
+{
+	return -ENOSYS;
+}
+
+#endif /* CONFIG_HUBBLE_SAT_NETWORK_SESSION */
+
+#if defined(CONFIG_HUBBLE_SAT_NETWORK_PASS_WINDOW) || defined(__DOXYGEN__)
+
+/**
+ * @brief Transmit only while a satellite is predicted overhead.
+ *
+ * Queued packets are held until the next pass of the satellite over the
+ * device location, predicted with @ref hubble_next_pass_get, and their
+ * retries are transmitted during the pass. The retries left when the pass
+ * ends wait for the next one. The window is widened on each side by a guard
+ * time covering the clock drift since the last UTC sync (see
+ * @kconfig{CONFIG_HUBBLE_SAT_NETWORK_DEVICE_TDR}).
+ *
+ * @ref hubble_sat_packet_send blocks until the packet was transmitted, which
+ * can take until the end of the next pass.
+ *
+ * @note This function is only available when
+ *       @kconfig{CONFIG_HUBBLE_SAT_NETWORK_PASS_WINDOW} is enabled. When the
+ *       option is disabled, calls to this function return @c -ENOSYS.
+ *
+ * @param orbit Orbital parameters of the satellite, NULL to transmit
+ *              regardless of the passes again.
+ * @param pos   Location of the device.
+ *
+ * @retval 0       On success.
+ * @retval -EINVAL If @p orbit is not NULL and @p pos is NULL.
+ */
+int hubble_sat_pass_window_set(const struct hubble_sat_orbital_params *orbit,
+			       const struct hubble_sat_device_pos *pos);
+
+/**
+ * @brief Transmit only while a satellite is predicted over a region.
+ *
+ * Same as @ref hubble_sat_pass_window_set, for a device known to be within
+ * @p region. The passes are predicted with @ref hubble_next_pass_region_get.
+ *
+ * @param orbit  Orbital parameters of the satellite, NULL to transmit
+ *               regardless of the passes again.
+ * @param region Region the device is in.
+ *
+ * @retval 0       On success.
+ * @retval -EINVAL If @p orbit is not NULL and @p region is NULL.
+ */
+int hubble_sat_pass_window_region_set(
+	const struct hubble_sat_orbital_params *orbit,
+	const struct hubble_sat_device_region *region);
+
+#else
+
+static inline int
+hubble_sat_pass_window_set(const struct hubble_sat_orbital_params *orbit,
+			   const struct hubble_sat_device_pos *pos)
+{
+	(void)orbit;
+	(void)pos;
+
+	return -ENOSYS;
+}
+
+static inline int hubble_sat_pass_window_region_set(
+	const struct hubble_sat_orbital_params *orbit,
+	const struct hubble_sat_device_region *region)
+{
+	(void)orbit;
+	(void)region;
+
+	return -ENOSYS;
+}
+
+#endif /* CONFIG_HUBBLE_SAT_NETWORK_PASS_WINDOW */
+
 #if defined(CONFIG_HUBBLE_SAT_NETWORK_PROTOCOL_DEPRECATED) ||                  \
 	defined(__DOXYGEN__)
 
@@ -90,6 +90,109 @@ struct hubble_sat_packet {
 int hubble_sat_packet_get(struct hubble_sat_packet *packet, const void *payload,
 			  size_t length);
 
+#if defined(CONFIG_HUBBLE_SAT_NETWORK_DECODER) || defined(__DOXYGEN__)
+
+/** @brief Size in bytes of the authentication tag of a packet */
+#define HUBBLE_SAT_AUTH_TAG_SIZE 4U
+
+/**
+ * @brief Fields of a packet recovered by hubble_sat_packet_frame_get().
+ */
+struct hubble_sat_frame {
+	/** Hopping sequence from the PHY header */
+	uint8_t hopping_sequence;
+	/** Channel from the PHY header, only its 4 least significant bits */
+	uint8_t channel;
+	/** Sequence number */
+	uint16_t seq_no;
+	/** Ephemeral device ID, in host byte order */
+	uint32_t eid;
+	/** Authentication tag */
+	uint8_t auth_tag[HUBBLE_SAT_AUTH_TAG_SIZE];
+	/** Payload, not authenticated yet */
+	uint8_t data[HUBBLE_SAT_PAYLOAD_MAX];
+	/** Length of the payload in bytes */
+	size_t data_len;
+	/** Number of symbols fixed by the error correction */
+	size_t corrected;
+};
+
+/**
+ * @brief Recover the fields of a received packet.
+ *
+ * Corrects the PHY header and the payload with their Reed-Solomon
+ * parity symbols, removes the whitening and extracts the fields. The
+ * payload is not authenticated, see hubble_sat_frame_verify().
+ *
+ * @p packet->channel must be the channel the packet was built for (the
+ * first channel of the transmission): the PHY header only carries its 4
+ * least significant bits, but the whitening depends on all of them.
+ *
+ * Symbols that are not valid 6 bits values are handled as erasures.
+ *
+ * @param packet        Received packet.
+ * @param erasures      Indexes in @p packet->data of the symbols received
+ *                      with a low confidence, can be NULL if
+ *                      @p erasure_count is 0.
+ * @param erasure_count Number of entries in @p erasures.
+ * @param frame         Output fields.
+ *
+ * @retval 0        On success.
+ * @retval -EINVAL  If a parameter is invalid or the packet length does not
+ *                  match its header.
+ * @retval -EBADMSG If there are too many errors to correct, or the header
+ *                  does not match @p packet->channel.
+ * @retval -ENOTSUP If the packet uses an unknown protocol version.
+ */
+int hubble_sat_packet_frame_get(const struct hubble_sat_packet *packet,
+				const uint8_t *erasures, size_t erasure_count,
+				struct hubble_sat_frame *frame);
+
+/**
+ * @brief Remove the whitening of the payload symbols of a packet.
+ *
+ * The symbols that follow the PHY header (the payload and its parity
+ * symbols) are XORed with a sequence that depends on the channel the
+ * packet was built for. This is what hubble_sat_packet_frame_get() does
+ * before correcting them, it is provided for receivers that process the
+ * symbols themselves. Applying it twice gives the symbols back.
+ *
+ * @param channel Channel the packet was built for.
+ * @param symbols Symbols following the PHY header, de-whitened in place.
+ * @param len     Number of symbols.
+ *
+ * @retval 0       On success.
+ * @retval -EINVAL If @p channel is not a valid channel, or @p len is
+ *                 longer than the payload of a packet.
+ */
+int hubble_sat_packet_dewhiten(uint8_t channel, uint8_t *symbols, size_t len);
+
+/**
+ * @brief Authenticate the payload of a packet.
+ *
+ * hubble_sat_packet_get() carries the payload as given and computes the
+ * authentication tag over its encryption, so the ciphertext is rebuilt
+ * with the per-packet key to check the tag.
+ *
+ * @param frame        Fields from hubble_sat_packet_frame_get().
+ * @param key          Master key of the device (CONFIG_HUBBLE_KEY_SIZE
+ *                     bytes).
+ * @param time_counter Time counter the packet was built with.
+ * @param payload      Output authenticated payload, at least
+ *                     @p frame->data_len bytes.
+ * @param length       Output length of the payload in bytes.
+ *
+ * @retval 0        On success.
+ * @retval -EINVAL  If a parameter is invalid.
+ * @retval -EBADMSG If the packet was not built with @p key for
+ *                  @p time_counter.
+ */
+int hubble_sat_frame_verify(const struct hubble_sat_frame *frame,
+			    const void *key, uint32_t time_counter,
+			    void *payload, size_t *length);
+
+#endif /* CONFIG_HUBBLE_SAT_NETWORK_DECODER || __DOXYGEN__ */
+
 /**
  * @}
  */
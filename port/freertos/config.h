@@ -24,6 +24,46 @@
  */
 #define CONFIG_HUBBLE_NETWORK_TIMER_COUNTER_DAILY
 
+/*
+ * Cache the keys and device ID derived from the master key while
+ * the time counter does not change. Comment it out to derive them on
+ * every advertisement / packet instead.
+ */
+#define CONFIG_HUBBLE_NETWORK_KEY_CACHE 1
+
+/*
+ * Uncomment to use the built-in constant-time software AES as crypto
+ * provider instead of one implemented by the application.
+ */
+/* #define CONFIG_HUBBLE_NETWORK_CRYPTO_SOFTWARE 1 */
+
+/*
+ * Uncomment if the crypto provider implements hubble_crypto_ctr_cmac()
+ * (the built-in software provider does),
+ * it is then used instead of hubble_crypto_aes_ctr() followed by
+ * hubble_crypto_cmac().
+ */
+/* #define CONFIG_HUBBLE_NETWORK_CRYPTO_CTR_CMAC 1 */
+
+/*
+ * Uncomment if the crypto provider implements hubble_crypto_cmac_multi()
+ * (the built-in software provider does),
+ * it is then used to compute the CMACs of the key derivation at once.
+ */
+/* #define CONFIG_HUBBLE_NETWORK_CRYPTO_CMAC_MULTI 1 */
+
+#ifdef CONFIG_HUBBLE_BLE_NETWORK
+
+/*
+ * Allow upcoming advertisements to be pre-computed with
+ * hubble_ble_advertise_precompute(). The number of slots is the
+ * maximum number of sequence numbers pre-computed at once.
+ */
+/* #define CONFIG_HUBBLE_BLE_NETWORK_PRECOMPUTE 1 */
+#define CONFIG_HUBBLE_BLE_NETWORK_PRECOMPUTE_SLOTS 4
+
+#endif /* CONFIG_HUBBLE_BLE_NETWORK */
+
 #ifdef CONFIG_HUBBLE_SAT_NETWORK
 
 /*
@@ -54,6 +94,61 @@
 #error "Only one protocol can be selected"
 #endif
 
+/*
+ * Uncomment to provide hubble_sat_packet_send_async(). Packets are
+ * transmitted by a dedicated task interleaving the retries of up to
+ * QUEUE_SIZE of them (as many more can wait), the stack size is in words
+ * as for xTaskCreate().
+ */
+/* #define CONFIG_HUBBLE_SAT_NETWORK_ASYNC 1 */
+#define CONFIG_HUBBLE_SAT_NETWORK_ASYNC_QUEUE_SIZE      4
+#define CONFIG_HUBBLE_SAT_NETWORK_ASYNC_STACK_SIZE      512
+#define CONFIG_HUBBLE_SAT_NETWORK_ASYNC_THREAD_PRIORITY (tskIDLE_PRIORITY + 2)
+
+/*
+ * Uncomment to provide hubble_sat_session_begin() and
+ * hubble_sat_session_end() (requires CONFIG_HUBBLE_SAT_NETWORK_ASYNC).
+ * Within a session, the radio stays powered until it is idle for longer
+ * than IDLE_MS milliseconds.
+ */
+/* #define CONFIG_HUBBLE_SAT_NETWORK_SESSION 1 */
+#define CONFIG_HUBBLE_SAT_NETWORK_SESSION_IDLE_MS       1000
+
+#if defined(CONFIG_HUBBLE_SAT_NETWORK_SESSION) &&                              \
+	!defined(CONFIG_HUBBLE_SAT_NETWORK_ASYNC)
+#error "Sessions require CONFIG_HUBBLE_SAT_NETWORK_ASYNC"
+#endif
+
+/*
+ * Uncomment to provide hubble_sat_pass_window_set() and
+ * hubble_sat_pass_window_region_set() (requires
+ * CONFIG_HUBBLE_SAT_NETWORK_ASYNC). Queued packets are then held until
+ * the next predicted satellite pass, DURATION_S is the length in seconds
+ * of the window centered on a pass over a location.
+ */
+/* #define CONFIG_HUBBLE_SAT_NETWORK_PASS_WINDOW 1 */
+#define CONFIG_HUBBLE_SAT_NETWORK_PASS_WINDOW_DURATION_S 600
+
+#if defined(CONFIG_HUBBLE_SAT_NETWORK_PASS_WINDOW) &&                          \
+	!defined(CONFIG_HUBBLE_SAT_NETWORK_ASYNC)
+#error "Pass windows require CONFIG_HUBBLE_SAT_NETWORK_ASYNC"
+#endif
+
+/*
+ * Uncomment to provide hubble_sat_packet_enqueue() (requires
+ * CONFIG_HUBBLE_SAT_NETWORK_ASYNC), which can be called from an ISR.
+ * Up to QUEUE_SIZE packets wait for the transmit task by priority, the
+ * oldest one with the lowest priority is dropped beyond that. Outside of
+ * ESP-IDF, the board must implement hubble_sat_board_in_isr().
+ */
+/* #define CONFIG_HUBBLE_SAT_NETWORK_PRIORITY 1 */
+#define CONFIG_HUBBLE_SAT_NETWORK_PRIORITY_QUEUE_SIZE 8
+
+#if defined(CONFIG_HUBBLE_SAT_NETWORK_PRIORITY) &&                             \
+	!defined(CONFIG_HUBBLE_SAT_NETWORK_ASYNC)
+#error "The priority queue requires CONFIG_HUBBLE_SAT_NETWORK_ASYNC"
+#endif
+
 #endif /* CONFIG_HUBBLE_SAT_NETWORK */
 
 #endif /* INCLUDE_PORT_FREERTOS_CONFIG_H */
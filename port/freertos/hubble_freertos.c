@@ -20,21 +20,6 @@
 
 #include "utils/macros.h"
 
-/**
- * Define weak attribute.
- *
- * This logic is scattered across all FreeRTOS code and modules.
- * Unfortunatelly it does not seems to have a common definition
- * for it so we need to define our own here.
- **/
-#if defined(__CC_ARM)
-#define HUBBLE_WEAK __attribute__((weak))
-#elif defined(__ICCARM__)
-#define HUBBLE_WEAK __weak
-#elif defined(__GNUC__)
-#define HUBBLE_WEAK __attribute__((weak))
-#endif
-
 uint64_t hubble_uptime_get(void)
 {
 	/*
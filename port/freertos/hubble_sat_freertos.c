@@ -6,25 +6,34 @@
 
 #ifdef CONFIG_ESP_IDF_BUILD
 #include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
 #include <freertos/semphr.h>
 #include <freertos/task.h>
 #else
 #include <FreeRTOS.h>
+#include <queue.h>
 #include <semphr.h>
 #include <task.h>
 #endif
 
 #include <errno.h>
+#include <stdbool.h>
 
 #include <hubble/port/sat_radio.h>
 #include <hubble/port/sys.h>
 
+#include "hubble_priv.h"
+#include "hubble_sat_pass.h"
+#include "hubble_sat_queue.h"
+#include "hubble_sat_scheduler.h"
 #include "sat_board.h"
 #include "utils/macros.h"
 
 #define MSEC_PER_SEC 1000U
 
+#ifndef CONFIG_HUBBLE_SAT_NETWORK_ASYNC
 static SemaphoreHandle_t _transmit_sem;
+#endif
 
 static inline int16_t _time_offset_get_ms(void)
 {
@@ -39,6 +48,7 @@ static inline int16_t _time_offset_get_ms(void)
 	return offset_values[rand_value / 52];
 }
 
+#ifndef CONFIG_HUBBLE_SAT_NETWORK_ASYNC
 int hubble_sat_port_packet_send(const struct hubble_sat_packet *packet,
 				uint8_t retries, uint8_t interval_s)
 {
@@ -78,9 +88,571 @@ enable_error:
 	(void)xSemaphoreGive(_transmit_sem);
 	return ret;
 }
+#else /* CONFIG_HUBBLE_SAT_NETWORK_ASYNC */
+struct _transmit_request {
+	struct hubble_sat_packet packet;
+	hubble_sat_packet_sent_cb_t cb;
+	void *user_data;
+	uint8_t retries;
+	uint8_t interval_s;
+};
+
+struct _sync_request {
+	SemaphoreHandle_t sem;
+	int ret;
+};
+
+static QueueHandle_t _transmit_queue;
+
+/* Notified when the transmit task has something new to look at. Wake-ups
+ * do not take room in the queue, so they cannot fill it.
+ */
+static TaskHandle_t _transmit_task_handle;
+
+static void _wake_up(void)
+{
+	if (_transmit_task_handle != NULL) {
+		(void)xTaskNotifyGive(_transmit_task_handle);
+	}
+}
+
+/* Packets in flight, only touched by the transmit task */
+static struct hubble_sat_scheduler_entry
+	_transmit_entries[CONFIG_HUBBLE_SAT_NETWORK_ASYNC_QUEUE_SIZE];
+static struct hubble_sat_scheduler _transmit_sched;
+
+static int _request_put(const struct hubble_sat_packet *packet,
+			uint8_t retries, uint8_t interval_s,
+			hubble_sat_packet_sent_cb_t cb, void *user_data,
+			TickType_t timeout)
+{
+	struct _transmit_request request = {
+		.packet = *packet,
+		.cb = cb,
+		.user_data = user_data,
+		.retries = retries,
+		.interval_s = interval_s,
+	};
+
+	if (_transmit_queue == NULL) {
+		return -EAGAIN;
+	}
+
+	if (xQueueSend(_transmit_queue, &request, timeout) != pdTRUE) {
+		return -EAGAIN;
+	}
+
+	_wake_up();
+
+	return 0;
+}
+
+static void _sync_sent_cb(int status, void *user_data)
+{
+	struct _sync_request *sync = user_data;
+
+	sync->ret = status;
+	(void)xSemaphoreGive(sync->sem);
+}
+
+int hubble_sat_port_packet_send(const struct hubble_sat_packet *packet,
+				uint8_t retries, uint8_t interval_s)
+{
+	struct _sync_request sync;
+	int ret;
+
+	/* Goes through the transmit task as well, so its retries are
+	 * interleaved with the ones of the queued packets.
+	 */
+	sync.sem = xSemaphoreCreateBinary();
+	if (sync.sem == NULL) {
+		return -ENOMEM;
+	}
+
+	ret = _request_put(packet, retries, interval_s, _sync_sent_cb, &sync,
+			   portMAX_DELAY);
+	if (ret == 0) {
+		(void)xSemaphoreTake(sync.sem, portMAX_DELAY);
+		ret = sync.ret;
+	}
+
+	vSemaphoreDelete(sync.sem);
+
+	return ret;
+}
+
+int hubble_sat_port_packet_send_async(const struct hubble_sat_packet *packet,
+				      uint8_t retries, uint8_t interval_s,
+				      hubble_sat_packet_sent_cb_t cb,
+				      void *user_data)
+{
+	return _request_put(packet, retries, interval_s, cb, user_data, 0);
+}
+
+#ifdef CONFIG_HUBBLE_SAT_NETWORK_PRIORITY
+#ifdef CONFIG_ESP_IDF_BUILD
+/* Not portable, boards on other ports provide it */
+HUBBLE_WEAK bool hubble_sat_board_in_isr(void)
+{
+	return xPortInIsrContext() != pdFALSE;
+}
+#endif
+
+/* Packets waiting for the scheduler, the ring is filled by
+ * hubble_sat_port_packet_enqueue() and drained by the transmit task.
+ */
+static struct hubble_sat_queue_item
+	_queue_ring[CONFIG_HUBBLE_SAT_NETWORK_PRIORITY_QUEUE_SIZE + 1];
+static struct hubble_sat_queue_entry
+	_queue_pool[CONFIG_HUBBLE_SAT_NETWORK_PRIORITY_QUEUE_SIZE];
+static struct hubble_sat_queue _queue =
+	HUBBLE_SAT_QUEUE_INITIALIZER(_queue_ring, _queue_pool);
+
+int hubble_sat_port_packet_enqueue(
+	const struct hubble_sat_packet *packet, uint8_t retries,
+	uint8_t interval_s, const struct hubble_sat_packet_options *options,
+	hubble_sat_packet_sent_cb_t cb, void *user_data)
+{
+	struct hubble_sat_queue_item item = {
+		.packet = *packet,
+		.cb = cb,
+		.user_data = user_data,
+		.lifetime_ms = options->lifetime_ms,
+		.key = options->key,
+		.priority = options->priority,
+		.retries = retries,
+		.interval_s = interval_s,
+	};
+	BaseType_t woken = pdFALSE;
+	int ret;
+
+	if (_transmit_task_handle == NULL) {
+		return -EAGAIN;
+	}
+
+	ret = hubble_sat_queue_push(&_queue, &item);
+	if (ret != 0) {
+		return ret;
+	}
+
+	/* Wake the transmit task up, the ring is drained whenever it runs */
+	if (hubble_sat_board_in_isr()) {
+		vTaskNotifyGiveFromISR(_transmit_task_handle, &woken);
+		portYIELD_FROM_ISR(woken);
+	} else {
+		_wake_up();
+	}
+
+	return 0;
+}
+#endif /* CONFIG_HUBBLE_SAT_NETWORK_PRIORITY */
+
+/* Uptime in milliseconds, only called from the transmit task */
+static uint64_t _now_ms(void)
+{
+	static uint64_t overflow_ticks;
+	static TickType_t last_ticks;
+	TickType_t ticks = xTaskGetTickCount();
+
+	if (ticks < last_ticks) {
+		overflow_ticks += (uint64_t)1 << (sizeof(TickType_t) * 8);
+	}
+	last_ticks = ticks;
+
+	return (((uint64_t)ticks + overflow_ticks) * MSEC_PER_SEC) /
+	       configTICK_RATE_HZ;
+}
+
+/* Ticks to wait for wait_ms. pdMS_TO_TICKS() would overflow, long waits
+ * are cut short instead, the transmit task checks again when they end.
+ */
+static TickType_t _ticks_get(uint64_t wait_ms)
+{
+	const uint64_t max_ticks = (uint64_t)portMAX_DELAY - 1U;
+
+	if (wait_ms == HUBBLE_SAT_SCHEDULER_WAIT_FOREVER) {
+		return portMAX_DELAY;
+	}
+
+	if ((wait_ms / MSEC_PER_SEC) >= (max_ticks / configTICK_RATE_HZ)) {
+		return (TickType_t)max_ticks;
+	}
+
+	return (TickType_t)((wait_ms * configTICK_RATE_HZ) / MSEC_PER_SEC);
+}
+
+/* Board power, only touched by the transmit task */
+static bool _board_enabled;
+static uint64_t _board_last_ms;
+
+#if defined(CONFIG_HUBBLE_SAT_NETWORK_SESSION) ||                              \
+	defined(CONFIG_HUBBLE_SAT_NETWORK_PASS_WINDOW)
+/* The SMP port of ESP-IDF takes a spinlock in its critical sections */
+#ifdef CONFIG_ESP_IDF_BUILD
+static portMUX_TYPE _lock = portMUX_INITIALIZER_UNLOCKED;
+
+#define _LOCK()   taskENTER_CRITICAL(&_lock)
+#define _UNLOCK() taskEXIT_CRITICAL(&_lock)
+#else
+#define _LOCK()   taskENTER_CRITICAL()
+#define _UNLOCK() taskEXIT_CRITICAL()
+#endif
+#endif
+
+#ifdef CONFIG_HUBBLE_SAT_NETWORK_SESSION
+static volatile uint32_t _session_count;
+
+int hubble_sat_session_begin(void)
+{
+	_LOCK();
+	_session_count++;
+	_UNLOCK();
+
+	return 0;
+}
+
+int hubble_sat_session_end(void)
+{
+	int ret = 0;
+
+	_LOCK();
+	if (_session_count == 0U) {
+		ret = -EALREADY;
+	} else {
+		_session_count--;
+	}
+	_UNLOCK();
+
+	if (ret == 0) {
+		/* Wake the transmit task up so it can power the board down */
+		_wake_up();
+	}
+
+	return ret;
+}
+#endif /* CONFIG_HUBBLE_SAT_NETWORK_SESSION */
+
+#ifdef CONFIG_HUBBLE_SAT_NETWORK_PASS_WINDOW
+/* Protected by _LOCK() */
+static struct hubble_sat_pass_target _pass_target;
+static bool _pass_enabled;
+static volatile bool _pass_changed;
+
+void hubble_sat_port_pass_target_set(
+	const struct hubble_sat_pass_target *target)
+{
+	_LOCK();
+	_pass_enabled = (target != NULL);
+	if (target != NULL) {
+		_pass_target = *target;
+	}
+	_pass_changed = true;
+	_UNLOCK();
+
+	/* Wake the transmit task up so it can update the window */
+	_wake_up();
+}
+
+/*
+ * Restricts the transmissions to the next satellite pass. It is only
+ * predicted again when the target changed or when the window closed
+ * with packets still waiting.
+ */
+static void _pass_window_update(uint64_t now_ms)
+{
+	struct hubble_sat_pass_target target;
+	uint64_t utc_ms, open_ms, close_ms;
+	bool changed;
+	bool enabled;
+	int ret;
+
+	_LOCK();
+	changed = _pass_changed;
+	_pass_changed = false;
+	_UNLOCK();
+
+	if (!changed &&
+	    ((_transmit_sched.count == 0U) ||
+	     !hubble_sat_scheduler_window_over(&_transmit_sched, now_ms))) {
+		return;
+	}
+
+	_LOCK();
+	enabled = _pass_enabled;
+	target = _pass_target;
+	_UNLOCK();
+
+	if (!enabled) {
+		hubble_sat_scheduler_window_clear(&_transmit_sched);
+		return;
+	}
+
+	utc_ms = hubble_internal_utc_time_get();
+	ret = hubble_sat_pass_window_next(
+		&target, utc_ms, hubble_internal_utc_time_last_synced_get(),
+		&open_ms, &close_ms);
+	if (ret != 0) {
+		HUBBLE_LOG_WARNING("No satellite pass predicted, transmitting "
+				   "regardless of the passes");
+		hubble_sat_scheduler_window_clear(&_transmit_sched);
+		return;
+	}
+
+	/* From UTC to uptime */
+	hubble_sat_scheduler_window_set(
+		&_transmit_sched,
+		now_ms + (open_ms - HUBBLE_MIN(open_ms, utc_ms)),
+		now_ms + (close_ms - utc_ms));
+}
+#endif /* CONFIG_HUBBLE_SAT_NETWORK_PASS_WINDOW */
+
+static void _board_disable(void)
+{
+	_board_enabled = false;
+
+	if (hubble_sat_board_disable() != 0) {
+		HUBBLE_LOG_WARNING("Hubble Satellite board disable failed");
+	}
+}
+
+static int _transmit(const struct hubble_sat_packet *packet)
+{
+	int ret;
+
+	if (!_board_enabled) {
+		ret = hubble_sat_board_enable();
+		if (ret != 0) {
+			return ret;
+		}
+		_board_enabled = true;
+	}
+
+	ret = hubble_sat_board_packet_send(packet);
+	_board_last_ms = _now_ms();
+
+	if (ret != 0) {
+		_board_disable();
+	}
+
+	return ret;
+}
+
+/*
+ * Called when no transmission is due, @p wait_ms away from the next one.
+ * Within a session the board stays powered as long as the idle time does
+ * not exceed CONFIG_HUBBLE_SAT_NETWORK_SESSION_IDLE_MS, it is powered down
+ * right away otherwise. Returns how long to wait before the next check.
+ */
+static uint64_t _board_idle(uint64_t now_ms, uint64_t wait_ms)
+{
+#ifdef CONFIG_HUBBLE_SAT_NETWORK_SESSION
+	uint64_t off_ms =
+		_board_last_ms + CONFIG_HUBBLE_SAT_NETWORK_SESSION_IDLE_MS;
+
+	if ((_session_count > 0U) && (now_ms < off_ms)) {
+		if (wait_ms == HUBBLE_SAT_SCHEDULER_WAIT_FOREVER) {
+			return off_ms - now_ms;
+		}
+
+		if (wait_ms <= (off_ms - now_ms)) {
+			return wait_ms;
+		}
+	}
+#else
+	(void)now_ms;
+#endif
+
+	_board_disable();
+
+	return wait_ms;
+}
+
+#ifdef CONFIG_HUBBLE_SAT_NETWORK_PRIORITY
+/*
+ * Moves the packets pushed into the ring to the pool, unless they supersede
+ * one not transmitted yet by the scheduler, then the most important ones
+ * from the pool to the scheduler while it has room.
+ */
+static void _queue_admit(uint64_t now_ms)
+{
+	struct hubble_sat_queue_item item;
+	uint64_t deadline_ms;
+	uint8_t extra;
+	int ret;
+
+	while (hubble_sat_queue_get(&_queue, &item)) {
+		/* Not known when the packet was pushed (possibly by an ISR) */
+		extra = hubble_internal_sat_additional_retries_get(
+			item.interval_s);
+		item.retries = HUBBLE_MIN(UINT8_MAX, item.retries + extra);
+
+		/* Same key as a packet held in the scheduler, e.g. until a
+		 * pass window opens
+		 */
+		ret = hubble_sat_scheduler_replace(
+			&_transmit_sched, &item.packet, item.retries,
+			item.interval_s, item.priority, item.key,
+			hubble_sat_queue_deadline_get(&item, now_ms), item.cb,
+			item.user_data, now_ms);
+		if (ret != 0) {
+			hubble_sat_queue_insert(&_queue, &item, now_ms);
+		}
+	}
+
+	while (!hubble_sat_scheduler_full(&_transmit_sched) &&
+	       hubble_sat_queue_pop(&_queue, now_ms, &item, &deadline_ms)) {
+		ret = hubble_sat_scheduler_add_priority(
+			&_transmit_sched, &item.packet, item.retries,
+			item.interval_s, item.priority, item.key, deadline_ms,
+			item.cb, item.user_data, now_ms);
+		if ((ret != 0) && (item.cb != NULL)) {
+			item.cb(ret, item.user_data);
+		}
+	}
+}
+
+/* Packets sent without options wait with the lowest priority */
+static void _request_add(const struct _transmit_request *request,
+			 uint64_t now_ms)
+{
+	struct hubble_sat_queue_item item = {
+		.packet = request->packet,
+		.cb = request->cb,
+		.user_data = request->user_data,
+		.retries = request->retries,
+		.interval_s = request->interval_s,
+	};
+
+	hubble_sat_queue_insert(&_queue, &item, now_ms);
+}
+
+/* No request can be taken from the queue */
+static inline bool _transmit_full(void)
+{
+	return hubble_sat_queue_full(&_queue);
+}
+#else
+static void _request_add(const struct _transmit_request *request,
+			 uint64_t now_ms)
+{
+	int ret;
+
+	ret = hubble_sat_scheduler_add(&_transmit_sched, &request->packet,
+				       request->retries, request->interval_s,
+				       request->cb, request->user_data, now_ms);
+	if ((ret != 0) && (request->cb != NULL)) {
+		request->cb(ret, request->user_data);
+	}
+}
+
+static inline bool _transmit_full(void)
+{
+	return hubble_sat_scheduler_full(&_transmit_sched);
+}
+#endif /* CONFIG_HUBBLE_SAT_NETWORK_PRIORITY */
+
+/*
+ * Takes the requests of the queue while there is room for them, the
+ * others stay there until transmissions are over.
+ */
+static void _requests_take(uint64_t now_ms)
+{
+	struct _transmit_request request;
+
+	for (;;) {
+#ifdef CONFIG_HUBBLE_SAT_NETWORK_PRIORITY
+		_queue_admit(now_ms);
+#endif
+		if (_transmit_full() ||
+		    (xQueueReceive(_transmit_queue, &request, 0) != pdTRUE)) {
+			return;
+		}
+
+		_request_add(&request, now_ms);
+	}
+}
+
+static void _transmit_task(void *arg)
+{
+	struct hubble_sat_scheduler_entry *entry;
+	uint64_t now_ms;
+	uint64_t wait_ms;
+	int ret;
+
+	(void)arg;
+
+	for (;;) {
+		now_ms = _now_ms();
+		_requests_take(now_ms);
+#ifdef CONFIG_HUBBLE_SAT_NETWORK_PASS_WINDOW
+		_pass_window_update(now_ms);
+#endif
+		entry = hubble_sat_scheduler_next(&_transmit_sched, now_ms,
+						  &wait_ms);
+		if (entry != NULL) {
+			ret = _transmit(&entry->packet);
+			if (ret != 0) {
+				HUBBLE_LOG_WARNING("Hubble Satellite packet "
+						   "transmission failed");
+			}
+
+			hubble_sat_scheduler_done(&_transmit_sched, entry, ret,
+						  _now_ms(),
+						  _time_offset_get_ms());
+			continue;
+		}
+
+		if (_board_enabled) {
+			wait_ms = _board_idle(now_ms, wait_ms);
+		}
+
+		/* Nothing due, wait for new packets or events meanwhile */
+		(void)ulTaskNotifyTake(pdTRUE, _ticks_get(wait_ms));
+	}
+}
+
+static int _transmit_task_init(void)
+{
+	/* hubble_init() can be called again, keep the running task */
+	if (_transmit_queue != NULL) {
+		return 0;
+	}
+
+	hubble_sat_scheduler_init(&_transmit_sched, _transmit_entries,
+				  HUBBLE_ARRAY_SIZE(_transmit_entries));
+
+	_transmit_queue =
+		xQueueCreate(CONFIG_HUBBLE_SAT_NETWORK_ASYNC_QUEUE_SIZE,
+			     sizeof(struct _transmit_request));
+	if (_transmit_queue == NULL) {
+		return -ENOMEM;
+	}
+
+	if (xTaskCreate(_transmit_task, "hubble_sat_tx",
+			CONFIG_HUBBLE_SAT_NETWORK_ASYNC_STACK_SIZE, NULL,
+			CONFIG_HUBBLE_SAT_NETWORK_ASYNC_THREAD_PRIORITY,
+			&_transmit_task_handle) != pdPASS) {
+		vQueueDelete(_transmit_queue);
+		_transmit_queue = NULL;
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+#endif /* CONFIG_HUBBLE_SAT_NETWORK_ASYNC */
 
 int hubble_sat_port_init(void)
 {
+#ifdef CONFIG_HUBBLE_SAT_NETWORK_ASYNC
+	int ret;
+
+	ret = hubble_sat_board_init();
+	if (ret != 0) {
+		return ret;
+	}
+
+	return _transmit_task_init();
+#else
 	_transmit_sem = xSemaphoreCreateBinary();
 	if (_transmit_sem == NULL) {
 		return -ENOMEM;
@@ -93,4 +665,5 @@ int hubble_sat_port_init(void)
 	}
 
 	return hubble_sat_board_init();
+#endif
 }
@@ -28,6 +28,11 @@ HUBBLENETWORK_SDK_FLAGS = \
 	-I$(HUBBLENETWORK_SDK_SRC_DIR) \
 	-imacros $(HUBBLENETWORK_SDK_PORT_DIR)/config.h
 
+ifeq ($(CONFIG_HUBBLE_NETWORK_CRYPTO_SOFTWARE),1)
+HUBBLENETWORK_SDK_SOURCES += \
+	$(HUBBLENETWORK_SDK_SRC_DIR)/crypto/software.c
+endif
+
 ifeq ($(CONFIG_HUBBLE_BLE_NETWORK),1)
 HUBBLENETWORK_SDK_SOURCES += \
 	$(HUBBLENETWORK_SDK_SRC_DIR)/hubble_ble.c
@@ -47,4 +52,20 @@ else ifeq ($(CONFIG_HUBBLE_SAT_NETWORK_PROTOCOL_DEPRECATED),1)
 HUBBLENETWORK_SDK_SOURCES += $(HUBBLENETWORK_SDK_SRC_DIR)/hubble_sat_packet_deprecated.c
 endif
 
+ifeq ($(CONFIG_HUBBLE_SAT_NETWORK_ASYNC),1)
+HUBBLENETWORK_SDK_SOURCES += $(HUBBLENETWORK_SDK_SRC_DIR)/hubble_sat_scheduler.c
+endif
+
+ifeq ($(CONFIG_HUBBLE_SAT_NETWORK_PASS_WINDOW),1)
+HUBBLENETWORK_SDK_SOURCES += $(HUBBLENETWORK_SDK_SRC_DIR)/hubble_sat_pass.c
+endif
+
+ifeq ($(CONFIG_HUBBLE_SAT_NETWORK_PRIORITY),1)
+HUBBLENETWORK_SDK_SOURCES += $(HUBBLENETWORK_SDK_SRC_DIR)/hubble_sat_queue.c
+endif
+
+ifeq ($(CONFIG_HUBBLE_SAT_NETWORK_DECODER),1)
+HUBBLENETWORK_SDK_SOURCES += $(HUBBLENETWORK_SDK_SRC_DIR)/reed_solomon_decoder.c
+endif
+
 endif
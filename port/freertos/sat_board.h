@@ -13,6 +13,8 @@
 #ifndef PORT_FREERTOS_SAT_BOARD_H
 #define PORT_FREERTOS_SAT_BOARD_H
 
+#include <stdbool.h>
+
 #include <hubble/sat/packet.h>
 
 #ifdef __cplusplus
@@ -78,6 +80,19 @@ int hubble_sat_board_disable(void);
  */
 int hubble_sat_board_packet_send(const struct hubble_sat_packet *packet);
 
+/**
+ * @brief Tells whether the caller runs in an interrupt handler.
+ *
+ * Used by hubble_sat_packet_enqueue() to wake the transmit task up with
+ * the right FreeRTOS call. FreeRTOS has no portable way to know it, a
+ * default implementation using xPortInIsrContext() is only provided on
+ * ESP-IDF. Other boards enabling CONFIG_HUBBLE_SAT_NETWORK_PRIORITY must
+ * implement it, e.g. with xPortIsInsideInterrupt() on Cortex-M.
+ *
+ * @return true if called from an interrupt handler, false otherwise.
+ */
+bool hubble_sat_board_in_isr(void);
+
 #ifdef __cplusplus
 }
 #endif
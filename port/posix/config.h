@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2026 Hubble Network, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef INCLUDE_PORT_POSIX_CONFIG_H
+#define INCLUDE_PORT_POSIX_CONFIG_H
+
+/*
+ * Enable the Hubble BLE network module. It is used on the host to build
+ * advertisements, e.g. in simulators.
+ */
+#define CONFIG_HUBBLE_BLE_NETWORK 1
+
+/*
+ * Size of the encryption key in bytes. Valid options are
+ * 16 for 128 bits keys or 32 for 256 bits keys.
+ */
+#define CONFIG_HUBBLE_KEY_SIZE    32
+
+/*
+ * Frequency to change the counter timer.
+ */
+#define CONFIG_HUBBLE_NETWORK_TIMER_COUNTER_DAILY
+
+/*
+ * Cache the keys and device ID derived from the master key while
+ * the time counter does not change. Comment it out to derive them on
+ * every advertisement / packet instead.
+ */
+#define CONFIG_HUBBLE_NETWORK_KEY_CACHE 1
+
+/*
+ * Built-in constant-time software AES as crypto provider, using the
+ * AES instructions of the host when available.
+ */
+#define CONFIG_HUBBLE_NETWORK_CRYPTO_SOFTWARE 1
+#define CONFIG_HUBBLE_NETWORK_CRYPTO_SOFTWARE_HOST_ACCEL 1
+#define CONFIG_HUBBLE_NETWORK_CRYPTO_CTR_CMAC 1
+#define CONFIG_HUBBLE_NETWORK_CRYPTO_CMAC_MULTI 1
+
+#ifdef CONFIG_HUBBLE_BLE_NETWORK
+
+/*
+ * Advertisement decoder (see hubble_ble_decode()) and the number of
+ * (key, day) and (key, day, sequence number) entries it remembers.
+ */
+#define CONFIG_HUBBLE_BLE_NETWORK_DECODER 1
+#define CONFIG_HUBBLE_BLE_NETWORK_DECODER_DAY_SLOTS 64
+#define CONFIG_HUBBLE_BLE_NETWORK_DECODER_SEQ_SLOTS 256
+
+#endif /* CONFIG_HUBBLE_BLE_NETWORK */
+
+/*
+ * Satellite packet decoder (see hubble_sat_packet_frame_get()), for
+ * loopback tests and ground station simulators. It only needs the
+ * packet format, not the satellite transmission support.
+ */
+#define CONFIG_HUBBLE_SAT_NETWORK_PROTOCOL_V1 1
+#define CONFIG_HUBBLE_SAT_NETWORK_DECODER 1
+
+/*
+ * Index resolving the ephemeral device IDs of a fleet of keys
+ * (see include/hubble/eid_index.h).
+ */
+#define CONFIG_HUBBLE_NETWORK_EID_INDEX 1
+
+/*
+ * Messages logged to stderr: 0 none, 1 errors, 2 warnings, 3 info,
+ * 4 debug.
+ */
+#define CONFIG_HUBBLE_LOG_LEVEL 2
+
+#endif /* INCLUDE_PORT_POSIX_CONFIG_H */
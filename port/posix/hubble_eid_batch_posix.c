@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2026 Hubble Network, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <hubble/eid_index.h>
+
+#include "hubble_priv.h"
+
+/* Keys of one time counter derived by a work item */
+#define _BLOCK_KEYS 32U
+
+/* Work items are split in per worker ranges [begin, end) packed in a
+ * single word, so both the owner taking items at the front and thieves
+ * taking half of them at the back only need a compare and swap.
+ */
+#define _RANGE(_begin, _end) (((uint64_t)(_begin) << 32) | (uint32_t)(_end))
+#define _RANGE_BEGIN(_range) ((uint32_t)((_range) >> 32))
+#define _RANGE_END(_range)   ((uint32_t)(_range))
+
+struct _batch;
+
+struct _worker {
+	/* Each range on its own cache line */
+	_Alignas(64) _Atomic uint64_t range;
+	pthread_t thread;
+	struct _batch *batch;
+	unsigned int id;
+};
+
+struct _batch {
+	const uint8_t (*keys)[CONFIG_HUBBLE_KEY_SIZE];
+	uint32_t key_count;
+	uint32_t time_counter;
+	uint32_t blocks_per_day;
+	uint32_t *eids;
+	struct _worker *workers;
+	unsigned int worker_count;
+	atomic_int err;
+};
+
+static bool _range_pop(_Atomic uint64_t *range, uint32_t *item)
+{
+	uint64_t old = atomic_load_explicit(range, memory_order_relaxed);
+	uint32_t begin;
+	uint32_t end;
+
+	do {
+		begin = _RANGE_BEGIN(old);
+		end = _RANGE_END(old);
+		if (begin >= end) {
+			return false;
+		}
+	} while (!atomic_compare_exchange_weak(range, &old,
+					       _RANGE(begin + 1U, end)));
+
+	*item = begin;
+
+	return true;
+}
+
+/* Takes the upper half of the victim range (all of it if one item) */
+static bool _range_steal(_Atomic uint64_t *range, uint32_t *begin_out,
+			 uint32_t *end_out)
+{
+	uint64_t old = atomic_load_explicit(range, memory_order_relaxed);
+	uint32_t begin;
+	uint32_t end;
+	uint32_t mid;
+
+	do {
+		begin = _RANGE_BEGIN(old);
+		end = _RANGE_END(old);
+		if (begin >= end) {
+			return false;
+		}
+		mid = begin + ((end - begin) / 2U);
+	} while (!atomic_compare_exchange_weak(range, &old,
+					       _RANGE(begin, mid)));
+
+	*begin_out = mid;
+	*end_out = end;
+
+	return true;
+}
+
+static int _item_run(struct _batch *batch, uint32_t item)
+{
+	int err;
+	uint32_t day = item / batch->blocks_per_day;
+	uint32_t first = (item % batch->blocks_per_day) * _BLOCK_KEYS;
+	uint32_t last = first + _BLOCK_KEYS;
+	uint32_t *column = &batch->eids[(size_t)day * batch->key_count];
+
+	if (last > batch->key_count) {
+		last = batch->key_count;
+	}
+
+	for (uint32_t k = first; k < last; k++) {
+		err = hubble_internal_key_device_id_get(
+			batch->keys[k], batch->time_counter + day, &column[k]);
+		if (err != 0) {
+			return err;
+		}
+	}
+
+	return 0;
+}
+
+/* Moves half of the work of another worker to this one */
+static bool _work_steal(struct _worker *self)
+{
+	struct _batch *batch = self->batch;
+	uint32_t begin;
+	uint32_t end;
+
+	for (unsigned int i = 1; i < batch->worker_count; i++) {
+		struct _worker *victim =
+			&batch->workers[(self->id + i) % batch->worker_count];
+
+		if (_range_steal(&victim->range, &begin, &end)) {
+			atomic_store(&self->range, _RANGE(begin, end));
+			return true;
+		}
+	}
+
+	/* Work is only ever split, once every range is seen empty the
+	 * remaining items are owned by workers that will run them.
+	 */
+	return false;
+}
+
+static void *_worker_run(void *arg)
+{
+	int err;
+	uint32_t item;
+	struct _worker *self = arg;
+	struct _batch *batch = self->batch;
+
+	do {
+		while (_range_pop(&self->range, &item)) {
+			if (atomic_load_explicit(&batch->err,
+						 memory_order_relaxed) != 0) {
+				return NULL;
+			}
+
+			err = _item_run(batch, item);
+			if (err != 0) {
+				int expected = 0;
+
+				(void)atomic_compare_exchange_strong(
+					&batch->err, &expected, err);
+				return NULL;
+			}
+		}
+	} while (_work_steal(self));
+
+	return NULL;
+}
+
+int hubble_eid_batch_get(const uint8_t (*keys)[CONFIG_HUBBLE_KEY_SIZE],
+			 uint32_t key_count, uint32_t time_counter,
+			 uint32_t days, uint32_t *eids, unsigned int threads)
+{
+	struct _batch batch = {
+		.keys = keys,
+		.key_count = key_count,
+		.time_counter = time_counter,
+		.eids = eids,
+	};
+	uint64_t items;
+
+	if ((keys == NULL) || (eids == NULL) || (key_count == 0U) ||
+	    (days == 0U) ||
+	    (((uint64_t)time_counter + days - 1U) > UINT32_MAX)) {
+		return -EINVAL;
+	}
+
+	batch.blocks_per_day = (key_count + _BLOCK_KEYS - 1U) / _BLOCK_KEYS;
+	items = (uint64_t)batch.blocks_per_day * days;
+	if (items > UINT32_MAX) {
+		return -EINVAL;
+	}
+
+	if (threads == 0U) {
+		long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+		threads = (cpus > 0) ? (unsigned int)cpus : 1U;
+	}
+
+	if (threads > items) {
+		threads = (unsigned int)items;
+	}
+
+	batch.workers = aligned_alloc(_Alignof(struct _worker),
+				      sizeof(struct _worker) * threads);
+	if (batch.workers == NULL) {
+		return -ENOMEM;
+	}
+
+	batch.worker_count = threads;
+	atomic_init(&batch.err, 0);
+
+	for (unsigned int i = 0; i < threads; i++) {
+		struct _worker *worker = &batch.workers[i];
+
+		worker->batch = &batch;
+		worker->id = i;
+		atomic_init(&worker->range,
+			    _RANGE((items * i) / threads,
+				   (items * (i + 1U)) / threads));
+	}
+
+	/* The calling thread is worker 0. Workers that cannot be started
+	 * are not an error, their items get stolen by the others.
+	 */
+	for (unsigned int i = 1; i < threads; i++) {
+		if (pthread_create(&batch.workers[i].thread, NULL, _worker_run,
+				   &batch.workers[i]) != 0) {
+			batch.workers[i].batch = NULL;
+		}
+	}
+
+	(void)_worker_run(&batch.workers[0]);
+
+	for (unsigned int i = 1; i < threads; i++) {
+		if (batch.workers[i].batch != NULL) {
+			(void)pthread_join(batch.workers[i].thread, NULL);
+		}
+	}
+
+	free(batch.workers);
+
+	return atomic_load(&batch.err);
+}
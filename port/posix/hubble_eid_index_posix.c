@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2026 Hubble Network, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <hubble/eid_index.h>
+
+static int _map(int fd, size_t size, bool writable,
+		struct hubble_eid_index **index)
+{
+	int prot = PROT_READ | (writable ? PROT_WRITE : 0);
+	void *addr = mmap(NULL, size, prot, MAP_SHARED, fd, 0);
+
+	if (addr == MAP_FAILED) {
+		return -errno;
+	}
+
+	*index = addr;
+
+	return 0;
+}
+
+int hubble_eid_index_create(const char *path, uint32_t key_count,
+			    uint32_t window, struct hubble_eid_index **index,
+			    size_t *size)
+{
+	int fd;
+	int err;
+	size_t len = hubble_eid_index_size(key_count, window);
+
+	if ((path == NULL) || (index == NULL) || (size == NULL) ||
+	    (len == 0U)) {
+		return -EINVAL;
+	}
+
+	fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		return -errno;
+	}
+
+	if (ftruncate(fd, (off_t)len) != 0) {
+		err = -errno;
+		goto exit;
+	}
+
+	err = _map(fd, len, true, index);
+	if (err != 0) {
+		goto exit;
+	}
+
+	err = hubble_eid_index_init(*index, len, key_count, window);
+	if (err != 0) {
+		(void)munmap(*index, len);
+		goto exit;
+	}
+
+	*size = len;
+
+exit:
+	(void)close(fd);
+	return err;
+}
+
+int hubble_eid_index_open(const char *path, bool writable,
+			  struct hubble_eid_index **index, size_t *size)
+{
+	int fd;
+	int err;
+	struct stat st;
+
+	if ((path == NULL) || (index == NULL) || (size == NULL)) {
+		return -EINVAL;
+	}
+
+	fd = open(path, writable ? O_RDWR : O_RDONLY);
+	if (fd < 0) {
+		return -errno;
+	}
+
+	if (fstat(fd, &st) != 0) {
+		err = -errno;
+		goto exit;
+	}
+
+	if ((st.st_size <= 0) || ((uintmax_t)st.st_size > SIZE_MAX)) {
+		err = -EINVAL;
+		goto exit;
+	}
+
+	err = _map(fd, (size_t)st.st_size, writable, index);
+	if (err != 0) {
+		goto exit;
+	}
+
+	err = hubble_eid_index_check(*index, (size_t)st.st_size);
+	if (err != 0) {
+		(void)munmap(*index, (size_t)st.st_size);
+		goto exit;
+	}
+
+	*size = (size_t)st.st_size;
+
+exit:
+	(void)close(fd);
+	return err;
+}
+
+int hubble_eid_index_close(struct hubble_eid_index *index, size_t size)
+{
+	int err = 0;
+
+	if (index == NULL) {
+		return -EINVAL;
+	}
+
+	if (msync(index, size, MS_SYNC) != 0) {
+		err = -errno;
+	}
+
+	if (munmap(index, size) != 0) {
+		err = -errno;
+	}
+
+	return err;
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2026 Hubble Network, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <hubble/port/sys.h>
+
+#include "utils/macros.h"
+
+/* getentropy() does not return more than that per call */
+#define _ENTROPY_MAX_LEN 256U
+
+HUBBLE_WEAK uint64_t hubble_uptime_get(void)
+{
+	struct timespec ts;
+
+	(void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ((uint64_t)ts.tv_sec * 1000U) +
+	       ((uint64_t)ts.tv_nsec / 1000000U);
+}
+
+HUBBLE_WEAK int hubble_rand_get(uint8_t *buffer, size_t len)
+{
+	size_t to_copy;
+
+	while (len > 0) {
+		to_copy = HUBBLE_MIN(len, _ENTROPY_MAX_LEN);
+		if (getentropy(buffer, to_copy) != 0) {
+			return -errno;
+		}
+		buffer += to_copy;
+		len -= to_copy;
+	}
+
+	return 0;
+}
+
+HUBBLE_WEAK int hubble_log(enum hubble_log_level level, const char *format,
+			   ...)
+{
+	va_list args;
+	/* Same numbering as the Zephyr log levels */
+	static const uint8_t level_values[HUBBLE_LOG_COUNT] = {
+		[HUBBLE_LOG_DEBUG] = 4,
+		[HUBBLE_LOG_INFO] = 3,
+		[HUBBLE_LOG_WARNING] = 2,
+		[HUBBLE_LOG_ERROR] = 1,
+	};
+	static const char *const level_names[HUBBLE_LOG_COUNT] = {
+		[HUBBLE_LOG_DEBUG] = "dbg",
+		[HUBBLE_LOG_INFO] = "inf",
+		[HUBBLE_LOG_WARNING] = "wrn",
+		[HUBBLE_LOG_ERROR] = "err",
+	};
+
+	if ((level >= HUBBLE_LOG_COUNT) ||
+	    (level_values[level] > CONFIG_HUBBLE_LOG_LEVEL)) {
+		return 0;
+	}
+
+	va_start(args, format);
+	(void)fprintf(stderr, "<%s> hubblenetwork: ", level_names[level]);
+	(void)vfprintf(stderr, format, args);
+	(void)fputc('\n', stderr);
+	va_end(args);
+
+	return 0;
+}
@@ -0,0 +1,63 @@
+# Copyright (c) 2026 Hubble Network, Inc.
+#
+# SPDX-License-Identifier: Apache-2.0
+
+
+THIS_DIR := $(dir $(abspath $(lastword $(MAKEFILE_LIST))))
+
+# Define base sources
+HUBBLENETWORK_SDK_PORT_DIR := $(THIS_DIR)
+HUBBLENETWORK_SDK_SRC_DIR := $(THIS_DIR)/../../src
+HUBBLENETWORK_SDK_INCLUDE_DIR := $(THIS_DIR)/../../include
+
+# Extract config variables from config.h
+CONFIG_VARS := $(shell sed -nE \
+	-e 's/^[[:space:]]*\#define[[:space:]]+(CONFIG_HUBBLE_[A-Z0-9_]*)[[:space:]]+(.*)$$/\1=\2/p' \
+	-e 's/^[[:space:]]*\#define[[:space:]]+(CONFIG_HUBBLE_[A-Z0-9_]*)[[:space:]]*$$/\1=1/p' \
+	$(HUBBLENETWORK_SDK_PORT_DIR)/config.h)
+
+$(foreach v,$(CONFIG_VARS),$(eval $(v)))
+
+HUBBLENETWORK_SDK_SOURCES = \
+	$(HUBBLENETWORK_SDK_PORT_DIR)/hubble_posix.c \
+	$(HUBBLENETWORK_SDK_SRC_DIR)/hubble.c \
+	$(HUBBLENETWORK_SDK_SRC_DIR)/hubble_crypto.c
+
+HUBBLENETWORK_SDK_FLAGS = \
+	-I$(HUBBLENETWORK_SDK_INCLUDE_DIR) \
+	-I$(HUBBLENETWORK_SDK_SRC_DIR) \
+	-imacros $(HUBBLENETWORK_SDK_PORT_DIR)/config.h
+
+# To be added to the link flags of the application
+HUBBLENETWORK_SDK_LDFLAGS = \
+	-pthread
+
+ifeq ($(CONFIG_HUBBLE_NETWORK_CRYPTO_SOFTWARE),1)
+HUBBLENETWORK_SDK_SOURCES += \
+	$(HUBBLENETWORK_SDK_SRC_DIR)/crypto/software.c
+endif
+
+ifeq ($(CONFIG_HUBBLE_NETWORK_CRYPTO_SOFTWARE_HOST_ACCEL),1)
+HUBBLENETWORK_SDK_SOURCES += \
+	$(HUBBLENETWORK_SDK_SRC_DIR)/crypto/aes_accel.c
+endif
+
+ifeq ($(CONFIG_HUBBLE_BLE_NETWORK),1)
+HUBBLENETWORK_SDK_SOURCES += \
+	$(HUBBLENETWORK_SDK_SRC_DIR)/hubble_ble.c
+endif
+
+ifeq ($(CONFIG_HUBBLE_SAT_NETWORK_DECODER),1)
+HUBBLENETWORK_SDK_SOURCES += \
+	$(HUBBLENETWORK_SDK_SRC_DIR)/hubble_sat_packet.c \
+	$(HUBBLENETWORK_SDK_SRC_DIR)/reed_solomon_encoder.c \
+	$(HUBBLENETWORK_SDK_SRC_DIR)/reed_solomon_decoder.c \
+	$(HUBBLENETWORK_SDK_SRC_DIR)/utils/bitarray.c
+endif
+
+ifeq ($(CONFIG_HUBBLE_NETWORK_EID_INDEX),1)
+HUBBLENETWORK_SDK_SOURCES += \
+	$(HUBBLENETWORK_SDK_SRC_DIR)/hubble_eid_index.c \
+	$(HUBBLENETWORK_SDK_PORT_DIR)/hubble_eid_index_posix.c \
+	$(HUBBLENETWORK_SDK_PORT_DIR)/hubble_eid_batch_posix.c
+endif
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2026 Hubble Network, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <stdint.h>
+
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+
+#include <hubble/ble.h>
+#include <hubble/port/crypto.h>
+#include <hubble/port/sys.h>
+
+K_THREAD_STACK_DEFINE(_precompute_stack,
+		      CONFIG_HUBBLE_BLE_NETWORK_PRECOMPUTE_STACK_SIZE);
+
+static struct k_work_q _precompute_work_q;
+static struct k_work _precompute_work;
+
+/* Last request: sequence number in the upper 16 bits, count in the
+ * lower 8 bits. It is read once by the work handler so a new request
+ * can safely replace a pending one.
+ */
+static atomic_t _precompute_request;
+
+static void _precompute_handler(struct k_work *work)
+{
+	atomic_val_t request = atomic_get(&_precompute_request);
+	int ret;
+
+	ARG_UNUSED(work);
+
+	ret = hubble_ble_advertise_precompute((uint16_t)(request >> 16),
+					      (uint8_t)(request & 0xFF));
+	if (ret != 0) {
+		HUBBLE_LOG_WARNING("Advertisement pre-computation failed");
+	}
+}
+
+int hubble_ble_advertise_precompute_submit(uint16_t seq_no, uint8_t count)
+{
+	if ((seq_no > HUBBLE_MAX_SEQ_COUNTER) || (count == 0U) ||
+	    (count > CONFIG_HUBBLE_BLE_NETWORK_PRECOMPUTE_SLOTS)) {
+		return -EINVAL;
+	}
+
+	atomic_set(&_precompute_request, ((atomic_val_t)seq_no << 16) | count);
+
+	return MIN(k_work_submit_to_queue(&_precompute_work_q,
+					  &_precompute_work),
+		   0);
+}
+
+static int _precompute_init(void)
+{
+	const struct k_work_queue_config cfg = {
+		.name = "hubble_precompute",
+	};
+
+	k_work_init(&_precompute_work, _precompute_handler);
+	k_work_queue_init(&_precompute_work_q);
+	k_work_queue_start(&_precompute_work_q, _precompute_stack,
+			   K_THREAD_STACK_SIZEOF(_precompute_stack),
+			   K_LOWEST_APPLICATION_THREAD_PRIO, &cfg);
+
+	return 0;
+}
+
+SYS_INIT(_precompute_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
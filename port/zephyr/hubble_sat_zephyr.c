@@ -5,18 +5,26 @@
  */
 
 #include <errno.h>
+#include <stdbool.h>
 #include <stddef.h>
 
 #include <zephyr/kernel.h>
 #include <zephyr/random/random.h>
+#include <zephyr/sys/atomic.h>
 
 #include <hubble/sat.h>
 #include <hubble/port/sat_radio.h>
 #include <hubble/port/sys.h>
 
+#include "hubble_priv.h"
+#include "hubble_sat_pass.h"
+#include "hubble_sat_queue.h"
+#include "hubble_sat_scheduler.h"
 #include "sat_board.h"
 
+#ifndef CONFIG_HUBBLE_SAT_NETWORK_ASYNC
 K_SEM_DEFINE(_trans_sem, 1, 1);
+#endif
 
 static inline int16_t _time_offset_get_ms(void)
 {
@@ -31,6 +39,7 @@ static inline int16_t _time_offset_get_ms(void)
 	return offset_values[rand_value / 52];
 }
 
+#ifndef CONFIG_HUBBLE_SAT_NETWORK_ASYNC
 int hubble_sat_port_packet_send(const struct hubble_sat_packet *packet,
 				uint8_t retries, uint8_t interval_s)
 {
@@ -71,6 +80,461 @@ enable_error:
 
 	return ret;
 }
+#else /* CONFIG_HUBBLE_SAT_NETWORK_ASYNC */
+struct _transmit_request {
+	struct hubble_sat_packet packet;
+	hubble_sat_packet_sent_cb_t cb;
+	void *user_data;
+	uint8_t retries;
+	uint8_t interval_s;
+};
+
+struct _sync_request {
+	struct k_sem sem;
+	int ret;
+};
+
+K_MSGQ_DEFINE(_transmit_msgq, sizeof(struct _transmit_request),
+	      CONFIG_HUBBLE_SAT_NETWORK_ASYNC_QUEUE_SIZE, sizeof(void *));
+
+/* Given when the transmit thread has something new to look at. Wake-ups
+ * do not take room in the message queue, so they cannot fill it.
+ */
+K_SEM_DEFINE(_wake_sem, 0, 1);
+
+/* Packets in flight, only touched by the transmit thread */
+static struct hubble_sat_scheduler_entry
+	_transmit_entries[CONFIG_HUBBLE_SAT_NETWORK_ASYNC_QUEUE_SIZE];
+static struct hubble_sat_scheduler _transmit_sched;
+
+static int _request_put(const struct hubble_sat_packet *packet,
+			uint8_t retries, uint8_t interval_s,
+			hubble_sat_packet_sent_cb_t cb, void *user_data,
+			k_timeout_t timeout)
+{
+	struct _transmit_request request = {
+		.packet = *packet,
+		.cb = cb,
+		.user_data = user_data,
+		.retries = retries,
+		.interval_s = interval_s,
+	};
+
+	if (k_msgq_put(&_transmit_msgq, &request, timeout) != 0) {
+		return -EAGAIN;
+	}
+
+	k_sem_give(&_wake_sem);
+
+	return 0;
+}
+
+static void _sync_sent_cb(int status, void *user_data)
+{
+	struct _sync_request *sync = user_data;
+
+	sync->ret = status;
+	k_sem_give(&sync->sem);
+}
+
+int hubble_sat_port_packet_send(const struct hubble_sat_packet *packet,
+				uint8_t retries, uint8_t interval_s)
+{
+	struct _sync_request sync;
+	int ret;
+
+	/* Goes through the transmit thread as well, so its retries are
+	 * interleaved with the ones of the queued packets.
+	 */
+	k_sem_init(&sync.sem, 0, 1);
+
+	ret = _request_put(packet, retries, interval_s, _sync_sent_cb, &sync,
+			   K_FOREVER);
+	if (ret != 0) {
+		return ret;
+	}
+
+	(void)k_sem_take(&sync.sem, K_FOREVER);
+
+	return sync.ret;
+}
+
+int hubble_sat_port_packet_send_async(const struct hubble_sat_packet *packet,
+				      uint8_t retries, uint8_t interval_s,
+				      hubble_sat_packet_sent_cb_t cb,
+				      void *user_data)
+{
+	return _request_put(packet, retries, interval_s, cb, user_data,
+			    K_NO_WAIT);
+}
+
+#ifdef CONFIG_HUBBLE_SAT_NETWORK_PRIORITY
+/* Packets waiting for the scheduler, the ring is filled by
+ * hubble_sat_port_packet_enqueue() and drained by the transmit thread.
+ */
+static struct hubble_sat_queue_item
+	_queue_ring[CONFIG_HUBBLE_SAT_NETWORK_PRIORITY_QUEUE_SIZE + 1];
+static struct hubble_sat_queue_entry
+	_queue_pool[CONFIG_HUBBLE_SAT_NETWORK_PRIORITY_QUEUE_SIZE];
+static struct hubble_sat_queue _queue =
+	HUBBLE_SAT_QUEUE_INITIALIZER(_queue_ring, _queue_pool);
+
+int hubble_sat_port_packet_enqueue(
+	const struct hubble_sat_packet *packet, uint8_t retries,
+	uint8_t interval_s, const struct hubble_sat_packet_options *options,
+	hubble_sat_packet_sent_cb_t cb, void *user_data)
+{
+	struct hubble_sat_queue_item item = {
+		.packet = *packet,
+		.cb = cb,
+		.user_data = user_data,
+		.lifetime_ms = options->lifetime_ms,
+		.key = options->key,
+		.priority = options->priority,
+		.retries = retries,
+		.interval_s = interval_s,
+	};
+	int ret;
+
+	ret = hubble_sat_queue_push(&_queue, &item);
+	if (ret != 0) {
+		return ret;
+	}
+
+	/* Wake the transmit thread up, the ring is drained whenever it runs */
+	k_sem_give(&_wake_sem);
+
+	return 0;
+}
+
+/*
+ * Moves the packets pushed into the ring to the pool, unless they supersede
+ * one not transmitted yet by the scheduler, then the most important ones
+ * from the pool to the scheduler while it has room.
+ */
+static void _queue_admit(uint64_t now_ms)
+{
+	struct hubble_sat_queue_item item;
+	uint64_t deadline_ms;
+	uint8_t extra;
+	int ret;
+
+	while (hubble_sat_queue_get(&_queue, &item)) {
+		/* Not known when the packet was pushed (possibly by an ISR) */
+		extra = hubble_internal_sat_additional_retries_get(
+			item.interval_s);
+		item.retries = MIN(UINT8_MAX, item.retries + extra);
+
+		/* Same key as a packet held in the scheduler, e.g. until a
+		 * pass window opens
+		 */
+		ret = hubble_sat_scheduler_replace(
+			&_transmit_sched, &item.packet, item.retries,
+			item.interval_s, item.priority, item.key,
+			hubble_sat_queue_deadline_get(&item, now_ms), item.cb,
+			item.user_data, now_ms);
+		if (ret != 0) {
+			hubble_sat_queue_insert(&_queue, &item, now_ms);
+		}
+	}
+
+	while (!hubble_sat_scheduler_full(&_transmit_sched) &&
+	       hubble_sat_queue_pop(&_queue, now_ms, &item, &deadline_ms)) {
+		ret = hubble_sat_scheduler_add_priority(
+			&_transmit_sched, &item.packet, item.retries,
+			item.interval_s, item.priority, item.key, deadline_ms,
+			item.cb, item.user_data, now_ms);
+		if ((ret != 0) && (item.cb != NULL)) {
+			item.cb(ret, item.user_data);
+		}
+	}
+}
+
+/* Packets sent without options wait with the lowest priority */
+static void _request_add(const struct _transmit_request *request,
+			 uint64_t now_ms)
+{
+	struct hubble_sat_queue_item item = {
+		.packet = request->packet,
+		.cb = request->cb,
+		.user_data = request->user_data,
+		.retries = request->retries,
+		.interval_s = request->interval_s,
+	};
+
+	hubble_sat_queue_insert(&_queue, &item, now_ms);
+}
+
+/* No request can be taken from the message queue */
+static inline bool _transmit_full(void)
+{
+	return hubble_sat_queue_full(&_queue);
+}
+#else
+static void _request_add(const struct _transmit_request *request,
+			 uint64_t now_ms)
+{
+	int ret;
+
+	ret = hubble_sat_scheduler_add(&_transmit_sched, &request->packet,
+				       request->retries, request->interval_s,
+				       request->cb, request->user_data, now_ms);
+	if ((ret != 0) && (request->cb != NULL)) {
+		request->cb(ret, request->user_data);
+	}
+}
+
+static inline bool _transmit_full(void)
+{
+	return hubble_sat_scheduler_full(&_transmit_sched);
+}
+#endif /* CONFIG_HUBBLE_SAT_NETWORK_PRIORITY */
+
+/* Board power, only touched by the transmit thread */
+static bool _board_enabled;
+static uint64_t _board_last_ms;
+
+#ifdef CONFIG_HUBBLE_SAT_NETWORK_SESSION
+static atomic_t _session_count;
+
+int hubble_sat_session_begin(void)
+{
+	(void)atomic_inc(&_session_count);
+
+	return 0;
+}
+
+int hubble_sat_session_end(void)
+{
+	atomic_val_t count;
+
+	do {
+		count = atomic_get(&_session_count);
+		if (count == 0) {
+			return -EALREADY;
+		}
+	} while (!atomic_cas(&_session_count, count, count - 1));
+
+	/* Wake the transmit thread up so it can power the board down */
+	k_sem_give(&_wake_sem);
+
+	return 0;
+}
+
+static inline bool _session_open(void)
+{
+	return atomic_get(&_session_count) > 0;
+}
+#else
+static inline bool _session_open(void)
+{
+	return false;
+}
+#endif /* CONFIG_HUBBLE_SAT_NETWORK_SESSION */
+
+#ifdef CONFIG_HUBBLE_SAT_NETWORK_PASS_WINDOW
+K_MUTEX_DEFINE(_pass_mutex);
+
+/* Protected by _pass_mutex */
+static struct hubble_sat_pass_target _pass_target;
+static bool _pass_enabled;
+
+static atomic_t _pass_changed;
+
+void hubble_sat_port_pass_target_set(
+	const struct hubble_sat_pass_target *target)
+{
+	(void)k_mutex_lock(&_pass_mutex, K_FOREVER);
+	_pass_enabled = (target != NULL);
+	if (target != NULL) {
+		_pass_target = *target;
+	}
+	(void)k_mutex_unlock(&_pass_mutex);
+
+	/* Wake the transmit thread up so it can update the window */
+	(void)atomic_set(&_pass_changed, 1);
+	k_sem_give(&_wake_sem);
+}
+
+/*
+ * Restricts the transmissions to the next satellite pass. It is only
+ * predicted again when the target changed or when the window closed
+ * with packets still waiting.
+ */
+static void _pass_window_update(uint64_t now_ms)
+{
+	struct hubble_sat_pass_target target;
+	uint64_t utc_ms, open_ms, close_ms;
+	bool enabled;
+	int ret;
+
+	if (!atomic_clear(&_pass_changed) &&
+	    ((_transmit_sched.count == 0U) ||
+	     !hubble_sat_scheduler_window_over(&_transmit_sched, now_ms))) {
+		return;
+	}
+
+	(void)k_mutex_lock(&_pass_mutex, K_FOREVER);
+	enabled = _pass_enabled;
+	target = _pass_target;
+	(void)k_mutex_unlock(&_pass_mutex);
+
+	if (!enabled) {
+		hubble_sat_scheduler_window_clear(&_transmit_sched);
+		return;
+	}
+
+	utc_ms = hubble_internal_utc_time_get();
+	ret = hubble_sat_pass_window_next(
+		&target, utc_ms, hubble_internal_utc_time_last_synced_get(),
+		&open_ms, &close_ms);
+	if (ret != 0) {
+		HUBBLE_LOG_WARNING("No satellite pass predicted, transmitting "
+				   "regardless of the passes");
+		hubble_sat_scheduler_window_clear(&_transmit_sched);
+		return;
+	}
+
+	/* From UTC to uptime */
+	hubble_sat_scheduler_window_set(
+		&_transmit_sched, now_ms + (open_ms - MIN(open_ms, utc_ms)),
+		now_ms + (close_ms - utc_ms));
+}
+#endif /* CONFIG_HUBBLE_SAT_NETWORK_PASS_WINDOW */
+
+static void _board_disable(void)
+{
+	_board_enabled = false;
+
+	if (hubble_sat_board_disable() != 0) {
+		HUBBLE_LOG_WARNING("Hubble Satellite board disable failed");
+	}
+}
+
+static int _transmit(const struct hubble_sat_packet *packet)
+{
+	int ret;
+
+	if (!_board_enabled) {
+		ret = hubble_sat_board_enable();
+		if (ret != 0) {
+			return ret;
+		}
+		_board_enabled = true;
+	}
+
+	ret = hubble_sat_board_packet_send(packet);
+	_board_last_ms = k_uptime_get();
+
+	if (ret != 0) {
+		_board_disable();
+	}
+
+	return ret;
+}
+
+/*
+ * Called when no transmission is due, @p wait_ms away from the next one.
+ * Within a session the board stays powered as long as the idle time does
+ * not exceed CONFIG_HUBBLE_SAT_NETWORK_SESSION_IDLE_MS, it is powered down
+ * right away otherwise. Returns how long to wait before the next check.
+ */
+static uint64_t _board_idle(uint64_t now_ms, uint64_t wait_ms)
+{
+#ifdef CONFIG_HUBBLE_SAT_NETWORK_SESSION
+	uint64_t off_ms =
+		_board_last_ms + CONFIG_HUBBLE_SAT_NETWORK_SESSION_IDLE_MS;
+
+	if (_session_open() && (now_ms < off_ms)) {
+		if (wait_ms == HUBBLE_SAT_SCHEDULER_WAIT_FOREVER) {
+			return off_ms - now_ms;
+		}
+
+		if (wait_ms <= (off_ms - now_ms)) {
+			return wait_ms;
+		}
+	}
+#else
+	ARG_UNUSED(now_ms);
+#endif
+
+	_board_disable();
+
+	return wait_ms;
+}
+
+/*
+ * Takes the requests of the message queue while there is room for them,
+ * the others stay there until transmissions are over.
+ */
+static void _requests_take(uint64_t now_ms)
+{
+	struct _transmit_request request;
+
+	for (;;) {
+#ifdef CONFIG_HUBBLE_SAT_NETWORK_PRIORITY
+		_queue_admit(now_ms);
+#endif
+		if (_transmit_full() ||
+		    (k_msgq_get(&_transmit_msgq, &request, K_NO_WAIT) != 0)) {
+			return;
+		}
+
+		_request_add(&request, now_ms);
+	}
+}
+
+static void _transmit_thread(void *p1, void *p2, void *p3)
+{
+	struct hubble_sat_scheduler_entry *entry;
+	uint64_t now_ms;
+	uint64_t wait_ms;
+	int ret;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	hubble_sat_scheduler_init(&_transmit_sched, _transmit_entries,
+				  ARRAY_SIZE(_transmit_entries));
+
+	for (;;) {
+		now_ms = k_uptime_get();
+		_requests_take(now_ms);
+#ifdef CONFIG_HUBBLE_SAT_NETWORK_PASS_WINDOW
+		_pass_window_update(now_ms);
+#endif
+		entry = hubble_sat_scheduler_next(&_transmit_sched, now_ms,
+						  &wait_ms);
+		if (entry != NULL) {
+			ret = _transmit(&entry->packet);
+			if (ret != 0) {
+				HUBBLE_LOG_WARNING("Hubble Satellite packet "
+						   "transmission failed");
+			}
+
+			hubble_sat_scheduler_done(&_transmit_sched, entry, ret,
+						  k_uptime_get(),
+						  _time_offset_get_ms());
+			continue;
+		}
+
+		if (_board_enabled) {
+			wait_ms = _board_idle(now_ms, wait_ms);
+		}
+
+		/* Nothing due, wait for new packets or events meanwhile */
+		(void)k_sem_take(&_wake_sem,
+				 (wait_ms == HUBBLE_SAT_SCHEDULER_WAIT_FOREVER)
+					 ? K_FOREVER
+					 : K_MSEC(wait_ms));
+	}
+}
+
+K_THREAD_DEFINE(_transmit_tid, CONFIG_HUBBLE_SAT_NETWORK_ASYNC_STACK_SIZE,
+		_transmit_thread, NULL, NULL, NULL,
+		CONFIG_HUBBLE_SAT_NETWORK_ASYNC_THREAD_PRIORITY, 0, 0);
+#endif /* CONFIG_HUBBLE_SAT_NETWORK_ASYNC */
 
 int hubble_sat_port_init(void)
 {
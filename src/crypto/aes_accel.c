@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2026 Hubble Network, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* AES block encryption with the AES-NI (x86) or the ARMv8 Cryptography
+ * Extensions (AArch64) instructions, for host builds. The key schedule
+ * is done by the software provider.
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "aes_accel.h"
+
+#define _BLOCK_SIZE 16U
+#define _MAX_ROUNDS 14U
+
+/* Blocks in flight, enough to hide the latency of the AES instructions */
+#define _LANES      4U
+
+/* Result of the detection, shared by the threads deriving keys (e.g.
+ * hubble_eid_batch_get()). Every thread computes the same value, so
+ * racing on the first call is harmless as long as accesses are atomic.
+ */
+#define _UNKNOWN    (-1)
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <emmintrin.h>
+#include <wmmintrin.h>
+
+#define _TARGET __attribute__((target("aes,sse2")))
+
+bool hubble_aes_accel_supported(void)
+{
+	static atomic_int supported = _UNKNOWN;
+	int value = atomic_load_explicit(&supported, memory_order_relaxed);
+
+	if (value == _UNKNOWN) {
+		__builtin_cpu_init();
+		value = __builtin_cpu_supports("aes") ? 1 : 0;
+		atomic_store_explicit(&supported, value, memory_order_relaxed);
+	}
+
+	return value == 1;
+}
+
+/* With the word in every column ShiftRows has no effect, so the last
+ * round with a zero key is SubWord.
+ */
+_TARGET uint32_t hubble_aes_accel_sub_word(uint32_t w)
+{
+	__m128i b = _mm_set1_epi32((int)w);
+
+	b = _mm_aesenclast_si128(b, _mm_setzero_si128());
+
+	return (uint32_t)_mm_cvtsi128_si32(b);
+}
+
+_TARGET void hubble_aes_accel_encrypt(const uint8_t *rk, unsigned int rounds,
+				      const uint8_t *in, uint8_t *out,
+				      size_t blocks)
+{
+	__m128i k[_MAX_ROUNDS + 1U];
+
+	for (unsigned int r = 0; r <= rounds; r++) {
+		k[r] = _mm_loadu_si128(
+			(const __m128i *)(rk + (r * _BLOCK_SIZE)));
+	}
+
+	for (; blocks >= _LANES; blocks -= _LANES) {
+		__m128i b[_LANES];
+
+		for (size_t i = 0; i < _LANES; i++) {
+			const __m128i *p =
+				(const __m128i *)(in + (i * _BLOCK_SIZE));
+
+			b[i] = _mm_xor_si128(_mm_loadu_si128(p), k[0]);
+		}
+
+		for (unsigned int r = 1; r < rounds; r++) {
+			for (size_t i = 0; i < _LANES; i++) {
+				b[i] = _mm_aesenc_si128(b[i], k[r]);
+			}
+		}
+
+		for (size_t i = 0; i < _LANES; i++) {
+			b[i] = _mm_aesenclast_si128(b[i], k[rounds]);
+			_mm_storeu_si128(
+				(__m128i *)(out + (i * _BLOCK_SIZE)), b[i]);
+		}
+
+		in += _LANES * _BLOCK_SIZE;
+		out += _LANES * _BLOCK_SIZE;
+	}
+
+	for (; blocks > 0; blocks--) {
+		__m128i b = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in),
+					  k[0]);
+
+		for (unsigned int r = 1; r < rounds; r++) {
+			b = _mm_aesenc_si128(b, k[r]);
+		}
+
+		_mm_storeu_si128((__m128i *)out,
+				 _mm_aesenclast_si128(b, k[rounds]));
+
+		in += _BLOCK_SIZE;
+		out += _BLOCK_SIZE;
+	}
+}
+
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRYPTO) &&                 \
+	defined(__linux__)
+
+#include <arm_neon.h>
+#include <sys/auxv.h>
+
+#ifndef HWCAP_AES
+#define HWCAP_AES (1 << 3)
+#endif
+
+bool hubble_aes_accel_supported(void)
+{
+	static atomic_int supported = _UNKNOWN;
+	int value = atomic_load_explicit(&supported, memory_order_relaxed);
+
+	if (value == _UNKNOWN) {
+		value = ((getauxval(AT_HWCAP) & HWCAP_AES) != 0) ? 1 : 0;
+		atomic_store_explicit(&supported, value, memory_order_relaxed);
+	}
+
+	return value == 1;
+}
+
+/* With the word in every column ShiftRows has no effect, so AESE with
+ * a zero key is SubWord.
+ */
+uint32_t hubble_aes_accel_sub_word(uint32_t w)
+{
+	uint8x16_t b = vreinterpretq_u8_u32(vdupq_n_u32(w));
+
+	b = vaeseq_u8(b, vdupq_n_u8(0));
+
+	return vgetq_lane_u32(vreinterpretq_u32_u8(b), 0);
+}
+
+void hubble_aes_accel_encrypt(const uint8_t *rk, unsigned int rounds,
+			      const uint8_t *in, uint8_t *out, size_t blocks)
+{
+	uint8x16_t k[_MAX_ROUNDS + 1U];
+
+	for (unsigned int r = 0; r <= rounds; r++) {
+		k[r] = vld1q_u8(rk + (r * _BLOCK_SIZE));
+	}
+
+	for (; blocks >= _LANES; blocks -= _LANES) {
+		uint8x16_t b[_LANES];
+
+		for (size_t i = 0; i < _LANES; i++) {
+			b[i] = vld1q_u8(in + (i * _BLOCK_SIZE));
+		}
+
+		/* AESE does AddRoundKey + SubBytes + ShiftRows */
+		for (unsigned int r = 0; r < rounds - 1U; r++) {
+			for (size_t i = 0; i < _LANES; i++) {
+				b[i] = vaesmcq_u8(vaeseq_u8(b[i], k[r]));
+			}
+		}
+
+		for (size_t i = 0; i < _LANES; i++) {
+			b[i] = veorq_u8(vaeseq_u8(b[i], k[rounds - 1U]),
+					k[rounds]);
+			vst1q_u8(out + (i * _BLOCK_SIZE), b[i]);
+		}
+
+		in += _LANES * _BLOCK_SIZE;
+		out += _LANES * _BLOCK_SIZE;
+	}
+
+	for (; blocks > 0; blocks--) {
+		uint8x16_t b = vld1q_u8(in);
+
+		for (unsigned int r = 0; r < rounds - 1U; r++) {
+			b = vaesmcq_u8(vaeseq_u8(b, k[r]));
+		}
+
+		vst1q_u8(out,
+			 veorq_u8(vaeseq_u8(b, k[rounds - 1U]), k[rounds]));
+
+		in += _BLOCK_SIZE;
+		out += _BLOCK_SIZE;
+	}
+}
+
+#else
+
+/* No AES instructions known for this target, the software AES is used */
+bool hubble_aes_accel_supported(void)
+{
+	return false;
+}
+
+uint32_t hubble_aes_accel_sub_word(uint32_t w)
+{
+	return w;
+}
+
+void hubble_aes_accel_encrypt(const uint8_t *rk, unsigned int rounds,
+			      const uint8_t *in, uint8_t *out, size_t blocks)
+{
+	(void)rk;
+	(void)rounds;
+	(void)in;
+	(void)out;
+	(void)blocks;
+}
+
+#endif
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2026 Hubble Network, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SRC_CRYPTO_AES_ACCEL_H
+#define SRC_CRYPTO_AES_ACCEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Check whether the CPU running the code has AES instructions.
+ *
+ * Detected at runtime (CPUID on x86, HWCAP on Linux AArch64), the
+ * result is computed once. It can be called from several threads.
+ *
+ * @return true if hubble_aes_accel_encrypt() can be used.
+ */
+bool hubble_aes_accel_supported(void);
+
+/**
+ * @brief AES SubWord of a key schedule word with the CPU AES instructions.
+ *
+ * @param w Key schedule word.
+ *
+ * @return The S-box applied to each byte of @p w.
+ */
+uint32_t hubble_aes_accel_sub_word(uint32_t w);
+
+/**
+ * @brief Encrypt independent AES blocks with the CPU AES instructions.
+ *
+ * Several blocks are processed in an interleaved way to keep the AES
+ * units busy.
+ *
+ * @param rk Expanded round keys, (rounds + 1) * 16 bytes.
+ * @param rounds Number of rounds (10 or 14).
+ * @param in Input blocks.
+ * @param out Output blocks, it can be the same buffer as @p in.
+ * @param blocks Number of blocks.
+ */
+void hubble_aes_accel_encrypt(const uint8_t *rk, unsigned int rounds,
+			      const uint8_t *in, uint8_t *out, size_t blocks);
+
+#endif /* SRC_CRYPTO_AES_ACCEL_H */
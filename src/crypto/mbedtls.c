@@ -1,4 +1,5 @@
 #include <errno.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -21,6 +22,333 @@
 #error "Invalid Hubble Key size"
 #endif
 
+/* Constant used to derive the CMAC subkeys (NIST SP 800-38B) */
+#define _CMAC_RB 0x87
+
+/* Multiplication by x in GF(2^128), used to generate the subkeys */
+static void _cmac_subkey_shift(const uint8_t in[HUBBLE_AES_BLOCK_SIZE],
+			       uint8_t out[HUBBLE_AES_BLOCK_SIZE])
+{
+	uint8_t msb = in[0] >> 7;
+
+	for (size_t i = 0; i < HUBBLE_AES_BLOCK_SIZE - 1; i++) {
+		out[i] = (uint8_t)((in[i] << 1) | (in[i + 1] >> 7));
+	}
+
+	/* Avoid branching on the secret bit */
+	out[HUBBLE_AES_BLOCK_SIZE - 1] =
+		(uint8_t)(in[HUBBLE_AES_BLOCK_SIZE - 1] << 1) ^
+		(uint8_t)(-msb & _CMAC_RB);
+}
+
+/* Expands the AES key and generates the CMAC subkeys K1 and K2 */
+static int _aes_key_setup(mbedtls_aes_context *aes,
+			  const uint8_t key[CONFIG_HUBBLE_KEY_SIZE],
+			  uint8_t k1[HUBBLE_AES_BLOCK_SIZE],
+			  uint8_t k2[HUBBLE_AES_BLOCK_SIZE])
+{
+	int ret;
+	uint8_t l[HUBBLE_AES_BLOCK_SIZE] = {0};
+
+	ret = mbedtls_aes_setkey_enc(aes, key, HUBBLE_KEY_SIZE_BITS);
+	if (ret != 0) {
+		return ret;
+	}
+
+	/* L = AES(K, 0), K1 = L * x, K2 = K1 * x */
+	ret = mbedtls_aes_crypt_ecb(aes, MBEDTLS_AES_ENCRYPT, l, l);
+	if (ret == 0) {
+		_cmac_subkey_shift(l, k1);
+		_cmac_subkey_shift(k1, k2);
+	}
+
+	mbedtls_platform_zeroize(l, sizeof(l));
+
+	return ret;
+}
+
+/* Absorbs the last (up to one block) chunk of the message and outputs
+ * the tag. A complete last block is masked with K1, a padded one with
+ * K2.
+ */
+static int _cmac_finish(mbedtls_aes_context *aes,
+			const uint8_t k1[HUBBLE_AES_BLOCK_SIZE],
+			const uint8_t k2[HUBBLE_AES_BLOCK_SIZE],
+			uint8_t state[HUBBLE_AES_BLOCK_SIZE],
+			const uint8_t *last, size_t last_len,
+			uint8_t tag[HUBBLE_AES_BLOCK_SIZE])
+{
+	int ret;
+	uint8_t block[HUBBLE_AES_BLOCK_SIZE] = {0};
+
+	if (last_len == HUBBLE_AES_BLOCK_SIZE) {
+		for (size_t i = 0; i < HUBBLE_AES_BLOCK_SIZE; i++) {
+			block[i] = last[i] ^ k1[i];
+		}
+	} else {
+		if (last_len > 0) {
+			memcpy(block, last, last_len);
+		}
+		block[last_len] = 0x80;
+
+		for (size_t i = 0; i < HUBBLE_AES_BLOCK_SIZE; i++) {
+			block[i] ^= k2[i];
+		}
+	}
+
+	for (size_t i = 0; i < HUBBLE_AES_BLOCK_SIZE; i++) {
+		state[i] ^= block[i];
+	}
+
+	ret = mbedtls_aes_crypt_ecb(aes, MBEDTLS_AES_ENCRYPT, state, tag);
+
+	mbedtls_platform_zeroize(block, sizeof(block));
+
+	return ret;
+}
+
+/* CBC-MAC step for every block but the last one */
+static int _cmac_update_block(mbedtls_aes_context *aes,
+			      uint8_t state[HUBBLE_AES_BLOCK_SIZE],
+			      const uint8_t block[HUBBLE_AES_BLOCK_SIZE])
+{
+	for (size_t i = 0; i < HUBBLE_AES_BLOCK_SIZE; i++) {
+		state[i] ^= block[i];
+	}
+
+	return mbedtls_aes_crypt_ecb(aes, MBEDTLS_AES_ENCRYPT, state, state);
+}
+
+static void _ctr_increment(uint8_t nonce_counter[HUBBLE_NONCE_BUFFER_SIZE])
+{
+	for (size_t i = HUBBLE_NONCE_BUFFER_SIZE; i > 0; i--) {
+		if (++nonce_counter[i - 1] != 0) {
+			break;
+		}
+	}
+}
+
+/* Encrypts and authenticates the ciphertext block by block, so the
+ * data is only walked once.
+ */
+static int _ctr_cmac(mbedtls_aes_context *aes,
+		     const uint8_t k1[HUBBLE_AES_BLOCK_SIZE],
+		     const uint8_t k2[HUBBLE_AES_BLOCK_SIZE],
+		     uint8_t nonce_counter[HUBBLE_NONCE_BUFFER_SIZE],
+		     const uint8_t *data, size_t len, uint8_t *output,
+		     uint8_t tag[HUBBLE_AES_BLOCK_SIZE])
+{
+	int ret = 0;
+	uint8_t state[HUBBLE_AES_BLOCK_SIZE] = {0};
+	uint8_t stream_block[_STREAM_BLOCK_LEN];
+
+	while (len > HUBBLE_AES_BLOCK_SIZE) {
+		ret = mbedtls_aes_crypt_ecb(aes, MBEDTLS_AES_ENCRYPT,
+					    nonce_counter, stream_block);
+		if (ret != 0) {
+			goto exit;
+		}
+		_ctr_increment(nonce_counter);
+
+		for (size_t i = 0; i < HUBBLE_AES_BLOCK_SIZE; i++) {
+			output[i] = data[i] ^ stream_block[i];
+		}
+
+		ret = _cmac_update_block(aes, state, output);
+		if (ret != 0) {
+			goto exit;
+		}
+
+		data += HUBBLE_AES_BLOCK_SIZE;
+		output += HUBBLE_AES_BLOCK_SIZE;
+		len -= HUBBLE_AES_BLOCK_SIZE;
+	}
+
+	if (len > 0) {
+		ret = mbedtls_aes_crypt_ecb(aes, MBEDTLS_AES_ENCRYPT,
+					    nonce_counter, stream_block);
+		if (ret != 0) {
+			goto exit;
+		}
+		_ctr_increment(nonce_counter);
+
+		for (size_t i = 0; i < len; i++) {
+			output[i] = data[i] ^ stream_block[i];
+		}
+	}
+
+	ret = _cmac_finish(aes, k1, k2, state, output, len, tag);
+
+exit:
+	mbedtls_platform_zeroize(state, sizeof(state));
+	mbedtls_platform_zeroize(stream_block, sizeof(stream_block));
+
+	return ret;
+}
+
+#ifdef CONFIG_HUBBLE_NETWORK_CRYPTO_MBEDTLS_KEY_CACHE
+/* The expanded AES key and the CMAC subkeys (K1 and K2) are kept per
+ * key, so repeated operations under the same key (e.g. the KBKDF
+ * iterations) skip the key schedule and the subkey generation. The
+ * least recently used entry is dropped when a new key is needed.
+ *
+ * There is no lock, a slot handed out can be taken over by another
+ * caller. The cache is only safe when a single thread uses the crypto
+ * functions.
+ */
+static struct _aes_key_slot {
+	bool valid;
+	uint32_t last_used;
+	uint8_t key[CONFIG_HUBBLE_KEY_SIZE];
+	uint8_t k1[HUBBLE_AES_BLOCK_SIZE];
+	uint8_t k2[HUBBLE_AES_BLOCK_SIZE];
+	mbedtls_aes_context aes;
+} _key_slots[CONFIG_HUBBLE_NETWORK_CRYPTO_MBEDTLS_KEY_SLOTS];
+
+static uint32_t _key_slots_clock;
+
+static bool _key_equal(const uint8_t *a, const uint8_t *b)
+{
+	uint8_t diff = 0;
+
+	/* Do not leak how many bytes of a key match */
+	for (size_t i = 0; i < CONFIG_HUBBLE_KEY_SIZE; i++) {
+		diff |= a[i] ^ b[i];
+	}
+
+	return diff == 0U;
+}
+
+static void _key_slot_release(struct _aes_key_slot *slot)
+{
+	if (slot->valid) {
+		mbedtls_aes_free(&slot->aes);
+	}
+
+	mbedtls_platform_zeroize(slot, sizeof(*slot));
+}
+
+static int _key_slot_get(const uint8_t key[CONFIG_HUBBLE_KEY_SIZE],
+			 struct _aes_key_slot **out)
+{
+	int ret;
+	/* Free slots have last_used zeroed, they are picked first */
+	struct _aes_key_slot *slot = &_key_slots[0];
+
+	for (size_t i = 0; i < HUBBLE_ARRAY_SIZE(_key_slots); i++) {
+		if (_key_slots[i].valid && _key_equal(_key_slots[i].key, key)) {
+			_key_slots[i].last_used = ++_key_slots_clock;
+			*out = &_key_slots[i];
+			return 0;
+		}
+
+		if (_key_slots[i].last_used < slot->last_used) {
+			slot = &_key_slots[i];
+		}
+	}
+
+	_key_slot_release(slot);
+
+	mbedtls_aes_init(&slot->aes);
+	ret = _aes_key_setup(&slot->aes, key, slot->k1, slot->k2);
+	if (ret != 0) {
+		mbedtls_aes_free(&slot->aes);
+		mbedtls_platform_zeroize(slot, sizeof(*slot));
+		return ret;
+	}
+
+	memcpy(slot->key, key, CONFIG_HUBBLE_KEY_SIZE);
+	slot->last_used = ++_key_slots_clock;
+	slot->valid = true;
+	*out = slot;
+
+	return 0;
+}
+
+int hubble_crypto_cmac(const uint8_t key[CONFIG_HUBBLE_KEY_SIZE],
+		       const uint8_t *input, size_t input_len,
+		       uint8_t output[HUBBLE_AES_BLOCK_SIZE])
+{
+	int ret;
+	struct _aes_key_slot *slot;
+	uint8_t state[HUBBLE_AES_BLOCK_SIZE] = {0};
+
+	ret = _key_slot_get(key, &slot);
+	if (ret != 0) {
+		return ret;
+	}
+
+	while (input_len > HUBBLE_AES_BLOCK_SIZE) {
+		ret = _cmac_update_block(&slot->aes, state, input);
+		if (ret != 0) {
+			goto exit;
+		}
+
+		input += HUBBLE_AES_BLOCK_SIZE;
+		input_len -= HUBBLE_AES_BLOCK_SIZE;
+	}
+
+	ret = _cmac_finish(&slot->aes, slot->k1, slot->k2, state, input,
+			   input_len, output);
+
+exit:
+	mbedtls_platform_zeroize(state, sizeof(state));
+
+	return ret;
+}
+
+int hubble_crypto_aes_ctr(const uint8_t key[CONFIG_HUBBLE_KEY_SIZE],
+			  uint8_t nonce_counter[HUBBLE_NONCE_BUFFER_SIZE],
+			  const uint8_t *data, size_t len, uint8_t *output)
+{
+	int ret;
+	size_t nc_off = 0;
+	struct _aes_key_slot *slot;
+	uint8_t stream_block[_STREAM_BLOCK_LEN] = {0};
+
+	/* No data to encrypt */
+	if (len == 0) {
+		return 0;
+	}
+
+	ret = _key_slot_get(key, &slot);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = mbedtls_aes_crypt_ctr(&slot->aes, len, &nc_off, nonce_counter,
+				    stream_block, data, output);
+
+	mbedtls_platform_zeroize(stream_block, sizeof(stream_block));
+
+	return ret;
+}
+
+int hubble_crypto_ctr_cmac(const uint8_t key[CONFIG_HUBBLE_KEY_SIZE],
+			   uint8_t nonce_counter[HUBBLE_NONCE_BUFFER_SIZE],
+			   const uint8_t *data, size_t len, uint8_t *output,
+			   uint8_t tag[HUBBLE_AES_BLOCK_SIZE])
+{
+	int ret;
+	struct _aes_key_slot *slot;
+
+	ret = _key_slot_get(key, &slot);
+	if (ret != 0) {
+		return ret;
+	}
+
+	return _ctr_cmac(&slot->aes, slot->k1, slot->k2, nonce_counter, data,
+			 len, output, tag);
+}
+
+void hubble_crypto_keys_release(void)
+{
+	for (size_t i = 0; i < HUBBLE_ARRAY_SIZE(_key_slots); i++) {
+		_key_slot_release(&_key_slots[i]);
+	}
+}
+#else
+
 int hubble_crypto_cmac(const uint8_t key[CONFIG_HUBBLE_KEY_SIZE],
 		       const uint8_t *input, size_t input_len,
 		       uint8_t output[HUBBLE_AES_BLOCK_SIZE])
@@ -103,6 +431,33 @@ key_error:
 	return ret;
 }
 
+int hubble_crypto_ctr_cmac(const uint8_t key[CONFIG_HUBBLE_KEY_SIZE],
+			   uint8_t nonce_counter[HUBBLE_NONCE_BUFFER_SIZE],
+			   const uint8_t *data, size_t len, uint8_t *output,
+			   uint8_t tag[HUBBLE_AES_BLOCK_SIZE])
+{
+	int ret;
+	mbedtls_aes_context aes_ctx;
+	uint8_t k1[HUBBLE_AES_BLOCK_SIZE];
+	uint8_t k2[HUBBLE_AES_BLOCK_SIZE];
+
+	/* A single key schedule for both the encryption and the tag */
+	mbedtls_aes_init(&aes_ctx);
+
+	ret = _aes_key_setup(&aes_ctx, key, k1, k2);
+	if (ret == 0) {
+		ret = _ctr_cmac(&aes_ctx, k1, k2, nonce_counter, data, len,
+				output, tag);
+	}
+
+	mbedtls_platform_zeroize(k1, sizeof(k1));
+	mbedtls_platform_zeroize(k2, sizeof(k2));
+	mbedtls_aes_free(&aes_ctx);
+
+	return ret;
+}
+#endif /* CONFIG_HUBBLE_NETWORK_CRYPTO_MBEDTLS_KEY_CACHE */
+
 void hubble_crypto_zeroize(void *buf, size_t len)
 {
 	mbedtls_platform_zeroize(buf, len);
@@ -1,6 +1,7 @@
 #include <psa/crypto.h>
 
 #include <errno.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -54,6 +55,106 @@ static int _psa_status_to_errno(psa_status_t status)
 	return ret;
 }
 
+#ifdef CONFIG_HUBBLE_NETWORK_CRYPTO_PSA_KEY_CACHE
+/* Keys stay imported (volatile) and are looked up by value and
+ * algorithm, so the master key and the day-level keys are not imported
+ * and destroyed on every operation. The least recently used key is
+ * destroyed when a slot is needed.
+ *
+ * There is no lock, a key id handed out can be destroyed by another
+ * caller needing a slot. The cache is only safe when a single thread
+ * uses the crypto functions.
+ */
+static struct _psa_key_slot {
+	psa_key_id_t key_id;
+	psa_algorithm_t alg;
+	uint32_t last_used;
+	uint8_t key[CONFIG_HUBBLE_KEY_SIZE];
+} _key_slots[CONFIG_HUBBLE_NETWORK_CRYPTO_PSA_KEY_SLOTS];
+
+static uint32_t _key_slots_clock;
+
+static bool _key_equal(const uint8_t *a, const uint8_t *b)
+{
+	uint8_t diff = 0;
+
+	/* Do not leak how many bytes of a key match */
+	for (size_t i = 0; i < CONFIG_HUBBLE_KEY_SIZE; i++) {
+		diff |= a[i] ^ b[i];
+	}
+
+	return diff == 0U;
+}
+
+static void _key_slot_release(struct _psa_key_slot *slot)
+{
+	if (slot->key_id != PSA_KEY_ID_NULL) {
+		(void)psa_destroy_key(slot->key_id);
+	}
+
+	hubble_crypto_zeroize(slot, sizeof(*slot));
+}
+#endif /* CONFIG_HUBBLE_NETWORK_CRYPTO_PSA_KEY_CACHE */
+
+static psa_status_t _key_get(const uint8_t key[CONFIG_HUBBLE_KEY_SIZE],
+			     psa_algorithm_t alg, psa_key_usage_t usage,
+			     psa_key_id_t *key_id)
+{
+	psa_status_t status;
+	psa_key_attributes_t attributes = PSA_KEY_ATTRIBUTES_INIT;
+
+#ifdef CONFIG_HUBBLE_NETWORK_CRYPTO_PSA_KEY_CACHE
+	/* Free slots have last_used zeroed, they are picked first */
+	struct _psa_key_slot *victim = &_key_slots[0];
+
+	for (size_t i = 0; i < HUBBLE_ARRAY_SIZE(_key_slots); i++) {
+		struct _psa_key_slot *slot = &_key_slots[i];
+
+		if ((slot->key_id != PSA_KEY_ID_NULL) && (slot->alg == alg) &&
+		    _key_equal(slot->key, key)) {
+			slot->last_used = ++_key_slots_clock;
+			*key_id = slot->key_id;
+			return PSA_SUCCESS;
+		}
+
+		if (slot->last_used < victim->last_used) {
+			victim = slot;
+		}
+	}
+
+	_key_slot_release(victim);
+#endif
+
+	psa_set_key_usage_flags(&attributes, usage);
+	psa_set_key_type(&attributes, PSA_KEY_TYPE_AES);
+	psa_set_key_algorithm(&attributes, alg);
+	psa_set_key_bits(&attributes, HUBBLE_KEY_SIZE_BITS);
+
+	status = psa_import_key(&attributes, key, CONFIG_HUBBLE_KEY_SIZE,
+				key_id);
+
+#ifdef CONFIG_HUBBLE_NETWORK_CRYPTO_PSA_KEY_CACHE
+	if (status == PSA_SUCCESS) {
+		memcpy(victim->key, key, CONFIG_HUBBLE_KEY_SIZE);
+		victim->alg = alg;
+		victim->last_used = ++_key_slots_clock;
+		victim->key_id = *key_id;
+	}
+#endif
+
+	return status;
+}
+
+static void _key_put(psa_key_id_t key_id)
+{
+#ifdef CONFIG_HUBBLE_NETWORK_CRYPTO_PSA_KEY_CACHE
+	/* Owned by the cache */
+	(void)key_id;
+#else
+	(void)psa_destroy_key(key_id);
+#endif
+}
+
 int hubble_crypto_cmac(const uint8_t key[CONFIG_HUBBLE_KEY_SIZE],
 		       const uint8_t *input, size_t input_len,
 		       uint8_t output[HUBBLE_AES_BLOCK_SIZE])
@@ -61,16 +162,9 @@ int hubble_crypto_cmac(const uint8_t key[CONFIG_HUBBLE_KEY_SIZE],
 	psa_status_t status;
 	psa_key_id_t key_id;
 	size_t mac_length = 0;
-	psa_key_attributes_t attributes = PSA_KEY_ATTRIBUTES_INIT;
 	psa_mac_operation_t operation = PSA_MAC_OPERATION_INIT;
 
-	psa_set_key_usage_flags(&attributes, PSA_KEY_USAGE_SIGN_HASH);
-	psa_set_key_type(&attributes, PSA_KEY_TYPE_AES);
-	psa_set_key_algorithm(&attributes, PSA_ALG_CMAC);
-	psa_set_key_bits(&attributes, HUBBLE_KEY_SIZE_BITS);
-
-	status = psa_import_key(&attributes, key, CONFIG_HUBBLE_KEY_SIZE,
-				&key_id);
+	status = _key_get(key, PSA_ALG_CMAC, PSA_KEY_USAGE_SIGN_HASH, &key_id);
 	if (status != PSA_SUCCESS) {
 		goto import_key_error;
 	}
@@ -90,7 +184,7 @@ int hubble_crypto_cmac(const uint8_t key[CONFIG_HUBBLE_KEY_SIZE],
 				     &mac_length);
 mac_update_error:
 mac_setup_error:
-	psa_destroy_key(key_id);
+	_key_put(key_id);
 
 import_key_error:
 	return status == PSA_SUCCESS ? 0 : -EINVAL;
@@ -103,17 +197,10 @@ int hubble_crypto_aes_ctr(const uint8_t key[CONFIG_HUBBLE_KEY_SIZE],
 	psa_status_t status;
 	psa_key_id_t key_id;
 	const psa_algorithm_t alg = PSA_ALG_CTR;
-	psa_key_attributes_t attributes = PSA_KEY_ATTRIBUTES_INIT;
 	psa_cipher_operation_t operation = PSA_CIPHER_OPERATION_INIT;
 	size_t out_len = 0;
 
-	psa_set_key_usage_flags(&attributes, PSA_KEY_USAGE_ENCRYPT);
-	psa_set_key_algorithm(&attributes, alg);
-	psa_set_key_type(&attributes, PSA_KEY_TYPE_AES);
-	psa_set_key_bits(&attributes, HUBBLE_KEY_SIZE_BITS);
-
-	status = psa_import_key(&attributes, key, CONFIG_HUBBLE_KEY_SIZE,
-				&key_id);
+	status = _key_get(key, alg, PSA_KEY_USAGE_ENCRYPT, &key_id);
 	if (status != PSA_SUCCESS) {
 		goto import_key_error;
 	}
@@ -141,11 +228,20 @@ cipher_update_error:
 cipher_iv_error:
 	psa_cipher_abort(&operation);
 cipher_setup_error:
-	(void)psa_destroy_key(key_id);
+	_key_put(key_id);
 import_key_error:
 	return status == PSA_SUCCESS ? 0 : -EINVAL;
 }
 
+#ifdef CONFIG_HUBBLE_NETWORK_CRYPTO_PSA_KEY_CACHE
+void hubble_crypto_keys_release(void)
+{
+	for (size_t i = 0; i < HUBBLE_ARRAY_SIZE(_key_slots); i++) {
+		_key_slot_release(&_key_slots[i]);
+	}
+}
+#endif /* CONFIG_HUBBLE_NETWORK_CRYPTO_PSA_KEY_CACHE */
+
 void hubble_crypto_zeroize(void *buf, size_t len)
 {
 	memset(buf, 0, len);
@@ -0,0 +1,845 @@
+/*
+ * Copyright (c) 2026 Hubble Network, Inc.
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * SPDX-License-Identifier: Apache-2.0 AND MIT
+ */
+
+/* Self-contained AES-CTR / AES-CMAC provider.
+ *
+ * AES is implemented with the 32-bit bitsliced representation (two
+ * blocks are processed at once, one bit of every byte per word) and the
+ * Boyar-Peralta S-box circuit, derived from the aes_ct implementation of
+ * BearSSL (MIT license, see the notice below). There are no table lookups
+ * nor branches depending on secret data, so it runs in constant time on
+ * cores without data cache (e.g. Cortex-M0+/M4) as well as on larger
+ * ones.
+ *
+ * With CONFIG_HUBBLE_NETWORK_CRYPTO_SOFTWARE_HOST_ACCEL, the AES
+ * instructions of the host CPU are used instead when they are available
+ * at runtime (see aes_accel.c).
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <hubble/port/crypto.h>
+
+#include "../utils/macros.h"
+
+#ifdef CONFIG_HUBBLE_NETWORK_CRYPTO_SOFTWARE_HOST_ACCEL
+#include "aes_accel.h"
+#endif
+
+#if CONFIG_HUBBLE_KEY_SIZE == 32
+#define _ROUNDS 14U
+#elif CONFIG_HUBBLE_KEY_SIZE == 16
+#define _ROUNDS 10U
+#else
+#error "Invalid Hubble Key size"
+#endif
+
+/* Round key words */
+#define _RK_WORDS   ((_ROUNDS + 1U) * 4U)
+/* Round keys in bitsliced form, 8 words per round key */
+#define _SKEY_WORDS ((_ROUNDS + 1U) * 8U)
+
+/* Blocks encrypted at once for the CTR key stream */
+#define _CTR_BLOCKS 4U
+
+/* Messages authenticated at once by hubble_crypto_cmac_multi() */
+#define _CMAC_LANES 4U
+
+/* Constant used to derive the CMAC subkeys (NIST SP 800-38B) */
+#define _CMAC_RB    0x87
+
+struct _aes_ctx {
+#ifdef CONFIG_HUBBLE_NETWORK_CRYPTO_SOFTWARE_HOST_ACCEL
+	bool accel;
+	/* Round keys in byte form, used by the AES instructions */
+	uint8_t rk[_RK_WORDS * 4U];
+#endif
+	uint32_t skey[_SKEY_WORDS];
+};
+
+static inline uint32_t _dec32le(const uint8_t *src)
+{
+	return (uint32_t)src[0] | ((uint32_t)src[1] << 8) |
+	       ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24);
+}
+
+static inline void _enc32le(uint8_t *dst, uint32_t x)
+{
+	dst[0] = (uint8_t)x;
+	dst[1] = (uint8_t)(x >> 8);
+	dst[2] = (uint8_t)(x >> 16);
+	dst[3] = (uint8_t)(x >> 24);
+}
+
+/*
+ * The functions from _sbox() to _aes_encrypt2() are derived from the
+ * aes_ct implementation of BearSSL (src/symcipher/aes_ct.c,
+ * aes_ct_enc.c), under the following license:
+ *
+ * Copyright (c) 2016 Thomas Pornin <pornin@bolet.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/* S-box applied to the 8 bit planes (Boyar-Peralta circuit) */
+static void _sbox(uint32_t q[8])
+{
+	uint32_t x0, x1, x2, x3, x4, x5, x6, x7;
+	uint32_t y1, y2, y3, y4, y5, y6, y7, y8, y9;
+	uint32_t y10, y11, y12, y13, y14, y15, y16, y17, y18, y19;
+	uint32_t y20, y21;
+	uint32_t z0, z1, z2, z3, z4, z5, z6, z7, z8, z9;
+	uint32_t z10, z11, z12, z13, z14, z15, z16, z17;
+	uint32_t t0, t1, t2, t3, t4, t5, t6, t7, t8, t9;
+	uint32_t t10, t11, t12, t13, t14, t15, t16, t17, t18, t19;
+	uint32_t t20, t21, t22, t23, t24, t25, t26, t27, t28, t29;
+	uint32_t t30, t31, t32, t33, t34, t35, t36, t37, t38, t39;
+	uint32_t t40, t41, t42, t43, t44, t45, t46, t47, t48, t49;
+	uint32_t t50, t51, t52, t53, t54, t55, t56, t57, t58, t59;
+	uint32_t t60, t61, t62, t63, t64, t65, t66, t67;
+	uint32_t s0, s1, s2, s3, s4, s5, s6, s7;
+
+	x0 = q[7];
+	x1 = q[6];
+	x2 = q[5];
+	x3 = q[4];
+	x4 = q[3];
+	x5 = q[2];
+	x6 = q[1];
+	x7 = q[0];
+
+	/* Top linear transformation */
+	y14 = x3 ^ x5;
+	y13 = x0 ^ x6;
+	y9 = x0 ^ x3;
+	y8 = x0 ^ x5;
+	t0 = x1 ^ x2;
+	y1 = t0 ^ x7;
+	y4 = y1 ^ x3;
+	y12 = y13 ^ y14;
+	y2 = y1 ^ x0;
+	y5 = y1 ^ x6;
+	y3 = y5 ^ y8;
+	t1 = x4 ^ y12;
+	y15 = t1 ^ x5;
+	y20 = t1 ^ x1;
+	y6 = y15 ^ x7;
+	y10 = y15 ^ t0;
+	y11 = y20 ^ y9;
+	y7 = x7 ^ y11;
+	y17 = y10 ^ y11;
+	y19 = y10 ^ y8;
+	y16 = t0 ^ y11;
+	y21 = y13 ^ y16;
+	y18 = x0 ^ y16;
+
+	/* Non-linear section */
+	t2 = y12 & y15;
+	t3 = y3 & y6;
+	t4 = t3 ^ t2;
+	t5 = y4 & x7;
+	t6 = t5 ^ t2;
+	t7 = y13 & y16;
+	t8 = y5 & y1;
+	t9 = t8 ^ t7;
+	t10 = y2 & y7;
+	t11 = t10 ^ t7;
+	t12 = y9 & y11;
+	t13 = y14 & y17;
+	t14 = t13 ^ t12;
+	t15 = y8 & y10;
+	t16 = t15 ^ t12;
+	t17 = t4 ^ t14;
+	t18 = t6 ^ t16;
+	t19 = t9 ^ t14;
+	t20 = t11 ^ t16;
+	t21 = t17 ^ y20;
+	t22 = t18 ^ y19;
+	t23 = t19 ^ y21;
+	t24 = t20 ^ y18;
+
+	t25 = t21 ^ t22;
+	t26 = t21 & t23;
+	t27 = t24 ^ t26;
+	t28 = t25 & t27;
+	t29 = t28 ^ t22;
+	t30 = t23 ^ t24;
+	t31 = t22 ^ t26;
+	t32 = t31 & t30;
+	t33 = t32 ^ t24;
+	t34 = t23 ^ t33;
+	t35 = t27 ^ t33;
+	t36 = t24 & t35;
+	t37 = t36 ^ t34;
+	t38 = t27 ^ t36;
+	t39 = t29 & t38;
+	t40 = t25 ^ t39;
+
+	t41 = t40 ^ t37;
+	t42 = t29 ^ t33;
+	t43 = t29 ^ t40;
+	t44 = t33 ^ t37;
+	t45 = t42 ^ t41;
+	z0 = t44 & y15;
+	z1 = t37 & y6;
+	z2 = t33 & x7;
+	z3 = t43 & y16;
+	z4 = t40 & y1;
+	z5 = t29 & y7;
+	z6 = t42 & y11;
+	z7 = t45 & y17;
+	z8 = t41 & y10;
+	z9 = t44 & y12;
+	z10 = t37 & y3;
+	z11 = t33 & y4;
+	z12 = t43 & y13;
+	z13 = t40 & y5;
+	z14 = t29 & y2;
+	z15 = t42 & y9;
+	z16 = t45 & y14;
+	z17 = t41 & y8;
+
+	/* Bottom linear transformation */
+	t46 = z15 ^ z16;
+	t47 = z10 ^ z11;
+	t48 = z5 ^ z13;
+	t49 = z9 ^ z10;
+	t50 = z2 ^ z12;
+	t51 = z2 ^ z5;
+	t52 = z7 ^ z8;
+	t53 = z0 ^ z3;
+	t54 = z6 ^ z7;
+	t55 = z16 ^ z17;
+	t56 = z12 ^ t48;
+	t57 = t50 ^ t53;
+	t58 = z4 ^ t46;
+	t59 = z3 ^ t54;
+	t60 = t46 ^ t57;
+	t61 = z14 ^ t57;
+	t62 = t52 ^ t58;
+	t63 = t49 ^ t58;
+	t64 = z4 ^ t59;
+	t65 = t61 ^ t62;
+	t66 = z1 ^ t63;
+	s0 = t59 ^ t63;
+	s6 = t56 ^ ~t62;
+	s7 = t48 ^ ~t60;
+	t67 = t64 ^ t65;
+	s3 = t53 ^ t66;
+	s4 = t51 ^ t66;
+	s5 = t47 ^ t65;
+	s1 = t64 ^ ~s3;
+	s2 = t55 ^ ~t67;
+
+	q[7] = s0;
+	q[6] = s1;
+	q[5] = s2;
+	q[4] = s3;
+	q[3] = s4;
+	q[2] = s5;
+	q[1] = s6;
+	q[0] = s7;
+}
+
+#define _SWAPN(cl, ch, s, x, y)                                                \
+	do {                                                                   \
+		uint32_t a = (x);                                              \
+		uint32_t b = (y);                                              \
+		(x) = (a & (uint32_t)(cl)) | ((b & (uint32_t)(cl)) << (s));    \
+		(y) = ((a & (uint32_t)(ch)) >> (s)) | (b & (uint32_t)(ch));    \
+	} while (0)
+
+#define _SWAP2(x, y) _SWAPN(0x55555555, 0xAAAAAAAA, 1, x, y)
+#define _SWAP4(x, y) _SWAPN(0x33333333, 0xCCCCCCCC, 2, x, y)
+#define _SWAP8(x, y) _SWAPN(0x0F0F0F0F, 0xF0F0F0F0, 4, x, y)
+
+/* Converts between the byte and the bitsliced representation (it is
+ * its own inverse). Words 0, 2, 4 and 6 hold the first block, words
+ * 1, 3, 5 and 7 the second one.
+ */
+static void _ortho(uint32_t q[8])
+{
+	_SWAP2(q[0], q[1]);
+	_SWAP2(q[2], q[3]);
+	_SWAP2(q[4], q[5]);
+	_SWAP2(q[6], q[7]);
+
+	_SWAP4(q[0], q[2]);
+	_SWAP4(q[1], q[3]);
+	_SWAP4(q[4], q[6]);
+	_SWAP4(q[5], q[7]);
+
+	_SWAP8(q[0], q[4]);
+	_SWAP8(q[1], q[5]);
+	_SWAP8(q[2], q[6]);
+	_SWAP8(q[3], q[7]);
+}
+
+static void _add_round_key(uint32_t q[8], const uint32_t sk[8])
+{
+	for (size_t i = 0; i < 8; i++) {
+		q[i] ^= sk[i];
+	}
+}
+
+static void _shift_rows(uint32_t q[8])
+{
+	for (size_t i = 0; i < 8; i++) {
+		uint32_t x = q[i];
+
+		q[i] = (x & 0x000000FF) | ((x & 0x0000FC00) >> 2) |
+		       ((x & 0x00000300) << 6) | ((x & 0x00F00000) >> 4) |
+		       ((x & 0x000F0000) << 4) | ((x & 0xC0000000) >> 6) |
+		       ((x & 0x3F000000) << 2);
+	}
+}
+
+static inline uint32_t _rotr16(uint32_t x)
+{
+	return (x << 16) | (x >> 16);
+}
+
+static void _mix_columns(uint32_t q[8])
+{
+	uint32_t q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3];
+	uint32_t q4 = q[4], q5 = q[5], q6 = q[6], q7 = q[7];
+	uint32_t r0 = (q0 >> 8) | (q0 << 24);
+	uint32_t r1 = (q1 >> 8) | (q1 << 24);
+	uint32_t r2 = (q2 >> 8) | (q2 << 24);
+	uint32_t r3 = (q3 >> 8) | (q3 << 24);
+	uint32_t r4 = (q4 >> 8) | (q4 << 24);
+	uint32_t r5 = (q5 >> 8) | (q5 << 24);
+	uint32_t r6 = (q6 >> 8) | (q6 << 24);
+	uint32_t r7 = (q7 >> 8) | (q7 << 24);
+
+	q[0] = q7 ^ r7 ^ r0 ^ _rotr16(q0 ^ r0);
+	q[1] = q0 ^ r0 ^ q7 ^ r7 ^ r1 ^ _rotr16(q1 ^ r1);
+	q[2] = q1 ^ r1 ^ r2 ^ _rotr16(q2 ^ r2);
+	q[3] = q2 ^ r2 ^ q7 ^ r7 ^ r3 ^ _rotr16(q3 ^ r3);
+	q[4] = q3 ^ r3 ^ q7 ^ r7 ^ r4 ^ _rotr16(q4 ^ r4);
+	q[5] = q4 ^ r4 ^ r5 ^ _rotr16(q5 ^ r5);
+	q[6] = q5 ^ r5 ^ r6 ^ _rotr16(q6 ^ r6);
+	q[7] = q6 ^ r6 ^ r7 ^ _rotr16(q7 ^ r7);
+}
+
+static uint32_t _sub_word(uint32_t x)
+{
+	uint32_t q[8] = {x};
+
+	_ortho(q);
+	_sbox(q);
+	_ortho(q);
+
+	return q[0];
+}
+
+static void _aes_setkey(struct _aes_ctx *ctx,
+			const uint8_t key[CONFIG_HUBBLE_KEY_SIZE])
+{
+	static const uint8_t rcon[] = {0x01, 0x02, 0x04, 0x08, 0x10,
+				       0x20, 0x40, 0x80, 0x1B, 0x36};
+	const size_t nk = CONFIG_HUBBLE_KEY_SIZE / 4U;
+	uint32_t (*sub_word)(uint32_t) = _sub_word;
+	uint32_t w[_RK_WORDS];
+	uint32_t tmp;
+
+#ifdef CONFIG_HUBBLE_NETWORK_CRYPTO_SOFTWARE_HOST_ACCEL
+	ctx->accel = hubble_aes_accel_supported();
+	if (ctx->accel) {
+		sub_word = hubble_aes_accel_sub_word;
+	}
+#endif
+
+	for (size_t i = 0; i < nk; i++) {
+		w[i] = _dec32le(key + (i * 4U));
+	}
+
+	for (size_t i = nk, j = 0, k = 0; i < _RK_WORDS; i++) {
+		tmp = w[i - 1U];
+
+		if (j == 0) {
+			tmp = (tmp << 24) | (tmp >> 8);
+			tmp = sub_word(tmp) ^ rcon[k];
+		} else if ((nk > 6U) && (j == 4U)) {
+			tmp = sub_word(tmp);
+		}
+
+		w[i] = w[i - nk] ^ tmp;
+
+		if (++j == nk) {
+			j = 0;
+			k++;
+		}
+	}
+
+#ifdef CONFIG_HUBBLE_NETWORK_CRYPTO_SOFTWARE_HOST_ACCEL
+	if (ctx->accel) {
+		for (size_t i = 0; i < _RK_WORDS; i++) {
+			_enc32le(&ctx->rk[i * 4U], w[i]);
+		}
+
+		hubble_crypto_zeroize(w, sizeof(w));
+		return;
+	}
+#endif
+
+	/* Every key word is duplicated, one copy per block of a pair */
+	for (size_t i = 0; i < _RK_WORDS; i++) {
+		ctx->skey[i * 2U] = w[i];
+		ctx->skey[(i * 2U) + 1U] = w[i];
+	}
+
+	for (size_t i = 0; i < _SKEY_WORDS; i += 8U) {
+		_ortho(&ctx->skey[i]);
+	}
+
+	hubble_crypto_zeroize(w, sizeof(w));
+}
+
+/* Clears the round keys in use */
+static void _aes_clear(struct _aes_ctx *ctx)
+{
+#ifdef CONFIG_HUBBLE_NETWORK_CRYPTO_SOFTWARE_HOST_ACCEL
+	if (ctx->accel) {
+		hubble_crypto_zeroize(ctx->rk, sizeof(ctx->rk));
+		return;
+	}
+#endif
+
+	hubble_crypto_zeroize(ctx->skey, sizeof(ctx->skey));
+}
+
+/* Encrypts two blocks at once, in and out may overlap */
+static void _aes_encrypt2(const struct _aes_ctx *ctx,
+			  const uint8_t in0[HUBBLE_AES_BLOCK_SIZE],
+			  const uint8_t in1[HUBBLE_AES_BLOCK_SIZE],
+			  uint8_t out0[HUBBLE_AES_BLOCK_SIZE],
+			  uint8_t out1[HUBBLE_AES_BLOCK_SIZE])
+{
+	uint32_t q[8];
+
+	for (size_t i = 0; i < 4; i++) {
+		q[i * 2U] = _dec32le(in0 + (i * 4U));
+		q[(i * 2U) + 1U] = _dec32le(in1 + (i * 4U));
+	}
+
+	_ortho(q);
+
+	_add_round_key(q, ctx->skey);
+	for (size_t round = 1; round < _ROUNDS; round++) {
+		_sbox(q);
+		_shift_rows(q);
+		_mix_columns(q);
+		_add_round_key(q, &ctx->skey[round * 8U]);
+	}
+	_sbox(q);
+	_shift_rows(q);
+	_add_round_key(q, &ctx->skey[_ROUNDS * 8U]);
+
+	_ortho(q);
+
+	for (size_t i = 0; i < 4; i++) {
+		_enc32le(out0 + (i * 4U), q[i * 2U]);
+		_enc32le(out1 + (i * 4U), q[(i * 2U) + 1U]);
+	}
+
+	hubble_crypto_zeroize(q, sizeof(q));
+}
+
+/* End of the code derived from BearSSL */
+
+/* Encrypts independent contiguous blocks, in and out may overlap */
+static void _aes_encrypt_blocks(const struct _aes_ctx *ctx, const uint8_t *in,
+				uint8_t *out, size_t blocks)
+{
+#ifdef CONFIG_HUBBLE_NETWORK_CRYPTO_SOFTWARE_HOST_ACCEL
+	if (ctx->accel) {
+		hubble_aes_accel_encrypt(ctx->rk, _ROUNDS, in, out, blocks);
+		return;
+	}
+#endif
+
+	for (; blocks >= 2U; blocks -= 2U) {
+		_aes_encrypt2(ctx, in, in + HUBBLE_AES_BLOCK_SIZE, out,
+			      out + HUBBLE_AES_BLOCK_SIZE);
+		in += 2U * HUBBLE_AES_BLOCK_SIZE;
+		out += 2U * HUBBLE_AES_BLOCK_SIZE;
+	}
+
+	if (blocks != 0U) {
+		uint8_t unused[HUBBLE_AES_BLOCK_SIZE];
+
+		_aes_encrypt2(ctx, in, in, out, unused);
+		hubble_crypto_zeroize(unused, sizeof(unused));
+	}
+}
+
+static void _aes_encrypt(const struct _aes_ctx *ctx,
+			 const uint8_t in[HUBBLE_AES_BLOCK_SIZE],
+			 uint8_t out[HUBBLE_AES_BLOCK_SIZE])
+{
+	_aes_encrypt_blocks(ctx, in, out, 1U);
+}
+
+/* Multiplication by x in GF(2^128), used to generate the subkeys */
+static void _cmac_subkey_shift(const uint8_t in[HUBBLE_AES_BLOCK_SIZE],
+			       uint8_t out[HUBBLE_AES_BLOCK_SIZE])
+{
+	uint8_t msb = in[0] >> 7;
+
+	for (size_t i = 0; i < HUBBLE_AES_BLOCK_SIZE - 1; i++) {
+		out[i] = (uint8_t)((in[i] << 1) | (in[i + 1] >> 7));
+	}
+
+	/* Avoid branching on the secret bit */
+	out[HUBBLE_AES_BLOCK_SIZE - 1] =
+		(uint8_t)(in[HUBBLE_AES_BLOCK_SIZE - 1] << 1) ^
+		(uint8_t)(-msb & _CMAC_RB);
+}
+
+struct _cmac_ctx {
+	struct _aes_ctx aes;
+	uint8_t k1[HUBBLE_AES_BLOCK_SIZE];
+	uint8_t k2[HUBBLE_AES_BLOCK_SIZE];
+	uint8_t state[HUBBLE_AES_BLOCK_SIZE];
+};
+
+static void _cmac_init(struct _cmac_ctx *ctx,
+		       const uint8_t key[CONFIG_HUBBLE_KEY_SIZE])
+{
+	uint8_t l[HUBBLE_AES_BLOCK_SIZE] = {0};
+
+	_aes_setkey(&ctx->aes, key);
+
+	/* L = AES(K, 0), K1 = L * x, K2 = K1 * x */
+	_aes_encrypt(&ctx->aes, l, l);
+	_cmac_subkey_shift(l, ctx->k1);
+	_cmac_subkey_shift(ctx->k1, ctx->k2);
+
+	memset(ctx->state, 0, sizeof(ctx->state));
+	hubble_crypto_zeroize(l, sizeof(l));
+}
+
+static void _cmac_clear(struct _cmac_ctx *ctx)
+{
+	_aes_clear(&ctx->aes);
+	hubble_crypto_zeroize(ctx->k1, sizeof(ctx->k1));
+	hubble_crypto_zeroize(ctx->k2, sizeof(ctx->k2));
+	hubble_crypto_zeroize(ctx->state, sizeof(ctx->state));
+}
+
+/* CBC-MAC step for every block but the last one */
+static void _cmac_update_block(struct _cmac_ctx *ctx,
+			       const uint8_t block[HUBBLE_AES_BLOCK_SIZE])
+{
+	for (size_t i = 0; i < HUBBLE_AES_BLOCK_SIZE; i++) {
+		ctx->state[i] ^= block[i];
+	}
+
+	_aes_encrypt(&ctx->aes, ctx->state, ctx->state);
+}
+
+/* A complete last block is masked with K1, a padded one with K2 */
+static void _cmac_last_block(const struct _cmac_ctx *ctx, const uint8_t *last,
+			     size_t last_len,
+			     uint8_t block[HUBBLE_AES_BLOCK_SIZE])
+{
+	memset(block, 0, HUBBLE_AES_BLOCK_SIZE);
+
+	if (last_len == HUBBLE_AES_BLOCK_SIZE) {
+		for (size_t i = 0; i < HUBBLE_AES_BLOCK_SIZE; i++) {
+			block[i] = last[i] ^ ctx->k1[i];
+		}
+	} else {
+		if (last_len > 0) {
+			memcpy(block, last, last_len);
+		}
+		block[last_len] = 0x80;
+
+		for (size_t i = 0; i < HUBBLE_AES_BLOCK_SIZE; i++) {
+			block[i] ^= ctx->k2[i];
+		}
+	}
+}
+
+/* Offset of the last, possibly partial, block of a message */
+static size_t _cmac_last_offset(size_t len)
+{
+	if (len == 0U) {
+		return 0U;
+	}
+
+	return ((len - 1U) / HUBBLE_AES_BLOCK_SIZE) * HUBBLE_AES_BLOCK_SIZE;
+}
+
+static void _xor_block(uint8_t out[HUBBLE_AES_BLOCK_SIZE],
+		       const uint8_t a[HUBBLE_AES_BLOCK_SIZE],
+		       const uint8_t b[HUBBLE_AES_BLOCK_SIZE])
+{
+	for (size_t i = 0; i < HUBBLE_AES_BLOCK_SIZE; i++) {
+		out[i] = a[i] ^ b[i];
+	}
+}
+
+static void _cmac_finish(struct _cmac_ctx *ctx, const uint8_t *last,
+			 size_t last_len, uint8_t tag[HUBBLE_AES_BLOCK_SIZE])
+{
+	uint8_t block[HUBBLE_AES_BLOCK_SIZE];
+
+	_cmac_last_block(ctx, last, last_len, block);
+
+	for (size_t i = 0; i < HUBBLE_AES_BLOCK_SIZE; i++) {
+		ctx->state[i] ^= block[i];
+	}
+
+	_aes_encrypt(&ctx->aes, ctx->state, tag);
+
+	hubble_crypto_zeroize(block, sizeof(block));
+}
+
+static void _ctr_increment(uint8_t nonce_counter[HUBBLE_NONCE_BUFFER_SIZE])
+{
+	for (size_t i = HUBBLE_NONCE_BUFFER_SIZE; i > 0; i--) {
+		if (++nonce_counter[i - 1] != 0) {
+			break;
+		}
+	}
+}
+
+/* Produces the key stream of the next counter blocks */
+static void _ctr_stream(const struct _aes_ctx *ctx,
+			uint8_t nonce_counter[HUBBLE_NONCE_BUFFER_SIZE],
+			uint8_t stream[_CTR_BLOCKS * HUBBLE_AES_BLOCK_SIZE],
+			size_t blocks)
+{
+	for (size_t i = 0; i < blocks; i++) {
+		memcpy(&stream[i * HUBBLE_AES_BLOCK_SIZE], nonce_counter,
+		       HUBBLE_NONCE_BUFFER_SIZE);
+		_ctr_increment(nonce_counter);
+	}
+
+	_aes_encrypt_blocks(ctx, stream, stream, blocks);
+}
+
+static size_t _ctr_blocks(size_t len)
+{
+	size_t blocks =
+		(len + HUBBLE_AES_BLOCK_SIZE - 1U) / HUBBLE_AES_BLOCK_SIZE;
+
+	return HUBBLE_MIN(blocks, _CTR_BLOCKS);
+}
+
+void hubble_crypto_zeroize(void *buf, size_t len)
+{
+	volatile uint8_t *p = buf;
+
+	while (len-- > 0) {
+		*p++ = 0;
+	}
+}
+
+int hubble_crypto_init(void)
+{
+	return 0;
+}
+
+int hubble_crypto_aes_ctr(const uint8_t key[CONFIG_HUBBLE_KEY_SIZE],
+			  uint8_t nonce_counter[HUBBLE_NONCE_BUFFER_SIZE],
+			  const uint8_t *data, size_t len, uint8_t *output)
+{
+	struct _aes_ctx ctx;
+	uint8_t stream[_CTR_BLOCKS * HUBBLE_AES_BLOCK_SIZE];
+
+	/* No data to encrypt */
+	if (len == 0) {
+		return 0;
+	}
+
+	_aes_setkey(&ctx, key);
+
+	while (len > 0) {
+		size_t blocks = _ctr_blocks(len);
+		size_t n = HUBBLE_MIN(len, blocks * HUBBLE_AES_BLOCK_SIZE);
+
+		_ctr_stream(&ctx, nonce_counter, stream, blocks);
+
+		for (size_t i = 0; i < n; i++) {
+			output[i] = data[i] ^ stream[i];
+		}
+
+		data += n;
+		output += n;
+		len -= n;
+	}
+
+	_aes_clear(&ctx);
+	hubble_crypto_zeroize(stream, sizeof(stream));
+
+	return 0;
+}
+
+int hubble_crypto_cmac(const uint8_t key[CONFIG_HUBBLE_KEY_SIZE],
+		       const uint8_t *input, size_t input_len,
+		       uint8_t output[HUBBLE_AES_BLOCK_SIZE])
+{
+	struct _cmac_ctx ctx;
+
+	_cmac_init(&ctx, key);
+
+	while (input_len > HUBBLE_AES_BLOCK_SIZE) {
+		_cmac_update_block(&ctx, input);
+		input += HUBBLE_AES_BLOCK_SIZE;
+		input_len -= HUBBLE_AES_BLOCK_SIZE;
+	}
+
+	_cmac_finish(&ctx, input, input_len, output);
+
+	_cmac_clear(&ctx);
+
+	return 0;
+}
+
+int hubble_crypto_cmac_multi(const uint8_t key[CONFIG_HUBBLE_KEY_SIZE],
+			     const uint8_t *const data[], const size_t len[],
+			     size_t count,
+			     uint8_t output[][HUBBLE_AES_BLOCK_SIZE])
+{
+	struct _cmac_ctx ctx;
+	uint8_t state[_CMAC_LANES][HUBBLE_AES_BLOCK_SIZE];
+	uint8_t blocks[_CMAC_LANES][HUBBLE_AES_BLOCK_SIZE];
+	uint8_t last[HUBBLE_AES_BLOCK_SIZE];
+
+	_cmac_init(&ctx, key);
+
+	/* The CBC-MAC chains do not depend on each other: the blocks of
+	 * up to _CMAC_LANES messages at the same offset are encrypted
+	 * together, which keeps the AES pipeline (or both bitsliced lanes)
+	 * busy.
+	 */
+	for (size_t first = 0; first < count; first += _CMAC_LANES) {
+		size_t lanes = HUBBLE_MIN(count - first, _CMAC_LANES);
+		size_t pending = lanes;
+		size_t off = 0;
+
+		memset(state, 0, sizeof(state));
+
+		while (pending > 0) {
+			size_t lane[_CMAC_LANES];
+			size_t n = 0;
+
+			for (size_t l = 0; l < lanes; l++) {
+				const uint8_t *in = data[first + l] + off;
+				size_t end = _cmac_last_offset(len[first + l]);
+
+				if (off > end) {
+					/* Already done */
+					continue;
+				}
+
+				if (off == end) {
+					_cmac_last_block(&ctx, in,
+							 len[first + l] - off,
+							 last);
+					in = last;
+					pending--;
+				}
+
+				_xor_block(blocks[n], state[l], in);
+				lane[n++] = l;
+			}
+
+			_aes_encrypt_blocks(&ctx.aes, blocks[0], blocks[0], n);
+
+			for (size_t i = 0; i < n; i++) {
+				memcpy(state[lane[i]], blocks[i],
+				       HUBBLE_AES_BLOCK_SIZE);
+			}
+
+			off += HUBBLE_AES_BLOCK_SIZE;
+		}
+
+		memcpy(output[first], state, lanes * HUBBLE_AES_BLOCK_SIZE);
+	}
+
+	_cmac_clear(&ctx);
+	hubble_crypto_zeroize(state, sizeof(state));
+	hubble_crypto_zeroize(blocks, sizeof(blocks));
+	hubble_crypto_zeroize(last, sizeof(last));
+
+	return 0;
+}
+
+int hubble_crypto_ctr_cmac(const uint8_t key[CONFIG_HUBBLE_KEY_SIZE],
+			   uint8_t nonce_counter[HUBBLE_NONCE_BUFFER_SIZE],
+			   const uint8_t *data, size_t len, uint8_t *output,
+			   uint8_t tag[HUBBLE_AES_BLOCK_SIZE])
+{
+	struct _cmac_ctx ctx;
+	uint8_t stream[_CTR_BLOCKS * HUBBLE_AES_BLOCK_SIZE];
+	size_t stream_len = 0;
+	size_t stream_off = 0;
+
+	/* A single key schedule for both the encryption and the tag */
+	_cmac_init(&ctx, key);
+
+	/* Encrypt and authenticate block by block, the last (possibly
+	 * partial) block is left for _cmac_finish().
+	 */
+	while (len > 0) {
+		size_t n = HUBBLE_MIN(len, HUBBLE_AES_BLOCK_SIZE);
+
+		if (stream_off == stream_len) {
+			size_t blocks = _ctr_blocks(len);
+
+			_ctr_stream(&ctx.aes, nonce_counter, stream, blocks);
+			stream_len = blocks * HUBBLE_AES_BLOCK_SIZE;
+			stream_off = 0;
+		}
+
+		for (size_t i = 0; i < n; i++) {
+			output[i] = data[i] ^ stream[stream_off + i];
+		}
+		stream_off += HUBBLE_AES_BLOCK_SIZE;
+
+		if (len == n) {
+			break;
+		}
+
+		_cmac_update_block(&ctx, output);
+		data += n;
+		output += n;
+		len -= n;
+	}
+
+	_cmac_finish(&ctx, output, len, tag);
+
+	_cmac_clear(&ctx);
+	hubble_crypto_zeroize(stream, sizeof(stream));
+
+	return 0;
+}
@@ -16,6 +16,8 @@
 #include <hubble/port/sys.h>
 #include <hubble/port/crypto.h>
 
+#include "hubble_priv.h"
+
 static uint64_t utc_time_synced;
 static uint64_t utc_time_base;
 
@@ -30,6 +32,9 @@ int hubble_utc_set(uint64_t utc_time)
 
 	utc_time_base = utc_time - hubble_uptime_get();
 
+	/* The time counter may have moved */
+	hubble_internal_day_state_clear();
+
 	return 0;
 }
 
@@ -22,7 +22,6 @@
 #define HUBBLE_BLE_ADVERTISE_PREFIX 2
 #define HUBBLE_BLE_PROTOCOL_VERSION 0b000000
 #define HUBBLE_BLE_ADDR_SIZE        6
-#define HUBBLE_BLE_AUTH_TAG_SIZE    4U
 #define HUBBLE_BLE_ADV_FIELDS_SIZE                                             \
 	(HUBBLE_BLE_ADVERTISE_PREFIX + HUBBLE_BLE_ADDR_SIZE +                  \
 	 HUBBLE_BLE_AUTH_TAG_SIZE)
@@ -100,3 +99,517 @@ int hubble_ble_advertise_get(const uint8_t *input, size_t input_len,
 
 	return err;
 }
+
+int hubble_ble_advertise_batch_get(const uint8_t *input, size_t input_len,
+				   uint16_t seq_no, size_t count,
+				   uint8_t out[][HUBBLE_BLE_ADV_FRAME_SIZE],
+				   size_t *out_len)
+{
+	int err = 0;
+	struct hubble_internal_day_keys keys;
+	uint32_t time_counter = hubble_internal_time_counter_get();
+
+	if ((hubble_internal_key_get() == NULL) || (out == NULL) ||
+	    (out_len == NULL)) {
+		return -EINVAL;
+	}
+
+	if ((input == NULL) && (input_len > 0)) {
+		return -EINVAL;
+	}
+
+	if (input_len > HUBBLE_BLE_MAX_DATA_LEN) {
+		return -EINVAL;
+	}
+
+	if ((seq_no > HUBBLE_MAX_SEQ_COUNTER) || (count == 0U) ||
+	    (count > (HUBBLE_MAX_SEQ_COUNTER + 1U))) {
+		return -EINVAL;
+	}
+
+	if (!hubble_internal_nonce_range_check(time_counter, seq_no, count)) {
+		HUBBLE_LOG_WARNING("Re-using same nonce is insecure !");
+		return -EPERM;
+	}
+
+	/* Day-level keys (and device ID) are shared by the whole batch */
+	err = hubble_internal_day_keys_get(time_counter, &keys);
+	if (err) {
+		return err;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		uint8_t *frame = out[i];
+		uint16_t seq = (seq_no + i) % (HUBBLE_MAX_SEQ_COUNTER + 1U);
+
+		*_PAYLOAD_SERVICE_UUID_LO(frame) =
+			HUBBLE_LO_UINT16(HUBBLE_BLE_UUID);
+		*_PAYLOAD_SERVICE_UUID_HI(frame) =
+			HUBBLE_HI_UINT16(HUBBLE_BLE_UUID);
+
+		_addr_set(_PAYLOAD_ADDR(frame), seq, keys.device_id);
+
+		err = hubble_internal_data_encrypt_with_keys(
+			&keys, seq, input, input_len, _PAYLOAD_DATA(frame),
+			_PAYLOAD_AUTH_TAG(frame), HUBBLE_BLE_AUTH_TAG_SIZE);
+		if (err) {
+			goto exit;
+		}
+	}
+
+	*out_len = HUBBLE_BLE_ADV_FIELDS_SIZE + input_len;
+
+exit:
+	hubble_crypto_zeroize(&keys, sizeof(keys));
+	return err;
+}
+
+#ifdef CONFIG_HUBBLE_BLE_NETWORK_DECODER
+_Static_assert(HUBBLE_BLE_DECODER_NONCE_SIZE == HUBBLE_NONCE_BUFFER_SIZE,
+	       "decoder nonce memo does not match the crypto nonce size");
+
+int hubble_ble_frame_parse(const uint8_t *adv, size_t adv_len,
+			   struct hubble_ble_frame *frame)
+{
+	const uint8_t *addr;
+
+	if ((adv == NULL) || (frame == NULL)) {
+		return -EINVAL;
+	}
+
+	if ((adv_len < HUBBLE_BLE_ADV_FIELDS_SIZE) ||
+	    (adv_len >
+	     (HUBBLE_BLE_ADV_FIELDS_SIZE + HUBBLE_BLE_MAX_DATA_LEN))) {
+		return -EINVAL;
+	}
+
+	if ((*_PAYLOAD_SERVICE_UUID_LO(adv) !=
+	     HUBBLE_LO_UINT16(HUBBLE_BLE_UUID)) ||
+	    (*_PAYLOAD_SERVICE_UUID_HI(adv) !=
+	     HUBBLE_HI_UINT16(HUBBLE_BLE_UUID))) {
+		return -EINVAL;
+	}
+
+	/* Reverse of _addr_set() */
+	addr = _PAYLOAD_ADDR(adv);
+	frame->version = addr[0] >> 2;
+	frame->seq_no = ((uint16_t)(addr[0] & 0x03) << 8) | addr[1];
+	memcpy(&frame->eid, addr + 2, sizeof(frame->eid));
+
+	frame->auth_tag = _PAYLOAD_AUTH_TAG(adv);
+	frame->data = _PAYLOAD_DATA(adv);
+	frame->data_len = adv_len - HUBBLE_BLE_ADV_FIELDS_SIZE;
+
+	return 0;
+}
+
+void hubble_ble_decoder_init(struct hubble_ble_decoder *decoder)
+{
+	memset(decoder, 0, sizeof(*decoder));
+}
+
+void hubble_ble_decoder_clear(struct hubble_ble_decoder *decoder)
+{
+	hubble_crypto_zeroize(decoder, sizeof(*decoder));
+}
+
+static struct hubble_ble_decoder_day *
+_decoder_day_get(struct hubble_ble_decoder *decoder, const void *key,
+		 uint32_t time_counter, int *err)
+{
+	struct hubble_internal_day_keys keys;
+	struct hubble_ble_decoder_day *victim = &decoder->days[0];
+
+	for (size_t i = 0; i < HUBBLE_ARRAY_SIZE(decoder->days); i++) {
+		struct hubble_ble_decoder_day *day = &decoder->days[i];
+
+		if ((day->key == key) && (day->time_counter == time_counter)) {
+			day->last_used = ++decoder->clock;
+			return day;
+		}
+
+		/* Least recently used, free slots have last_used 0 */
+		if (day->last_used < victim->last_used) {
+			victim = day;
+		}
+	}
+
+	*err = hubble_internal_key_day_keys_get(key, time_counter, &keys);
+	if (*err != 0) {
+		return NULL;
+	}
+
+	victim->key = key;
+	victim->time_counter = time_counter;
+	victim->device_id = keys.device_id;
+	victim->last_used = ++decoder->clock;
+	memcpy(victim->nonce_key, keys.nonce_key, sizeof(victim->nonce_key));
+	memcpy(victim->encryption_key, keys.encryption_key,
+	       sizeof(victim->encryption_key));
+
+	hubble_crypto_zeroize(&keys, sizeof(keys));
+
+	return victim;
+}
+
+/* Returns the entry of (key, time counter, sequence number), or NULL
+ * and the least recently used entry in victim.
+ */
+static struct hubble_ble_decoder_seq *
+_decoder_seq_find(struct hubble_ble_decoder *decoder, const void *key,
+		  uint32_t time_counter, uint16_t seq_no,
+		  struct hubble_ble_decoder_seq **victim)
+{
+	*victim = &decoder->seqs[0];
+
+	for (size_t i = 0; i < HUBBLE_ARRAY_SIZE(decoder->seqs); i++) {
+		struct hubble_ble_decoder_seq *seq = &decoder->seqs[i];
+
+		if ((seq->key == key) && (seq->time_counter == time_counter) &&
+		    (seq->seq_no == seq_no)) {
+			seq->last_used = ++decoder->clock;
+			return seq;
+		}
+
+		if (seq->last_used < (*victim)->last_used) {
+			*victim = seq;
+		}
+	}
+
+	return NULL;
+}
+
+/* Takes over an entry, its keys are derived by the caller */
+static void _decoder_seq_reserve(struct hubble_ble_decoder *decoder,
+				 struct hubble_ble_decoder_seq *seq,
+				 const void *key, uint32_t time_counter,
+				 uint32_t device_id, uint16_t seq_no)
+{
+	seq->key = key;
+	seq->time_counter = time_counter;
+	seq->device_id = device_id;
+	seq->seq_no = seq_no;
+	seq->adv_len = 0U;
+	seq->last_used = ++decoder->clock;
+}
+
+static void _decoder_seq_release(struct hubble_ble_decoder_seq *seq)
+{
+	seq->key = NULL;
+	seq->last_used = 0U;
+	hubble_crypto_zeroize(seq->nonce_counter, sizeof(seq->nonce_counter));
+	hubble_crypto_zeroize(seq->encryption_key,
+			      sizeof(seq->encryption_key));
+}
+
+/* Day of the frame, NULL if it cannot be derived or if the frame was not
+ * built with this key.
+ */
+static struct hubble_ble_decoder_day *
+_decoder_frame_day_get(struct hubble_ble_decoder *decoder, const void *key,
+		       uint32_t time_counter,
+		       const struct hubble_ble_frame *frame, int *err)
+{
+	struct hubble_ble_decoder_day *day;
+
+	day = _decoder_day_get(decoder, key, time_counter, err);
+	if (day == NULL) {
+		return NULL;
+	}
+
+	/* Not worth deriving anything for a device ID of another key */
+	if (day->device_id != frame->eid) {
+		*err = -EBADMSG;
+		return NULL;
+	}
+
+	return day;
+}
+
+static struct hubble_ble_decoder_seq *
+_decoder_seq_get(struct hubble_ble_decoder *decoder, const void *key,
+		 uint32_t time_counter, const struct hubble_ble_frame *frame,
+		 int *err)
+{
+	struct hubble_ble_decoder_day *day;
+	struct hubble_ble_decoder_seq *seq;
+	struct hubble_ble_decoder_seq *victim;
+
+	seq = _decoder_seq_find(decoder, key, time_counter, frame->seq_no,
+				&victim);
+	if (seq != NULL) {
+		return seq;
+	}
+
+	day = _decoder_frame_day_get(decoder, key, time_counter, frame, err);
+	if (day == NULL) {
+		return NULL;
+	}
+
+	_decoder_seq_reserve(decoder, victim, key, time_counter,
+			     day->device_id, frame->seq_no);
+
+	*err = hubble_internal_seq_keys_get(day->nonce_key, day->encryption_key,
+					    frame->seq_no,
+					    victim->nonce_counter,
+					    victim->encryption_key);
+	if (*err != 0) {
+		_decoder_seq_release(victim);
+		return NULL;
+	}
+
+	return victim;
+}
+
+static int _decoder_frame_check(const uint8_t *adv, size_t adv_len,
+				struct hubble_ble_frame *frame)
+{
+	int err;
+
+	err = hubble_ble_frame_parse(adv, adv_len, frame);
+	if (err != 0) {
+		return err;
+	}
+
+	if (frame->version != HUBBLE_BLE_PROTOCOL_VERSION) {
+		return -ENOTSUP;
+	}
+
+	return 0;
+}
+
+/* Authenticates and decrypts a frame with the keys of its entry */
+static int _decoder_frame_open(struct hubble_ble_decoder_seq *seq,
+			       const struct hubble_ble_frame *frame,
+			       const uint8_t *adv, size_t adv_len,
+			       uint8_t *out, size_t *out_len)
+{
+	int err;
+
+	if (frame->eid != seq->device_id) {
+		return -EBADMSG;
+	}
+
+	/* Same advertisement received again */
+	if ((seq->adv_len == adv_len) &&
+	    (memcmp(seq->adv, adv, adv_len) == 0)) {
+		memcpy(out, seq->plaintext, frame->data_len);
+		*out_len = frame->data_len;
+		return 0;
+	}
+
+	err = hubble_internal_data_decrypt_with_seq_keys(
+		seq->encryption_key, seq->nonce_counter, frame->data,
+		frame->data_len, frame->auth_tag, HUBBLE_BLE_AUTH_TAG_SIZE,
+		out);
+	if (err != 0) {
+		return err;
+	}
+
+	memcpy(seq->adv, adv, adv_len);
+	seq->adv_len = (uint8_t)adv_len;
+	memcpy(seq->plaintext, out, frame->data_len);
+
+	*out_len = frame->data_len;
+
+	return 0;
+}
+
+int hubble_ble_decode(struct hubble_ble_decoder *decoder, const void *key,
+		      uint32_t time_counter, const uint8_t *adv,
+		      size_t adv_len, uint8_t *out, size_t *out_len)
+{
+	int err;
+	struct hubble_ble_frame frame;
+	struct hubble_ble_decoder_seq *seq;
+
+	if ((decoder == NULL) || (key == NULL) || (out == NULL) ||
+	    (out_len == NULL)) {
+		return -EINVAL;
+	}
+
+	err = _decoder_frame_check(adv, adv_len, &frame);
+	if (err != 0) {
+		return err;
+	}
+
+	seq = _decoder_seq_get(decoder, key, time_counter, &frame, &err);
+	if (seq == NULL) {
+		return err;
+	}
+
+	return _decoder_frame_open(seq, &frame, adv, adv_len, out, out_len);
+}
+
+/* Jobs in flight at once. Each one may take over an entry before the
+ * keys are derived, so there must be enough entries for all of them.
+ */
+#define _DECODE_WINDOW                                                         \
+	HUBBLE_MIN(8U, CONFIG_HUBBLE_BLE_NETWORK_DECODER_SEQ_SLOTS)
+
+/* First stage: parse the frame and find its entry, or take one over and
+ * leave its keys to derive.
+ */
+static struct hubble_ble_decoder_seq *
+_decode_job_start(struct hubble_ble_decoder *decoder,
+		  struct hubble_ble_decode_job *job,
+		  struct hubble_ble_frame *frame, bool *pending)
+{
+	struct hubble_ble_decoder_seq *seq;
+	struct hubble_ble_decoder_seq *victim;
+	struct hubble_ble_decoder_day *day;
+
+	*pending = false;
+
+	if ((decoder == NULL) || (job->key == NULL)) {
+		job->err = -EINVAL;
+		return NULL;
+	}
+
+	job->err = _decoder_frame_check(job->adv, job->adv_len, frame);
+	if (job->err != 0) {
+		return NULL;
+	}
+
+	seq = _decoder_seq_find(decoder, job->key, job->time_counter,
+				frame->seq_no, &victim);
+	if (seq != NULL) {
+		return seq;
+	}
+
+	day = _decoder_frame_day_get(decoder, job->key, job->time_counter,
+				     frame, &job->err);
+	if (day == NULL) {
+		return NULL;
+	}
+
+	_decoder_seq_reserve(decoder, victim, job->key, job->time_counter,
+			     day->device_id, frame->seq_no);
+	*pending = true;
+
+	return victim;
+}
+
+/* Second stage: derive the keys of the entries taken over, with one
+ * call per day for all its sequence numbers.
+ */
+static void _decode_window_derive(struct hubble_ble_decoder *decoder,
+				  struct hubble_ble_decode_job *jobs,
+				  struct hubble_ble_frame *frames,
+				  struct hubble_ble_decoder_seq **seqs,
+				  bool *pending, size_t count)
+{
+	int err;
+	uint16_t seq_nos[_DECODE_WINDOW];
+	uint8_t *nonce_counters[_DECODE_WINDOW];
+	uint8_t *keys[_DECODE_WINDOW];
+	struct hubble_ble_decoder_seq *derived[_DECODE_WINDOW];
+	struct hubble_ble_decoder_day *day;
+
+	for (size_t i = 0; i < count; i++) {
+		size_t n = 0U;
+
+		if (!pending[i]) {
+			continue;
+		}
+
+		for (size_t j = i; j < count; j++) {
+			if (!pending[j] || (jobs[j].key != jobs[i].key) ||
+			    (jobs[j].time_counter != jobs[i].time_counter)) {
+				continue;
+			}
+
+			seq_nos[n] = frames[j].seq_no;
+			nonce_counters[n] = seqs[j]->nonce_counter;
+			keys[n] = seqs[j]->encryption_key;
+			derived[n] = seqs[j];
+			pending[j] = false;
+			n++;
+		}
+
+		/* Found in the first stage, unless evicted by another day */
+		day = _decoder_day_get(decoder, jobs[i].key,
+				       jobs[i].time_counter, &err);
+		if (day != NULL) {
+			err = hubble_internal_seq_keys_multi_get(
+				day->nonce_key, day->encryption_key, seq_nos,
+				n, nonce_counters, keys);
+		}
+
+		if (err == 0) {
+			continue;
+		}
+
+		/* Fail every job relying on these entries */
+		for (size_t k = 0; k < n; k++) {
+			for (size_t j = 0; j < count; j++) {
+				if (seqs[j] == derived[k]) {
+					seqs[j] = NULL;
+					jobs[j].err = err;
+				}
+			}
+
+			_decoder_seq_release(derived[k]);
+		}
+	}
+}
+
+size_t hubble_ble_decode_batch(struct hubble_ble_decoder *decoder,
+			       struct hubble_ble_decode_job *jobs,
+			       size_t count)
+{
+	size_t decoded = 0U;
+	struct hubble_ble_frame frames[_DECODE_WINDOW];
+	struct hubble_ble_decoder_seq *seqs[_DECODE_WINDOW];
+	bool pending[_DECODE_WINDOW];
+
+	if (jobs == NULL) {
+		return 0U;
+	}
+
+	for (size_t first = 0; first < count; first += _DECODE_WINDOW) {
+		struct hubble_ble_decode_job *window = &jobs[first];
+		size_t n = HUBBLE_MIN(count - first, _DECODE_WINDOW);
+
+		for (size_t i = 0; i < n; i++) {
+			seqs[i] = _decode_job_start(decoder, &window[i],
+						    &frames[i], &pending[i]);
+		}
+
+		_decode_window_derive(decoder, window, frames, seqs, pending,
+				      n);
+
+		/* Last stage: authenticate and decrypt */
+		for (size_t i = 0; i < n; i++) {
+			struct hubble_ble_decode_job *job = &window[i];
+
+			if (seqs[i] == NULL) {
+				continue;
+			}
+
+			job->err = _decoder_frame_open(seqs[i], &frames[i],
+						       job->adv, job->adv_len,
+						       job->data,
+						       &job->data_len);
+			if (job->err == 0) {
+				decoded++;
+			}
+		}
+	}
+
+	return decoded;
+}
+#endif /* CONFIG_HUBBLE_BLE_NETWORK_DECODER */
+
+#ifdef CONFIG_HUBBLE_BLE_NETWORK_PRECOMPUTE
+int hubble_ble_advertise_precompute(uint16_t seq_no, uint8_t count)
+{
+	if ((hubble_internal_key_get() == NULL) ||
+	    (seq_no > HUBBLE_MAX_SEQ_COUNTER)) {
+		return -EINVAL;
+	}
+
+	return hubble_internal_precompute(hubble_internal_time_counter_get(),
+					  seq_no, count);
+}
+#endif /* CONFIG_HUBBLE_BLE_NETWORK_PRECOMPUTE */
@@ -4,12 +4,11 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 #include <errno.h>
-#include <inttypes.h>
 #include <stdbool.h>
 #include <stdint.h>
-#include <stdio.h>
 #include <string.h>
 
+#include <hubble/sat/packet.h>
 #include <hubble/port/sat_radio.h>
 #include <hubble/port/sys.h>
 #include <hubble/port/crypto.h>
@@ -18,11 +17,22 @@
 #include "utils/macros.h"
 
 
-#define _MESSAGE_SIZE  64U
-#define _CONTEXT_SIZE  12U
+/* Longest template (18) + context (10) + length (4) */
+#define _MESSAGE_SIZE  32U
+/* Decimal digits of UINT32_MAX */
+#define _CONTEXT_SIZE  10U
 #define _NONCE_SIZE    12U
 #define _AUTH_TAG_SIZE 16U
 
+#ifdef CONFIG_HUBBLE_NETWORK_CRYPTO_CMAC_MULTI
+/* KBKDF iterations handed at once to the crypto provider: every block
+ * of the three day keys (at most 6), or the values of several packets.
+ */
+#define _KBKDF_MESSAGES 8U
+#else
+#define _KBKDF_MESSAGES 1U
+#endif
+
 #if defined(CONFIG_HUBBLE_NETWORK_TIMER_COUNTER_DAILY)
 #define _TIMER_COUNTER_FREQUENCY 86400000UL
 #else
@@ -32,17 +42,160 @@
 enum hubble_key_label {
 	HUBBLE_DEVICE_KEY,
 	HUBBLE_NONCE_KEY,
-	HUBBLE_ENCRYPTION_KEY
+	HUBBLE_ENCRYPTION_KEY,
+	/* Number of key labels (internal use) */
+	HUBBLE_KEY_LABEL_COUNT,
 };
 
 enum hubble_value_label {
 	HUBBLE_DEVICE_VALUE,
 	HUBBLE_NONCE_VALUE,
-	HUBBLE_ENCRYPTION_VALUE
+	HUBBLE_ENCRYPTION_VALUE,
+	/* Number of value labels (internal use) */
+	HUBBLE_VALUE_LABEL_COUNT,
+};
+
+/* Fixed beginning of a KBKDF message: the counter (starting at 1, big
+ * endian), the label and the separation byte, which is the string
+ * terminator. It is built at compile time.
+ */
+struct _kbkdf_template {
+	const uint8_t *data;
+	uint8_t len;
+};
+
+#define _KBKDF_TEMPLATE(_label)                                                \
+	{                                                                      \
+		.data = (const uint8_t *)("\x00\x00\x00\x01" _label),          \
+		.len = sizeof("\x00\x00\x00\x01" _label),                      \
+	}
+
+static const struct _kbkdf_template _key_templates[HUBBLE_KEY_LABEL_COUNT] = {
+	[HUBBLE_DEVICE_KEY] = _KBKDF_TEMPLATE("DeviceKey"),
+	[HUBBLE_NONCE_KEY] = _KBKDF_TEMPLATE("NonceKey"),
+	[HUBBLE_ENCRYPTION_KEY] = _KBKDF_TEMPLATE("EncryptionKey"),
+};
+
+static const struct _kbkdf_template
+	_value_templates[HUBBLE_VALUE_LABEL_COUNT] = {
+		[HUBBLE_DEVICE_VALUE] = _KBKDF_TEMPLATE("DeviceID"),
+		[HUBBLE_NONCE_VALUE] = _KBKDF_TEMPLATE("Nonce"),
+		[HUBBLE_ENCRYPTION_VALUE] = _KBKDF_TEMPLATE("Key"),
 };
 
 static const void *master_key;
 
+#ifdef CONFIG_HUBBLE_NETWORK_KEY_CACHE
+/* Keys and the device ID derived from the master key only change when
+ * the time counter rolls over, so they are kept here and reused for
+ * every advertisement and packet built in the same period.
+ */
+static struct {
+	uint32_t time_counter;
+	/* Bitmask of the labels (enum hubble_key_label) already derived.
+	 * The bit after the last label tells whether device_id is valid.
+	 */
+	uint8_t valid;
+	uint8_t keys[HUBBLE_KEY_LABEL_COUNT][CONFIG_HUBBLE_KEY_SIZE];
+	uint32_t device_id;
+} _day_state;
+
+#define _DAY_STATE_DEVICE_ID_VALID HUBBLE_BIT(HUBBLE_KEY_LABEL_COUNT)
+
+static void _day_state_clear(void)
+{
+	hubble_crypto_zeroize(&_day_state, sizeof(_day_state));
+}
+
+/* Drops everything derived for a previous time counter */
+static void _day_state_sync(uint32_t time_counter)
+{
+	if ((_day_state.valid != 0U) &&
+	    (_day_state.time_counter != time_counter)) {
+		_day_state_clear();
+		hubble_crypto_keys_release();
+	}
+
+	_day_state.time_counter = time_counter;
+}
+#endif /* CONFIG_HUBBLE_NETWORK_KEY_CACHE */
+
+#ifdef CONFIG_HUBBLE_BLE_NETWORK_PRECOMPUTE
+/* Values pre-computed for a given time counter and sequence number.
+ *
+ * Slots are filled by hubble_internal_precompute(), usually from a
+ * lower priority context than the one building advertisements, and
+ * consumed by hubble_internal_data_encrypt(). The producer sets @a ready
+ * only after everything else was written, so a consumer preempting it
+ * never uses a partially written slot.
+ */
+struct _precomputed_slot {
+	volatile bool ready;
+	uint8_t generation;
+	uint16_t seq_no;
+	uint32_t time_counter;
+	uint32_t device_id;
+	uint8_t nonce_counter[HUBBLE_NONCE_BUFFER_SIZE];
+	uint8_t encryption_key[CONFIG_HUBBLE_KEY_SIZE];
+	/* Authentication tag of an empty payload */
+	uint8_t empty_tag[_AUTH_TAG_SIZE];
+};
+
+static struct _precomputed_slot
+	_precomputed[CONFIG_HUBBLE_BLE_NETWORK_PRECOMPUTE_SLOTS];
+
+/* Incremented every time the day state is cleared. Slots filled with
+ * an older generation (e.g. a previous key) are never used.
+ */
+static volatile uint8_t _precomputed_generation;
+
+static void _precomputed_slot_clear(struct _precomputed_slot *slot)
+{
+	slot->ready = false;
+	HUBBLE_COMPILER_BARRIER();
+	hubble_crypto_zeroize(slot->nonce_counter, sizeof(slot->nonce_counter));
+	hubble_crypto_zeroize(slot->encryption_key,
+			      sizeof(slot->encryption_key));
+	hubble_crypto_zeroize(slot->empty_tag, sizeof(slot->empty_tag));
+}
+
+static struct _precomputed_slot *_precomputed_slot_find(uint32_t time_counter,
+							uint16_t seq_no)
+{
+	struct _precomputed_slot *slot =
+		&_precomputed[seq_no % HUBBLE_ARRAY_SIZE(_precomputed)];
+
+	if (slot->ready && (slot->generation == _precomputed_generation) &&
+	    (slot->time_counter == time_counter) && (slot->seq_no == seq_no)) {
+		return slot;
+	}
+
+	return NULL;
+}
+
+static bool _precomputed_device_id_get(uint32_t time_counter,
+				       uint32_t *device_id)
+{
+	for (size_t i = 0; i < HUBBLE_ARRAY_SIZE(_precomputed); i++) {
+		struct _precomputed_slot *slot = &_precomputed[i];
+
+		if (slot->ready &&
+		    (slot->generation == _precomputed_generation) &&
+		    (slot->time_counter == time_counter)) {
+			*device_id = slot->device_id;
+			return true;
+		}
+	}
+
+	return false;
+}
+#endif /* CONFIG_HUBBLE_BLE_NETWORK_PRECOMPUTE */
+
+/* Providers that do not keep any key do not need to implement it */
+HUBBLE_WEAK void hubble_crypto_keys_release(void)
+{
+}
+
 const void *hubble_internal_key_get(void)
 {
 	return master_key;
@@ -56,9 +209,27 @@ int hubble_key_set(const void *key)
 
 	master_key = key;
 
+	hubble_internal_day_state_clear();
+
 	return 0;
 }
 
+void hubble_internal_day_state_clear(void)
+{
+#ifdef CONFIG_HUBBLE_NETWORK_KEY_CACHE
+	_day_state_clear();
+#endif
+
+	hubble_crypto_keys_release();
+
+#ifdef CONFIG_HUBBLE_BLE_NETWORK_PRECOMPUTE
+	_precomputed_generation++;
+	for (size_t i = 0; i < HUBBLE_ARRAY_SIZE(_precomputed); i++) {
+		_precomputed_slot_clear(&_precomputed[i]);
+	}
+#endif
+}
+
 uint32_t hubble_internal_time_counter_get(void)
 {
 	return hubble_internal_utc_time_get() / _TIMER_COUNTER_FREQUENCY;
@@ -78,19 +249,19 @@ uint16_t hubble_sequence_counter_get(void)
 }
 #endif /* CONFIG_HUBBLE_NETWORK_SEQUENCE_NONCE_CUSTOM */
 
-/**
- * Returns true if the time_counter and seq_no are unique (not reused)
- * or false otherwise.
- * This assumes that the sequence is incremental. Wrapping is allowed.
- */
-bool hubble_internal_nonce_values_check(uint32_t time_counter, uint16_t seq_no)
-{
 #ifdef CONFIG_HUBBLE_NETWORK_SECURITY_ENFORCE_NONCE_CHECK
-	static bool _check_seq_no_wrapped;
-	static uint32_t _check_time_counter;
-	static uint16_t _check_seq_no;
-	static uint16_t _check_seq_daily_reference_no;
+struct _nonce_check_state {
+	bool seq_no_wrapped;
+	uint32_t time_counter;
+	uint16_t seq_no;
+	uint16_t seq_daily_reference_no;
+};
+
+static struct _nonce_check_state _nonce_check;
 
+static bool _nonce_state_update(struct _nonce_check_state *state,
+				uint32_t time_counter, uint16_t seq_no)
+{
 	if (seq_no > HUBBLE_MAX_SEQ_COUNTER) {
 		return false;
 	}
@@ -99,11 +270,12 @@ bool hubble_internal_nonce_values_check(uint32_t time_counter, uint16_t seq_no)
 	 * We just need to update our daily reference for checking for
 	 * sequence wrapper.
 	 */
-	if ((_check_time_counter == 0U) || (_check_time_counter != time_counter)) {
-		_check_seq_daily_reference_no = seq_no;
-		_check_seq_no_wrapped = false;
-		_check_time_counter = time_counter;
-		_check_seq_no = seq_no;
+	if ((state->time_counter == 0U) ||
+	    (state->time_counter != time_counter)) {
+		state->seq_daily_reference_no = seq_no;
+		state->seq_no_wrapped = false;
+		state->time_counter = time_counter;
+		state->seq_no = seq_no;
 		return true;
 	}
 
@@ -111,89 +283,186 @@ bool hubble_internal_nonce_values_check(uint32_t time_counter, uint16_t seq_no)
 	 * if it wrapped we need to ensure that this is not bigger
 	 * than the first value used with the current time counter.
 	 */
-	if ((_check_seq_no == seq_no) ||
-	    (_check_seq_no_wrapped && (seq_no >= _check_seq_daily_reference_no))) {
+	if ((state->seq_no == seq_no) ||
+	    (state->seq_no_wrapped &&
+	     (seq_no >= state->seq_daily_reference_no))) {
 		return false;
 	}
 
 	/* At this point the sequence is not the same but we need to check if it just wrapped. */
-	if (_check_seq_no > seq_no) {
-		_check_seq_no_wrapped = true;
+	if (state->seq_no > seq_no) {
+		state->seq_no_wrapped = true;
 		/* That is the first sequence number after wrapping, lets ensure
 		 * that it is not bigger than the daily reference.
 		 */
-		if (seq_no >= _check_seq_daily_reference_no) {
+		if (seq_no >= state->seq_daily_reference_no) {
 			return false;
 		}
 	}
 
-	_check_seq_no = seq_no;
+	state->seq_no = seq_no;
 
+	return true;
+}
 #endif /* CONFIG_HUBBLE_NETWORK_SECURITY_ENFORCE_NONCE_CHECK */
+
+/**
+ * Returns true if the time_counter and seq_no are unique (not reused)
+ * or false otherwise.
+ * This assumes that the sequence is incremental. Wrapping is allowed.
+ */
+bool hubble_internal_nonce_values_check(uint32_t time_counter, uint16_t seq_no)
+{
+#ifdef CONFIG_HUBBLE_NETWORK_SECURITY_ENFORCE_NONCE_CHECK
+	return _nonce_state_update(&_nonce_check, time_counter, seq_no);
+#else
 	return true;
+#endif /* CONFIG_HUBBLE_NETWORK_SECURITY_ENFORCE_NONCE_CHECK */
 }
 
-static int _kbkdf_counter(const uint8_t *key, const char *label,
-			  size_t label_len, const uint8_t *context,
-			  size_t context_len, uint8_t *output, size_t olen)
+bool hubble_internal_nonce_range_check(uint32_t time_counter, uint16_t seq_no,
+				       size_t count)
 {
-	int ret = 0;
-	uint8_t prf_output[HUBBLE_AES_BLOCK_SIZE];
-	uint8_t message[_MESSAGE_SIZE];
-	uint32_t counter = 1U;
-	uint32_t total = 0U;
-	uint8_t separation_byte = 0x00;
-
-	/* Message format: Counter + Label + Context + Length (in bits) */
-	uint32_t message_length = sizeof(counter) + label_len +
-				  sizeof(separation_byte) + context_len +
-				  sizeof(uint32_t);
-
-	/* Check for message length overflow */
-	if (message_length >= sizeof(message)) {
-		ret = -EINVAL;
-		goto exit;
+#ifdef CONFIG_HUBBLE_NETWORK_SECURITY_ENFORCE_NONCE_CHECK
+	/* Work on a copy so nothing is consumed if the range is rejected */
+	struct _nonce_check_state state = _nonce_check;
+
+	/* More than one full sequence wrap always reuses a nonce */
+	if ((count == 0U) || (count > (HUBBLE_MAX_SEQ_COUNTER + 1U))) {
+		return false;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		if (!_nonce_state_update(
+			    &state, time_counter,
+			    (seq_no + i) % (HUBBLE_MAX_SEQ_COUNTER + 1U))) {
+			return false;
+		}
+	}
+
+	_nonce_check = state;
+#else
+	(void)time_counter;
+	(void)seq_no;
+	(void)count;
+#endif /* CONFIG_HUBBLE_NETWORK_SECURITY_ENFORCE_NONCE_CHECK */
+	return true;
+}
+
+/* Decimal representation (no terminator) of value, as the KBKDF context.
+ * Returns the number of digits.
+ */
+static size_t _context_encode(uint32_t value, uint8_t out[_CONTEXT_SIZE])
+{
+	uint8_t digits[_CONTEXT_SIZE];
+	size_t len = 0;
+
+	do {
+		digits[len++] = (uint8_t)('0' + (value % 10U));
+		value /= 10U;
+	} while (value != 0U);
+
+	for (size_t i = 0; i < len; i++) {
+		out[i] = digits[len - 1 - i];
 	}
 
-	/* Prepare the message with Label, Context, and bit size */
-
-	/* Copy label after the counter */
-	memcpy((message + sizeof(counter)), label, label_len);
-	/* Separation byte (as defined by the standard) */
-	message[sizeof(counter) + label_len] = separation_byte;
-	/* Copy the context */
-	memcpy((message + sizeof(counter) + label_len + sizeof(separation_byte)),
-	       context, context_len);
-	/* Length in bits at the end */
-	memcpy((message + sizeof(counter) + label_len +
-		sizeof(separation_byte) + context_len),
-	       (uint8_t *)&(uint32_t){
-		       HUBBLE_CPU_TO_BE32(olen * HUBBLE_BITS_PER_BYTE)},
-	       sizeof(uint32_t));
-
-	while (total < olen) {
-		size_t remaining = olen - total;
-
-		/* Insert counter into the message */
-		memcpy(message,
-		       (uint8_t *)&(uint32_t){HUBBLE_CPU_TO_BE32(counter)},
-		       sizeof(counter));
-
-		/* Perform AES-CMAC with the key and the prepared message */
-		ret = hubble_crypto_cmac(key, message, message_length,
-					 prf_output);
+	return len;
+}
+
+/* Message format: Counter + Label + 0x00 + Context + Length (in bits)
+ * Counter, label and separation byte come from the template.
+ * Returns the message length.
+ */
+static size_t _kbkdf_message(const struct _kbkdf_template *template,
+			     uint32_t counter, uint32_t context,
+			     uint32_t olen_bits, uint8_t message[_MESSAGE_SIZE])
+{
+	size_t message_length;
+
+	memcpy(message, template->data, template->len);
+	message_length = template->len;
+
+	/* The template starts with counter 1 */
+	memcpy(message,
+	       (uint8_t *)&(uint32_t){HUBBLE_CPU_TO_BE32(counter)},
+	       sizeof(counter));
+
+	message_length += _context_encode(context, message + message_length);
+
+	memcpy(message + message_length, &olen_bits, sizeof(olen_bits));
+	message_length += sizeof(olen_bits);
+
+	return message_length;
+}
+
+static int _kbkdf_prf(const uint8_t *key, const uint8_t *const messages[],
+		      const size_t lengths[], size_t count,
+		      uint8_t output[][HUBBLE_AES_BLOCK_SIZE])
+{
+#ifdef CONFIG_HUBBLE_NETWORK_CRYPTO_CMAC_MULTI
+	return hubble_crypto_cmac_multi(key, messages, lengths, count, output);
+#else
+	(void)count;
+
+	return hubble_crypto_cmac(key, messages[0], lengths[0], output[0]);
+#endif
+}
+
+/* Derives one output per template and context, all of the same length.
+ * The PRF iterations do not depend on each other, with
+ * CONFIG_HUBBLE_NETWORK_CRYPTO_CMAC_MULTI they are handed to the crypto
+ * provider _KBKDF_MESSAGES at a time.
+ */
+static int _kbkdf_counter(const uint8_t *key,
+			  const struct _kbkdf_template *const templates[],
+			  const uint32_t contexts[], size_t count,
+			  uint8_t *const outputs[], size_t olen)
+{
+	int ret = 0;
+	uint8_t prf_output[_KBKDF_MESSAGES][HUBBLE_AES_BLOCK_SIZE];
+	uint8_t message[_KBKDF_MESSAGES][_MESSAGE_SIZE];
+	const uint8_t *messages[_KBKDF_MESSAGES];
+	size_t lengths[_KBKDF_MESSAGES];
+	const size_t blocks =
+		(olen + HUBBLE_AES_BLOCK_SIZE - 1U) / HUBBLE_AES_BLOCK_SIZE;
+	const size_t iterations = count * blocks;
+	const uint32_t olen_bits =
+		HUBBLE_CPU_TO_BE32(olen * HUBBLE_BITS_PER_BYTE);
+
+	for (size_t first = 0; first < iterations; first += _KBKDF_MESSAGES) {
+		size_t n = HUBBLE_MIN(iterations - first, _KBKDF_MESSAGES);
+
+		for (size_t i = 0; i < n; i++) {
+			size_t index = (first + i) / blocks;
+			size_t block = (first + i) % blocks;
+
+			lengths[i] = _kbkdf_message(templates[index],
+						    block + 1U,
+						    contexts[index],
+						    olen_bits, message[i]);
+			messages[i] = message[i];
+		}
+
+		/* Perform AES-CMAC with the key and the prepared messages */
+		ret = _kbkdf_prf(key, messages, lengths, n, prf_output);
 		if (ret != 0) {
 			goto exit;
 		}
 
 		/* Copy the output */
-		if (remaining > HUBBLE_AES_BLOCK_SIZE) {
-			remaining = HUBBLE_AES_BLOCK_SIZE;
-		}
+		for (size_t i = 0; i < n; i++) {
+			size_t index = (first + i) / blocks;
+			size_t offset = ((first + i) % blocks) *
+					HUBBLE_AES_BLOCK_SIZE;
+			size_t remaining = olen - offset;
 
-		memcpy(output + total, prf_output, remaining);
-		total += remaining;
-		counter++;
+			if (remaining > HUBBLE_AES_BLOCK_SIZE) {
+				remaining = HUBBLE_AES_BLOCK_SIZE;
+			}
+
+			memcpy(outputs[index] + offset, prf_output[i],
+			       remaining);
+		}
 	}
 
 exit:
@@ -204,36 +473,70 @@ exit:
 	return ret;
 }
 
-static int _derived_key_get(enum hubble_key_label label, uint32_t counter,
+static int _derived_key_get(const uint8_t *key, enum hubble_key_label label,
+			    uint32_t counter,
 			    uint8_t output_key[CONFIG_HUBBLE_KEY_SIZE])
 {
-	int err = 0;
-	uint8_t context[_CONTEXT_SIZE] = {0};
+	const struct _kbkdf_template *template;
 
-	snprintf((char *)context, _CONTEXT_SIZE, "%" PRIu32, counter);
-	switch (label) {
-	case HUBBLE_DEVICE_KEY:
-		err = _kbkdf_counter(master_key, "DeviceKey", strlen("DeviceKey"),
-				     context, strlen((const char *)context),
-				     output_key, CONFIG_HUBBLE_KEY_SIZE);
-		break;
-	case HUBBLE_NONCE_KEY:
-		err = _kbkdf_counter(master_key, "NonceKey", strlen("NonceKey"),
-				     context, strlen((const char *)context),
-				     output_key, CONFIG_HUBBLE_KEY_SIZE);
-		break;
-	case HUBBLE_ENCRYPTION_KEY:
-		err = _kbkdf_counter(master_key, "EncryptionKey",
-				     strlen("EncryptionKey"), context,
-				     strlen((const char *)context), output_key,
-				     CONFIG_HUBBLE_KEY_SIZE);
-		break;
-	default:
-		err = -EINVAL;
-		break;
+	if (label >= HUBBLE_KEY_LABEL_COUNT) {
+		return -EINVAL;
 	}
 
-	return err;
+	template = &_key_templates[label];
+
+	return _kbkdf_counter(key, &template, &counter, 1U, &output_key,
+			      CONFIG_HUBBLE_KEY_SIZE);
+}
+
+static int _day_key_get(enum hubble_key_label label, uint32_t time_counter,
+			uint8_t output_key[CONFIG_HUBBLE_KEY_SIZE])
+{
+#ifdef CONFIG_HUBBLE_NETWORK_KEY_CACHE
+	int err;
+
+	if (label >= HUBBLE_KEY_LABEL_COUNT) {
+		return -EINVAL;
+	}
+
+	_day_state_sync(time_counter);
+
+	if ((_day_state.valid & HUBBLE_BIT(label)) == 0U) {
+		err = _derived_key_get(master_key, label, time_counter,
+				       _day_state.keys[label]);
+		if (err != 0) {
+			hubble_crypto_zeroize(_day_state.keys[label],
+					      CONFIG_HUBBLE_KEY_SIZE);
+			return err;
+		}
+
+		_day_state.valid |= HUBBLE_BIT(label);
+	}
+
+	memcpy(output_key, _day_state.keys[label], CONFIG_HUBBLE_KEY_SIZE);
+
+	return 0;
+#else
+	return _derived_key_get(master_key, label, time_counter, output_key);
+#endif /* CONFIG_HUBBLE_NETWORK_KEY_CACHE */
+}
+
+static int _value_from_key_get(enum hubble_value_label label,
+			       const uint8_t key[CONFIG_HUBBLE_KEY_SIZE],
+			       uint16_t seq_no, uint8_t *output_value,
+			       uint32_t output_len)
+{
+	const struct _kbkdf_template *template;
+	const uint32_t context = seq_no;
+
+	if (label >= HUBBLE_VALUE_LABEL_COUNT) {
+		return -EINVAL;
+	}
+
+	template = &_value_templates[label];
+
+	return _kbkdf_counter(key, &template, &context, 1U, &output_value,
+			      output_len);
 }
 
 static int _derived_value_get(enum hubble_value_label label,
@@ -241,57 +544,119 @@ static int _derived_value_get(enum hubble_value_label label,
 			      uint8_t *output_value, uint32_t output_len)
 {
 	int ret = 0;
-	uint8_t context[_CONTEXT_SIZE] = {0};
+	enum hubble_key_label key_label;
 	uint8_t derived_key[CONFIG_HUBBLE_KEY_SIZE] = {0};
 
-	snprintf((char *)context, _CONTEXT_SIZE, "%u", seq_no);
-
 	switch (label) {
 	case HUBBLE_DEVICE_VALUE:
-		ret = _derived_key_get(HUBBLE_DEVICE_KEY, time_counter,
-				       derived_key);
-		if (ret != 0) {
-			goto exit;
-		}
-		ret = _kbkdf_counter(derived_key, "DeviceID", strlen("DeviceID"),
-				     context, strlen((const char *)context),
-				     output_value, output_len);
+		key_label = HUBBLE_DEVICE_KEY;
 		break;
 	case HUBBLE_NONCE_VALUE:
-		ret = _derived_key_get(HUBBLE_NONCE_KEY, time_counter,
-				       derived_key);
-		if (ret != 0) {
-			goto exit;
-		}
-		ret = _kbkdf_counter(derived_key, "Nonce", strlen("Nonce"),
-				     context, strlen((const char *)context),
-				     output_value, output_len);
+		key_label = HUBBLE_NONCE_KEY;
 		break;
 	case HUBBLE_ENCRYPTION_VALUE:
-		ret = _derived_key_get(HUBBLE_ENCRYPTION_KEY, time_counter,
-				       derived_key);
-		if (ret != 0) {
-			goto exit;
-		}
-		ret = _kbkdf_counter(derived_key, "Key", strlen("Key"), context,
-				     strlen((const char *)context),
-				     output_value, output_len);
+		key_label = HUBBLE_ENCRYPTION_KEY;
 		break;
 	default:
-		ret = -EINVAL;
-		break;
+		return -EINVAL;
 	}
 
-	hubble_crypto_zeroize(derived_key, sizeof(derived_key));
+	ret = _day_key_get(key_label, time_counter, derived_key);
+	if (ret != 0) {
+		goto exit;
+	}
+
+	ret = _value_from_key_get(label, derived_key, seq_no, output_value,
+				  output_len);
+
 exit:
+	hubble_crypto_zeroize(derived_key, sizeof(derived_key));
 	return ret;
 }
 
 int hubble_internal_device_id_get(uint8_t *device_id, size_t device_id_len,
 				  uint32_t counter)
 {
+#ifdef CONFIG_HUBBLE_NETWORK_KEY_CACHE
+	int err;
+
+	/* Only the 32 bits device ID used on air is cached */
+	if (device_id_len != sizeof(_day_state.device_id)) {
+		return _derived_value_get(HUBBLE_DEVICE_VALUE, counter, 0,
+					  device_id, device_id_len);
+	}
+
+	_day_state_sync(counter);
+
+	if ((_day_state.valid & _DAY_STATE_DEVICE_ID_VALID) == 0U) {
+#ifdef CONFIG_HUBBLE_BLE_NETWORK_PRECOMPUTE
+		if (!_precomputed_device_id_get(counter,
+						&_day_state.device_id))
+#endif
+		{
+			err = _derived_value_get(
+				HUBBLE_DEVICE_VALUE, counter, 0,
+				(uint8_t *)&_day_state.device_id,
+				sizeof(_day_state.device_id));
+			if (err != 0) {
+				return err;
+			}
+		}
+
+		_day_state.valid |= _DAY_STATE_DEVICE_ID_VALID;
+	}
+
+	memcpy(device_id, &_day_state.device_id, sizeof(_day_state.device_id));
+
+	return 0;
+#else
+#ifdef CONFIG_HUBBLE_BLE_NETWORK_PRECOMPUTE
+	uint32_t precomputed_id;
+
+	if ((device_id_len == sizeof(precomputed_id)) &&
+	    _precomputed_device_id_get(counter, &precomputed_id)) {
+		memcpy(device_id, &precomputed_id, sizeof(precomputed_id));
+		return 0;
+	}
+#endif /* CONFIG_HUBBLE_BLE_NETWORK_PRECOMPUTE */
+
 	return _derived_value_get(HUBBLE_DEVICE_VALUE, counter, 0, device_id,
 				  device_id_len);
+#endif /* CONFIG_HUBBLE_NETWORK_KEY_CACHE */
+}
+
+/* Encrypts the payload and authenticates the ciphertext */
+static int _encrypt_and_tag(const uint8_t key[CONFIG_HUBBLE_KEY_SIZE],
+			    uint8_t nonce_counter[HUBBLE_NONCE_BUFFER_SIZE],
+			    const uint8_t *input, size_t input_len,
+			    uint8_t *out, uint8_t *tag, size_t tag_len)
+{
+	int err;
+	uint8_t auth_tag[_AUTH_TAG_SIZE] = {0};
+
+#ifdef CONFIG_HUBBLE_NETWORK_CRYPTO_CTR_CMAC
+	err = hubble_crypto_ctr_cmac(key, nonce_counter, input, input_len, out,
+				     auth_tag);
+	if (err != 0) {
+		goto exit;
+	}
+#else
+	err = hubble_crypto_aes_ctr(key, nonce_counter, input, input_len, out);
+	if (err != 0) {
+		goto exit;
+	}
+
+	err = hubble_crypto_cmac(key, out, input_len, auth_tag);
+	if (err != 0) {
+		goto exit;
+	}
+#endif
+
+	memcpy(tag, auth_tag, tag_len);
+
+exit:
+	hubble_crypto_zeroize(auth_tag, sizeof(auth_tag));
+	return err;
 }
 
 int hubble_internal_data_encrypt(uint32_t counter, uint16_t seq_no,
@@ -299,41 +664,394 @@ int hubble_internal_data_encrypt(uint32_t counter, uint16_t seq_no,
 				 uint8_t *out, uint8_t *tag, size_t tag_len)
 {
 	int err;
-	uint8_t auth_tag[_AUTH_TAG_SIZE] = {0};
 	uint8_t encryption_key[CONFIG_HUBBLE_KEY_SIZE] = {0};
 	uint8_t nonce_counter[HUBBLE_NONCE_BUFFER_SIZE] = {0};
 
+#ifdef CONFIG_HUBBLE_BLE_NETWORK_PRECOMPUTE
+	struct _precomputed_slot *slot =
+		_precomputed_slot_find(counter, seq_no);
+
+	if (slot != NULL) {
+		memcpy(nonce_counter, slot->nonce_counter,
+		       sizeof(nonce_counter));
+		memcpy(encryption_key, slot->encryption_key,
+		       sizeof(encryption_key));
+
+		/* The whole frame is ready for an empty payload */
+		if (input_len == 0U) {
+			memcpy(tag, slot->empty_tag, tag_len);
+		}
+
+		/* A nonce is only used once */
+		_precomputed_slot_clear(slot);
+
+		err = (input_len == 0U)
+			      ? 0
+			      : _encrypt_and_tag(encryption_key, nonce_counter,
+						 input, input_len, out, tag,
+						 tag_len);
+		goto exit;
+	}
+#endif /* CONFIG_HUBBLE_BLE_NETWORK_PRECOMPUTE */
+
 	err = _derived_value_get(HUBBLE_NONCE_VALUE, counter, seq_no,
 				 nonce_counter, _NONCE_SIZE);
 	if (err) {
-		goto err;
+		goto exit;
 	}
 
 	err = _derived_value_get(HUBBLE_ENCRYPTION_VALUE, counter, seq_no,
 				 encryption_key, sizeof(encryption_key));
 	if (err) {
-		goto encryption_key_err;
+		goto exit;
+	}
+
+	err = _encrypt_and_tag(encryption_key, nonce_counter, input, input_len,
+			       out, tag, tag_len);
+
+exit:
+	hubble_crypto_zeroize(encryption_key, sizeof(encryption_key));
+	hubble_crypto_zeroize(nonce_counter, sizeof(nonce_counter));
+	return err;
+}
+
+int hubble_internal_key_device_id_get(const void *key, uint32_t time_counter,
+				      uint32_t *device_id)
+{
+	int ret;
+	uint8_t device_key[CONFIG_HUBBLE_KEY_SIZE];
+
+	if ((key == NULL) || (device_id == NULL)) {
+		return -EINVAL;
+	}
+
+	ret = _derived_key_get(key, HUBBLE_DEVICE_KEY, time_counter,
+			       device_key);
+	if (ret == 0) {
+		ret = _value_from_key_get(HUBBLE_DEVICE_VALUE, device_key, 0,
+					  (uint8_t *)device_id,
+					  sizeof(*device_id));
+	}
+
+	hubble_crypto_zeroize(device_key, sizeof(device_key));
+
+	return ret;
+}
+
+int hubble_internal_key_day_keys_get(const void *key, uint32_t time_counter,
+				     struct hubble_internal_day_keys *keys)
+{
+	int ret;
+	uint8_t device_key[CONFIG_HUBBLE_KEY_SIZE];
+	const struct _kbkdf_template *templates[HUBBLE_KEY_LABEL_COUNT];
+	uint32_t contexts[HUBBLE_KEY_LABEL_COUNT];
+	uint8_t *outputs[HUBBLE_KEY_LABEL_COUNT];
+
+	if ((key == NULL) || (keys == NULL)) {
+		return -EINVAL;
+	}
+
+	keys->time_counter = time_counter;
+
+	for (size_t i = 0; i < HUBBLE_KEY_LABEL_COUNT; i++) {
+		templates[i] = &_key_templates[i];
+		contexts[i] = time_counter;
+	}
+
+	outputs[HUBBLE_DEVICE_KEY] = device_key;
+	outputs[HUBBLE_NONCE_KEY] = keys->nonce_key;
+	outputs[HUBBLE_ENCRYPTION_KEY] = keys->encryption_key;
+
+	/* The three keys of the day are derived together */
+	ret = _kbkdf_counter(key, templates, contexts, HUBBLE_KEY_LABEL_COUNT,
+			     outputs, CONFIG_HUBBLE_KEY_SIZE);
+	if (ret == 0) {
+		ret = _value_from_key_get(HUBBLE_DEVICE_VALUE, device_key, 0,
+					  (uint8_t *)&keys->device_id,
+					  sizeof(keys->device_id));
+	}
+
+	if (ret != 0) {
+		hubble_crypto_zeroize(keys, sizeof(*keys));
+	}
+
+	hubble_crypto_zeroize(device_key, sizeof(device_key));
+
+	return ret;
+}
+
+int hubble_internal_day_keys_get(uint32_t time_counter,
+				 struct hubble_internal_day_keys *keys)
+{
+	return hubble_internal_key_day_keys_get(master_key, time_counter,
+						keys);
+}
+
+int hubble_internal_seq_keys_multi_get(
+	const uint8_t nonce_key[CONFIG_HUBBLE_KEY_SIZE],
+	const uint8_t encryption_key[CONFIG_HUBBLE_KEY_SIZE],
+	const uint16_t seq_nos[], size_t count, uint8_t *const nonce_counters[],
+	uint8_t *const keys[])
+{
+	int err = 0;
+	const struct _kbkdf_template *nonce_templates[_KBKDF_MESSAGES];
+	const struct _kbkdf_template *key_templates[_KBKDF_MESSAGES];
+	uint32_t contexts[_KBKDF_MESSAGES];
+
+	for (size_t i = 0; i < _KBKDF_MESSAGES; i++) {
+		nonce_templates[i] = &_value_templates[HUBBLE_NONCE_VALUE];
+		key_templates[i] = &_value_templates[HUBBLE_ENCRYPTION_VALUE];
+	}
+
+	for (size_t first = 0; first < count; first += _KBKDF_MESSAGES) {
+		size_t n = HUBBLE_MIN(count - first, _KBKDF_MESSAGES);
+
+		for (size_t i = 0; i < n; i++) {
+			contexts[i] = seq_nos[first + i];
+
+			/* The block counter part starts at zero */
+			memset(nonce_counters[first + i], 0,
+			       HUBBLE_NONCE_BUFFER_SIZE);
+		}
+
+		err = _kbkdf_counter(nonce_key, nonce_templates, contexts, n,
+				     &nonce_counters[first], _NONCE_SIZE);
+		if (err != 0) {
+			break;
+		}
+
+		err = _kbkdf_counter(encryption_key, key_templates, contexts,
+				     n, &keys[first], CONFIG_HUBBLE_KEY_SIZE);
+		if (err != 0) {
+			break;
+		}
 	}
 
-	err = hubble_crypto_aes_ctr(encryption_key, nonce_counter, input,
-				    input_len, out);
 	if (err != 0) {
-		goto crypt_ctr_err;
+		for (size_t i = 0; i < count; i++) {
+			hubble_crypto_zeroize(nonce_counters[i],
+					      HUBBLE_NONCE_BUFFER_SIZE);
+			hubble_crypto_zeroize(keys[i], CONFIG_HUBBLE_KEY_SIZE);
+		}
 	}
 
-	err = hubble_crypto_cmac(encryption_key, out, input_len, auth_tag);
+	return err;
+}
+
+int hubble_internal_seq_keys_get(
+	const uint8_t nonce_key[CONFIG_HUBBLE_KEY_SIZE],
+	const uint8_t encryption_key[CONFIG_HUBBLE_KEY_SIZE], uint16_t seq_no,
+	uint8_t nonce_counter[HUBBLE_NONCE_BUFFER_SIZE],
+	uint8_t key[CONFIG_HUBBLE_KEY_SIZE])
+{
+	return hubble_internal_seq_keys_multi_get(nonce_key, encryption_key,
+						  &seq_no, 1U, &nonce_counter,
+						  &key);
+}
+
+int hubble_internal_data_encrypt_with_keys(
+	const struct hubble_internal_day_keys *keys, uint16_t seq_no,
+	const uint8_t *input, size_t input_len, uint8_t *out, uint8_t *tag,
+	size_t tag_len)
+{
+	int err;
+	uint8_t encryption_key[CONFIG_HUBBLE_KEY_SIZE] = {0};
+	uint8_t nonce_counter[HUBBLE_NONCE_BUFFER_SIZE] = {0};
+
+	err = hubble_internal_seq_keys_get(keys->nonce_key,
+					   keys->encryption_key, seq_no,
+					   nonce_counter, encryption_key);
 	if (err != 0) {
-		goto cmac_err;
+		goto exit;
 	}
 
-	memcpy(tag, auth_tag, tag_len);
+	err = _encrypt_and_tag(encryption_key, nonce_counter, input, input_len,
+			       out, tag, tag_len);
 
-cmac_err:
-	hubble_crypto_zeroize(auth_tag, sizeof(auth_tag));
-crypt_ctr_err:
+exit:
 	hubble_crypto_zeroize(encryption_key, sizeof(encryption_key));
-encryption_key_err:
 	hubble_crypto_zeroize(nonce_counter, sizeof(nonce_counter));
-err:
 	return err;
 }
+
+/* Compares without leaking the position of the first difference */
+static bool _tag_equal(const uint8_t *a, const uint8_t *b, size_t len)
+{
+	uint8_t diff = 0U;
+
+	for (size_t i = 0; i < len; i++) {
+		diff |= a[i] ^ b[i];
+	}
+
+	return diff == 0U;
+}
+
+/* Checks the tag of the ciphertext */
+static int _tag_check(const uint8_t key[CONFIG_HUBBLE_KEY_SIZE],
+		      const uint8_t *data, size_t data_len, const uint8_t *tag,
+		      size_t tag_len)
+{
+	int err;
+	uint8_t auth_tag[_AUTH_TAG_SIZE] = {0};
+
+	if ((tag_len == 0U) || (tag_len > sizeof(auth_tag))) {
+		return -EINVAL;
+	}
+
+	err = hubble_crypto_cmac(key, data, data_len, auth_tag);
+	if ((err == 0) && !_tag_equal(auth_tag, tag, tag_len)) {
+		err = -EBADMSG;
+	}
+
+	hubble_crypto_zeroize(auth_tag, sizeof(auth_tag));
+	return err;
+}
+
+int hubble_internal_data_verify_with_keys(
+	const struct hubble_internal_day_keys *keys, uint16_t seq_no,
+	const uint8_t *data, size_t data_len, const uint8_t *tag,
+	size_t tag_len)
+{
+	int err;
+	uint8_t encryption_key[CONFIG_HUBBLE_KEY_SIZE] = {0};
+
+	err = _value_from_key_get(HUBBLE_ENCRYPTION_VALUE,
+				  keys->encryption_key, seq_no, encryption_key,
+				  sizeof(encryption_key));
+	if (err == 0) {
+		err = _tag_check(encryption_key, data, data_len, tag, tag_len);
+	}
+
+	hubble_crypto_zeroize(encryption_key, sizeof(encryption_key));
+	return err;
+}
+
+int hubble_internal_data_decrypt_with_seq_keys(
+	const uint8_t key[CONFIG_HUBBLE_KEY_SIZE],
+	const uint8_t nonce_counter[HUBBLE_NONCE_BUFFER_SIZE],
+	const uint8_t *data, size_t data_len, const uint8_t *tag,
+	size_t tag_len, uint8_t *out)
+{
+	int err;
+	uint8_t counter[HUBBLE_NONCE_BUFFER_SIZE];
+
+	/* Nothing is decrypted before the ciphertext is authenticated */
+	err = _tag_check(key, data, data_len, tag, tag_len);
+	if ((err != 0) || (data_len == 0U)) {
+		return err;
+	}
+
+	/* The CTR operation updates the counter */
+	memcpy(counter, nonce_counter, sizeof(counter));
+
+	err = hubble_crypto_aes_ctr(key, counter, data, data_len, out);
+
+	hubble_crypto_zeroize(counter, sizeof(counter));
+	return err;
+}
+
+int hubble_internal_sat_tag_check(
+	const uint8_t key[CONFIG_HUBBLE_KEY_SIZE],
+	const uint8_t nonce_counter[HUBBLE_NONCE_BUFFER_SIZE],
+	const uint8_t *payload, size_t len, const uint8_t *tag,
+	size_t tag_len)
+{
+	int err = 0;
+	uint8_t counter[HUBBLE_NONCE_BUFFER_SIZE];
+	uint8_t ciphertext[HUBBLE_SAT_PAYLOAD_MAX] = {0};
+
+	if (len > sizeof(ciphertext)) {
+		return -EINVAL;
+	}
+
+	/* The packet carries the payload, the tag is over its encryption */
+	if (len > 0U) {
+		memcpy(counter, nonce_counter, sizeof(counter));
+		err = hubble_crypto_aes_ctr(key, counter, payload, len,
+					    ciphertext);
+	}
+
+	if (err == 0) {
+		err = _tag_check(key, ciphertext, len, tag, tag_len);
+	}
+
+	hubble_crypto_zeroize(counter, sizeof(counter));
+	hubble_crypto_zeroize(ciphertext, sizeof(ciphertext));
+	return err;
+}
+
+#ifdef CONFIG_HUBBLE_BLE_NETWORK_PRECOMPUTE
+static int _precomputed_slot_fill(struct _precomputed_slot *slot,
+				  const struct hubble_internal_day_keys *keys)
+{
+	int ret;
+	const uint8_t empty = 0U;
+
+	ret = _value_from_key_get(HUBBLE_NONCE_VALUE, keys->nonce_key,
+				  slot->seq_no, slot->nonce_counter,
+				  _NONCE_SIZE);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = _value_from_key_get(HUBBLE_ENCRYPTION_VALUE, keys->encryption_key,
+				  slot->seq_no, slot->encryption_key,
+				  sizeof(slot->encryption_key));
+	if (ret != 0) {
+		return ret;
+	}
+
+	return hubble_crypto_cmac(slot->encryption_key, &empty, 0,
+				  slot->empty_tag);
+}
+
+int hubble_internal_precompute(uint32_t time_counter, uint16_t seq_no,
+			       size_t count)
+{
+	int ret = 0;
+	uint8_t generation = _precomputed_generation;
+	struct hubble_internal_day_keys keys;
+
+	if ((count == 0U) || (count > HUBBLE_ARRAY_SIZE(_precomputed))) {
+		return -EINVAL;
+	}
+
+	/* The day state is not touched here, this may run preempted by
+	 * the context building advertisements.
+	 */
+	ret = hubble_internal_day_keys_get(time_counter, &keys);
+	if (ret != 0) {
+		return ret;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		uint16_t seq = (seq_no + i) % (HUBBLE_MAX_SEQ_COUNTER + 1);
+		struct _precomputed_slot *slot =
+			&_precomputed[seq % HUBBLE_ARRAY_SIZE(_precomputed)];
+
+		if ((generation == _precomputed_generation) &&
+		    (_precomputed_slot_find(time_counter, seq) != NULL)) {
+			continue;
+		}
+
+		_precomputed_slot_clear(slot);
+
+		slot->generation = generation;
+		slot->time_counter = time_counter;
+		slot->seq_no = seq;
+		slot->device_id = keys.device_id;
+
+		ret = _precomputed_slot_fill(slot, &keys);
+		if (ret != 0) {
+			_precomputed_slot_clear(slot);
+			break;
+		}
+
+		HUBBLE_COMPILER_BARRIER();
+		slot->ready = true;
+	}
+
+	hubble_crypto_zeroize(&keys, sizeof(keys));
+	return ret;
+}
+#endif /* CONFIG_HUBBLE_BLE_NETWORK_PRECOMPUTE */
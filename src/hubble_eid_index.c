@@ -0,0 +1,439 @@
+/*
+ * Copyright (c) 2026 Hubble Network, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <hubble/eid_index.h>
+#include <hubble/port/crypto.h>
+#include <hubble/sat/packet.h>
+
+#include "hubble_priv.h"
+#include "utils/macros.h"
+
+/* Fibonacci hashing, EIDs are already uniformly distributed but this
+ * keeps the home slot independent from their low bits.
+ */
+#define _HASH_MULTIPLIER 0x9E3779B1U
+
+/* Keeps at least a quarter of the slots empty */
+#define _LOAD_NUM 3U
+#define _LOAD_DEN 4U
+
+#define _SLOT_BITS_MAX 31U
+
+static inline bool _slot_used(const struct hubble_eid_index_entry *slot)
+{
+	return slot->key_index != HUBBLE_EID_INDEX_KEY_NONE;
+}
+
+static inline uint32_t _slot_mask(const struct hubble_eid_index *index)
+{
+	return (uint32_t)((1ULL << index->slot_bits) - 1U);
+}
+
+static inline uint32_t _slot_home(const struct hubble_eid_index *index,
+				  uint32_t eid)
+{
+	return (uint32_t)(eid * _HASH_MULTIPLIER) >> (32U - index->slot_bits);
+}
+
+/* Smallest number of slot bits keeping the table load under the limit */
+static uint32_t _slot_bits_get(uint32_t key_count, uint32_t window)
+{
+	uint64_t entries = (uint64_t)key_count * window;
+	uint32_t bits = 1U;
+
+	while ((bits <= _SLOT_BITS_MAX) &&
+	       ((entries * _LOAD_DEN) > ((1ULL << bits) * _LOAD_NUM))) {
+		bits++;
+	}
+
+	return bits;
+}
+
+static void _slots_clear(struct hubble_eid_index *index)
+{
+	/* Sets key_index to HUBBLE_EID_INDEX_KEY_NONE */
+	memset(index->slots, 0xFF,
+	       sizeof(index->slots[0]) * (1ULL << index->slot_bits));
+	index->entry_count = 0U;
+	index->days = 0U;
+}
+
+static void _slot_insert(struct hubble_eid_index *index,
+			 const struct hubble_eid_index_entry *entry)
+{
+	uint32_t mask = _slot_mask(index);
+	uint32_t i = _slot_home(index, entry->eid);
+
+	/* Linear probing, the load limit guarantees an empty slot */
+	while (_slot_used(&index->slots[i])) {
+		i = (i + 1U) & mask;
+	}
+
+	index->slots[i] = *entry;
+	index->entry_count++;
+}
+
+/* Backward shift deletion: entries of the probe sequence following the
+ * hole are moved into it when their home slot allows it, so lookups
+ * never need tombstones.
+ */
+static void _slot_remove(struct hubble_eid_index *index, uint32_t hole)
+{
+	uint32_t mask = _slot_mask(index);
+	uint32_t i = hole;
+
+	for (;;) {
+		uint32_t home;
+
+		i = (i + 1U) & mask;
+		if (!_slot_used(&index->slots[i])) {
+			break;
+		}
+
+		home = _slot_home(index, index->slots[i].eid);
+		if (((i - home) & mask) >= ((i - hole) & mask)) {
+			index->slots[hole] = index->slots[i];
+			hole = i;
+		}
+	}
+
+	index->slots[hole].key_index = HUBBLE_EID_INDEX_KEY_NONE;
+	index->entry_count--;
+}
+
+/* Removes the entries whose time counter is out of [start, end) */
+static void _slots_prune(struct hubble_eid_index *index, uint64_t start,
+			 uint64_t end)
+{
+	uint32_t mask = _slot_mask(index);
+	uint32_t i = 0U;
+	uint64_t visited = 0U;
+
+	/* Starting right after an empty slot, no probe sequence wraps
+	 * around the scan, so shifted entries are always checked.
+	 */
+	while (_slot_used(&index->slots[i])) {
+		i = (i + 1U) & mask;
+	}
+
+	while (visited <= mask) {
+		const struct hubble_eid_index_entry *slot = &index->slots[i];
+
+		if (_slot_used(slot) && ((slot->time_counter < start) ||
+					 (slot->time_counter >= end))) {
+			/* Check again the entry shifted in this slot */
+			_slot_remove(index, i);
+			continue;
+		}
+
+		i = (i + 1U) & mask;
+		visited++;
+	}
+}
+
+static int _day_insert(struct hubble_eid_index *index,
+		       const uint8_t (*keys)[CONFIG_HUBBLE_KEY_SIZE],
+		       uint32_t time_counter)
+{
+	int err;
+	struct hubble_eid_index_entry entry = {
+		.time_counter = time_counter,
+	};
+
+	for (uint32_t k = 0; k < index->key_count; k++) {
+		err = hubble_internal_key_device_id_get(keys[k], time_counter,
+							&entry.eid);
+		if (err != 0) {
+			return err;
+		}
+
+		entry.key_index = k;
+		_slot_insert(index, &entry);
+	}
+
+	return 0;
+}
+
+size_t hubble_eid_index_size(uint32_t key_count, uint32_t window)
+{
+	uint32_t bits;
+
+	if ((key_count == 0U) || (key_count == HUBBLE_EID_INDEX_KEY_NONE) ||
+	    (window == 0U)) {
+		return 0U;
+	}
+
+	bits = _slot_bits_get(key_count, window);
+	if ((bits > _SLOT_BITS_MAX) ||
+	    ((1ULL << bits) >
+	     ((SIZE_MAX - sizeof(struct hubble_eid_index)) /
+	      sizeof(struct hubble_eid_index_entry)))) {
+		return 0U;
+	}
+
+	return sizeof(struct hubble_eid_index) +
+	       ((size_t)1U << bits) * sizeof(struct hubble_eid_index_entry);
+}
+
+int hubble_eid_index_init(struct hubble_eid_index *index, size_t size,
+			  uint32_t key_count, uint32_t window)
+{
+	size_t needed = hubble_eid_index_size(key_count, window);
+
+	if ((index == NULL) || (needed == 0U) || (size < needed)) {
+		return -EINVAL;
+	}
+
+	index->magic = HUBBLE_EID_INDEX_MAGIC;
+	index->version = HUBBLE_EID_INDEX_VERSION;
+	index->key_size = CONFIG_HUBBLE_KEY_SIZE;
+	index->key_count = key_count;
+	index->window = window;
+	index->time_counter = 0U;
+	index->slot_bits = _slot_bits_get(key_count, window);
+
+	_slots_clear(index);
+
+	return 0;
+}
+
+int hubble_eid_index_check(const struct hubble_eid_index *index, size_t size)
+{
+	uint64_t used = 0U;
+
+	if ((index == NULL) || (size < sizeof(*index))) {
+		return -EINVAL;
+	}
+
+	if ((index->magic != HUBBLE_EID_INDEX_MAGIC) ||
+	    (index->version != HUBBLE_EID_INDEX_VERSION) ||
+	    (index->key_size != CONFIG_HUBBLE_KEY_SIZE)) {
+		return -EINVAL;
+	}
+
+	if ((hubble_eid_index_size(index->key_count, index->window) != size) ||
+	    (index->slot_bits !=
+	     _slot_bits_get(index->key_count, index->window))) {
+		return -EINVAL;
+	}
+
+	if (((index->days != 0U) && (index->days != index->window)) ||
+	    (index->entry_count != (uint64_t)index->key_count * index->days)) {
+		return -EINVAL;
+	}
+
+	/* Lookups index the key array with the slots and stop on the
+	 * first free slot, a corrupted table must not get that far.
+	 */
+	for (uint64_t i = 0; i < (1ULL << index->slot_bits); i++) {
+		const struct hubble_eid_index_entry *slot = &index->slots[i];
+
+		if (!_slot_used(slot)) {
+			continue;
+		}
+
+		if ((slot->key_index >= index->key_count) ||
+		    (slot->time_counter < index->time_counter) ||
+		    (slot->time_counter - index->time_counter >=
+		     index->days)) {
+			return -EINVAL;
+		}
+
+		used++;
+	}
+
+	if (used != index->entry_count) {
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+int hubble_eid_index_update(struct hubble_eid_index *index,
+			    const uint8_t (*keys)[CONFIG_HUBBLE_KEY_SIZE],
+			    uint32_t time_counter)
+{
+	int err;
+	uint64_t start = time_counter;
+	uint64_t end;
+	uint64_t keep_start = start;
+	uint64_t keep_end = start;
+
+	if ((index == NULL) || (keys == NULL)) {
+		return -EINVAL;
+	}
+
+	end = start + index->window;
+
+	/* Time counters indexed in both the old and the new window */
+	if (index->days != 0U) {
+		keep_start = HUBBLE_MAX(start, (uint64_t)index->time_counter);
+		keep_end = HUBBLE_MIN(end, (uint64_t)index->time_counter +
+						   index->days);
+	}
+
+	if (keep_start >= keep_end) {
+		_slots_clear(index);
+		keep_start = start;
+		keep_end = start;
+	} else if ((keep_start != index->time_counter) ||
+		   (keep_end !=
+		    ((uint64_t)index->time_counter + index->days))) {
+		_slots_prune(index, keep_start, keep_end);
+	}
+
+	for (uint64_t day = start; day < end; day++) {
+		if ((day >= keep_start) && (day < keep_end)) {
+			continue;
+		}
+
+		err = _day_insert(index, keys, (uint32_t)day);
+		if (err != 0) {
+			_slots_clear(index);
+			return err;
+		}
+	}
+
+	index->time_counter = time_counter;
+	index->days = index->window;
+
+	return 0;
+}
+
+size_t hubble_eid_index_lookup(const struct hubble_eid_index *index,
+			       uint32_t eid,
+			       struct hubble_eid_index_entry *matches,
+			       size_t max_matches)
+{
+	size_t count = 0U;
+	uint32_t mask = _slot_mask(index);
+	uint32_t i = _slot_home(index, eid);
+
+	while (_slot_used(&index->slots[i])) {
+		if (index->slots[i].eid == eid) {
+			if (count < max_matches) {
+				matches[count] = index->slots[i];
+			}
+			count++;
+		}
+
+		i = (i + 1U) & mask;
+	}
+
+	return count;
+}
+
+static int _sat_verify(const struct hubble_internal_day_keys *keys,
+		       uint16_t seq_no, const uint8_t *data, size_t data_len,
+		       const uint8_t *tag, size_t tag_len)
+{
+	int err;
+	uint8_t nonce_counter[HUBBLE_NONCE_BUFFER_SIZE];
+	uint8_t encryption_key[CONFIG_HUBBLE_KEY_SIZE];
+
+	err = hubble_internal_seq_keys_get(keys->nonce_key,
+					   keys->encryption_key, seq_no,
+					   nonce_counter, encryption_key);
+	if (err == 0) {
+		err = hubble_internal_sat_tag_check(encryption_key,
+						    nonce_counter, data,
+						    data_len, tag, tag_len);
+	}
+
+	hubble_crypto_zeroize(nonce_counter, sizeof(nonce_counter));
+	hubble_crypto_zeroize(encryption_key, sizeof(encryption_key));
+
+	return err;
+}
+
+static int _resolve(const struct hubble_eid_index *index,
+		    const uint8_t (*keys)[CONFIG_HUBBLE_KEY_SIZE], uint32_t eid,
+		    uint16_t seq_no, const uint8_t *data, size_t data_len,
+		    const uint8_t *tag, size_t tag_len, bool sat,
+		    struct hubble_eid_index_entry *match)
+{
+	int err = -ENOENT;
+	struct hubble_internal_day_keys day_keys;
+	uint32_t mask;
+	uint32_t i;
+
+	if ((index == NULL) || (keys == NULL) || (match == NULL) ||
+	    ((data == NULL) && (data_len > 0U)) || (tag == NULL)) {
+		return -EINVAL;
+	}
+
+	mask = _slot_mask(index);
+	i = _slot_home(index, eid);
+
+	for (; _slot_used(&index->slots[i]); i = (i + 1U) & mask) {
+		const struct hubble_eid_index_entry *slot = &index->slots[i];
+
+		if (slot->eid != eid) {
+			continue;
+		}
+
+		err = hubble_internal_key_day_keys_get(keys[slot->key_index],
+						       slot->time_counter,
+						       &day_keys);
+		if (err != 0) {
+			break;
+		}
+
+		if (sat) {
+			err = _sat_verify(&day_keys, seq_no, data, data_len,
+					  tag, tag_len);
+		} else {
+			err = hubble_internal_data_verify_with_keys(
+				&day_keys, seq_no, data, data_len, tag,
+				tag_len);
+		}
+		if (err == 0) {
+			*match = *slot;
+			break;
+		}
+
+		if (err != -EBADMSG) {
+			break;
+		}
+
+		err = -ENOENT;
+	}
+
+	hubble_crypto_zeroize(&day_keys, sizeof(day_keys));
+
+	return err;
+}
+
+int hubble_eid_index_resolve(const struct hubble_eid_index *index,
+			     const uint8_t (*keys)[CONFIG_HUBBLE_KEY_SIZE],
+			     uint32_t eid, uint16_t seq_no,
+			     const uint8_t *data, size_t data_len,
+			     const uint8_t *tag, size_t tag_len,
+			     struct hubble_eid_index_entry *match)
+{
+	return _resolve(index, keys, eid, seq_no, data, data_len, tag,
+			tag_len, false, match);
+}
+
+int hubble_eid_index_resolve_sat(const struct hubble_eid_index *index,
+				 const uint8_t (*keys)[CONFIG_HUBBLE_KEY_SIZE],
+				 uint32_t eid, uint16_t seq_no,
+				 const uint8_t *payload, size_t payload_len,
+				 const uint8_t *tag, size_t tag_len,
+				 struct hubble_eid_index_entry *match)
+{
+	if (payload_len > HUBBLE_SAT_PAYLOAD_MAX) {
+		return -EINVAL;
+	}
+
+	return _resolve(index, keys, eid, seq_no, payload, payload_len, tag,
+			tag_len, true, match);
+}
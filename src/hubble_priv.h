@@ -11,6 +11,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <hubble/port/crypto.h>
+
 uint64_t hubble_internal_utc_time_get(void);
 
 /* Returns the last time UTC was synced. It
@@ -18,6 +20,11 @@ uint64_t hubble_internal_utc_time_get(void);
  */
 uint64_t hubble_internal_utc_time_last_synced_get(void);
 
+/* Returns the satellite retries added to cover the clock drift since the
+ * last UTC sync, for retries @p interval_s seconds apart.
+ */
+uint8_t hubble_internal_sat_additional_retries_get(uint8_t interval_s);
+
 /**
  * @brief Get the master encryption key.
  *
@@ -29,6 +36,16 @@ uint64_t hubble_internal_utc_time_last_synced_get(void);
  */
 const void *hubble_internal_key_get(void);
 
+/**
+ * @brief Drop everything cached for the current time counter.
+ *
+ * Clears the keys and device ID derived from the master key for the
+ * current time counter (see @kconfig{CONFIG_HUBBLE_NETWORK_KEY_CACHE})
+ * and the keys kept by the crypto provider. It must be called whenever
+ * the master key or the time reference changes.
+ */
+void hubble_internal_day_state_clear(void);
+
 /**
  * @brief Get the current time counter value.
  *
@@ -101,4 +118,235 @@ int hubble_internal_data_encrypt(uint32_t counter, uint16_t seq_no,
 				 const uint8_t *input, size_t input_len,
 				 uint8_t *out, uint8_t *tag, size_t tag_len);
 
+/**
+ * @brief Check if a range of nonce values is safe to use for encryption.
+ *
+ * Same as calling hubble_internal_nonce_values_check() for each sequence
+ * number in [@p seq_no, @p seq_no + @p count) (wrapping at
+ * HUBBLE_MAX_SEQ_COUNTER), but the check state is only updated if the
+ * whole range is accepted.
+ *
+ * @param time_counter Time-based counter value.
+ * @param seq_no       First sequence number of the range.
+ * @param count        Number of sequence numbers in the range.
+ *
+ * @return true if the nonce values are safe to use, false if using any of
+ *         them would result in nonce reuse.
+ */
+bool hubble_internal_nonce_range_check(uint32_t time_counter, uint16_t seq_no,
+				       size_t count);
+
+/**
+ * @brief Keys derived from the master key for one time counter.
+ *
+ * Lets callers building many packets for the same time counter derive
+ * the day-level keys once.
+ */
+struct hubble_internal_day_keys {
+	/** Time counter the keys were derived for */
+	uint32_t time_counter;
+	/** Ephemeral device ID */
+	uint32_t device_id;
+	/** Key used to derive the per-packet nonces */
+	uint8_t nonce_key[CONFIG_HUBBLE_KEY_SIZE];
+	/** Key used to derive the per-packet encryption keys */
+	uint8_t encryption_key[CONFIG_HUBBLE_KEY_SIZE];
+};
+
+/**
+ * @brief Derive the day-level keys for a time counter.
+ *
+ * It does not use nor update the cached day state.
+ *
+ * @param time_counter Time counter used in the derivation.
+ * @param keys         Output keys. The caller must clear them with
+ *                     hubble_crypto_zeroize() when done.
+ *
+ * @return 0 on success, negative error code on failure.
+ */
+int hubble_internal_day_keys_get(uint32_t time_counter,
+				 struct hubble_internal_day_keys *keys);
+
+/**
+ * @brief Derive the ephemeral device ID of an arbitrary master key.
+ *
+ * Same value as hubble_internal_device_id_get() returns once @p key is
+ * set with hubble_key_set(), but it does not depend on nor touch any
+ * state, so it can be called concurrently for different keys (as long
+ * as the crypto provider is reentrant).
+ *
+ * @param key          Master key (CONFIG_HUBBLE_KEY_SIZE bytes).
+ * @param time_counter Time counter used in the derivation.
+ * @param device_id    Output device ID.
+ *
+ * @return 0 on success, negative error code on failure.
+ */
+int hubble_internal_key_device_id_get(const void *key, uint32_t time_counter,
+				      uint32_t *device_id);
+
+/**
+ * @brief Derive the day-level keys of an arbitrary master key.
+ *
+ * Same as hubble_internal_day_keys_get() for @p key instead of the key
+ * set with hubble_key_set().
+ *
+ * @param key          Master key (CONFIG_HUBBLE_KEY_SIZE bytes).
+ * @param time_counter Time counter used in the derivation.
+ * @param keys         Output keys. The caller must clear them with
+ *                     hubble_crypto_zeroize() when done.
+ *
+ * @return 0 on success, negative error code on failure.
+ */
+int hubble_internal_key_day_keys_get(const void *key, uint32_t time_counter,
+				     struct hubble_internal_day_keys *keys);
+
+/**
+ * @brief Derive the per-packet nonce and encryption key.
+ *
+ * @param nonce_key      Day-level nonce key.
+ * @param encryption_key Day-level encryption key.
+ * @param seq_no         Sequence number of the packet.
+ * @param nonce_counter  Output nonce, with the block counter set to 0.
+ * @param key            Output encryption key.
+ *
+ * @return 0 on success, negative error code on failure.
+ */
+int hubble_internal_seq_keys_get(
+	const uint8_t nonce_key[CONFIG_HUBBLE_KEY_SIZE],
+	const uint8_t encryption_key[CONFIG_HUBBLE_KEY_SIZE], uint16_t seq_no,
+	uint8_t nonce_counter[HUBBLE_NONCE_BUFFER_SIZE],
+	uint8_t key[CONFIG_HUBBLE_KEY_SIZE]);
+
+/**
+ * @brief Derive the per-packet nonces and encryption keys of several packets.
+ *
+ * Same as hubble_internal_seq_keys_get() for each of @p seq_nos. The
+ * derivations are independent, with
+ * CONFIG_HUBBLE_NETWORK_CRYPTO_CMAC_MULTI they are handed to the crypto
+ * provider together.
+ *
+ * @param nonce_key      Day-level nonce key.
+ * @param encryption_key Day-level encryption key.
+ * @param seq_nos        Sequence numbers of the packets.
+ * @param count          Number of packets.
+ * @param nonce_counters Output nonces, one per packet.
+ * @param keys           Output encryption keys, one per packet.
+ *
+ * @return 0 on success, negative error code on failure. On failure every
+ *         output is cleared.
+ */
+int hubble_internal_seq_keys_multi_get(
+	const uint8_t nonce_key[CONFIG_HUBBLE_KEY_SIZE],
+	const uint8_t encryption_key[CONFIG_HUBBLE_KEY_SIZE],
+	const uint16_t seq_nos[], size_t count, uint8_t *const nonce_counters[],
+	uint8_t *const keys[]);
+
+/**
+ * @brief Encrypt data using day-level keys already derived.
+ *
+ * Same as hubble_internal_data_encrypt() for the time counter of @p keys.
+ *
+ * @param keys      Keys obtained with hubble_internal_day_keys_get().
+ * @param seq_no    Sequence number used to derive the encryption key and nonce.
+ * @param input     Pointer to the plaintext data to encrypt.
+ * @param input_len Length of the input data in bytes.
+ * @param out       Pointer to the output buffer for the ciphertext.
+ * @param tag       Pointer to the output buffer for the authentication tag.
+ * @param tag_len   Length of the authentication tag to copy.
+ *
+ * @return 0 on success, negative error code on failure.
+ */
+int hubble_internal_data_encrypt_with_keys(
+	const struct hubble_internal_day_keys *keys, uint16_t seq_no,
+	const uint8_t *input, size_t input_len, uint8_t *out, uint8_t *tag,
+	size_t tag_len);
+
+/**
+ * @brief Check the authentication tag of data encrypted with day-level keys.
+ *
+ * Counterpart of hubble_internal_data_encrypt_with_keys(): recomputes the
+ * CMAC of the ciphertext and compares its first @p tag_len bytes with
+ * @p tag in constant time.
+ *
+ * @param keys     Keys obtained with hubble_internal_key_day_keys_get().
+ * @param seq_no   Sequence number the data was encrypted with.
+ * @param data     Pointer to the ciphertext.
+ * @param data_len Length of the ciphertext in bytes.
+ * @param tag      Pointer to the received authentication tag.
+ * @param tag_len  Length of the received tag (1 to 16 bytes).
+ *
+ * @return 0 if the tag matches, -EBADMSG if it does not, other negative
+ *         error code on failure.
+ */
+int hubble_internal_data_verify_with_keys(
+	const struct hubble_internal_day_keys *keys, uint16_t seq_no,
+	const uint8_t *data, size_t data_len, const uint8_t *tag,
+	size_t tag_len);
+
+/**
+ * @brief Authenticate and decrypt data with per-packet keys.
+ *
+ * The data is only decrypted if the tag matches.
+ *
+ * @param key           Encryption key from hubble_internal_seq_keys_get().
+ * @param nonce_counter Nonce from hubble_internal_seq_keys_get().
+ * @param data          Pointer to the ciphertext.
+ * @param data_len      Length of the ciphertext in bytes.
+ * @param tag           Pointer to the received authentication tag.
+ * @param tag_len       Length of the received tag (1 to 16 bytes).
+ * @param out           Output buffer for the plaintext, at least
+ *                      @p data_len bytes.
+ *
+ * @return 0 on success, -EBADMSG if the tag does not match, other
+ *         negative error code on failure.
+ */
+int hubble_internal_data_decrypt_with_seq_keys(
+	const uint8_t key[CONFIG_HUBBLE_KEY_SIZE],
+	const uint8_t nonce_counter[HUBBLE_NONCE_BUFFER_SIZE],
+	const uint8_t *data, size_t data_len, const uint8_t *tag,
+	size_t tag_len, uint8_t *out);
+
+/**
+ * @brief Check the authentication tag of a satellite packet.
+ *
+ * Satellite packets carry the payload in clear, the tag is the CMAC of
+ * its encryption. The payload is encrypted again and the CMAC compared
+ * with @p tag in constant time.
+ *
+ * @param key           Encryption key from hubble_internal_seq_keys_get().
+ * @param nonce_counter Nonce from hubble_internal_seq_keys_get().
+ * @param payload       Pointer to the payload carried by the packet.
+ * @param len           Length of the payload, at most
+ *                      HUBBLE_SAT_PAYLOAD_MAX bytes.
+ * @param tag           Pointer to the received authentication tag.
+ * @param tag_len       Length of the received tag (1 to 16 bytes).
+ *
+ * @return 0 if the tag matches, -EBADMSG if it does not, other negative
+ *         error code on failure.
+ */
+int hubble_internal_sat_tag_check(
+	const uint8_t key[CONFIG_HUBBLE_KEY_SIZE],
+	const uint8_t nonce_counter[HUBBLE_NONCE_BUFFER_SIZE],
+	const uint8_t *payload, size_t len, const uint8_t *tag,
+	size_t tag_len);
+
+/**
+ * @brief Pre-compute the values needed to build upcoming advertisements.
+ *
+ * Derives the nonce, encryption key, device ID and the authentication
+ * tag of an empty payload for the sequence numbers
+ * [@p seq_no, @p seq_no + @p count) (wrapping at HUBBLE_MAX_SEQ_COUNTER)
+ * and stores them in the pre-computed slots consumed by
+ * hubble_internal_data_encrypt() and hubble_internal_device_id_get().
+ *
+ * @param time_counter Time counter the values are computed for.
+ * @param seq_no       First sequence number.
+ * @param count        Number of sequence numbers, at most
+ *                     CONFIG_HUBBLE_BLE_NETWORK_PRECOMPUTE_SLOTS.
+ *
+ * @return 0 on success, negative error code on failure.
+ */
+int hubble_internal_precompute(uint32_t time_counter, uint16_t seq_no,
+			       size_t count);
+
 #endif /* SRC_HUBBLE_PRIV_H */
@@ -88,7 +88,7 @@ static int _transmission_params_get(enum hubble_sat_transmission_mode mode,
 	return ret;
 }
 
-static uint8_t _additional_retries_count(uint8_t interval_s)
+uint8_t hubble_internal_sat_additional_retries_get(uint8_t interval_s)
 {
 	uint64_t synced_interval_s;
 
@@ -105,6 +105,25 @@ static uint8_t _additional_retries_count(uint8_t interval_s)
 					     (1000000ULL * interval_s));
 }
 
+/* Number of transmissions and interval between them for a mode */
+static int _transmission_schedule_get(enum hubble_sat_transmission_mode mode,
+				      uint8_t *retries, uint8_t *interval_s)
+{
+	uint8_t extra;
+	int ret;
+
+	ret = _transmission_params_get(mode, retries, interval_s);
+	if (ret < 0) {
+		HUBBLE_LOG_WARNING("Invalid mode given");
+		return ret;
+	}
+
+	extra = hubble_internal_sat_additional_retries_get(*interval_s);
+	*retries = HUBBLE_MIN(UINT8_MAX, *retries + extra);
+
+	return 0;
+}
+
 int hubble_sat_packet_send(const struct hubble_sat_packet *packet,
 			   enum hubble_sat_transmission_mode mode)
 {
@@ -115,15 +134,11 @@ int hubble_sat_packet_send(const struct hubble_sat_packet *packet,
 		return -EINVAL;
 	}
 
-	ret = _transmission_params_get(mode, &retries, &interval_s);
+	ret = _transmission_schedule_get(mode, &retries, &interval_s);
 	if (ret < 0) {
-		HUBBLE_LOG_WARNING("Invalid mode given");
 		return ret;
 	}
 
-	retries = HUBBLE_MIN(UINT8_MAX,
-			     retries + _additional_retries_count(interval_s));
-
 	ret = hubble_sat_port_packet_send(packet, retries, interval_s);
 	if (ret < 0) {
 		HUBBLE_LOG_WARNING(
@@ -135,3 +150,58 @@ int hubble_sat_packet_send(const struct hubble_sat_packet *packet,
 
 	return 0;
 }
+
+#ifdef CONFIG_HUBBLE_SAT_NETWORK_ASYNC
+int hubble_sat_packet_send_async(const struct hubble_sat_packet *packet,
+				 enum hubble_sat_transmission_mode mode,
+				 hubble_sat_packet_sent_cb_t cb,
+				 void *user_data)
+{
+	int ret;
+	uint8_t interval_s, retries;
+
+	if (packet == NULL) {
+		return -EINVAL;
+	}
+
+	ret = _transmission_schedule_get(mode, &retries, &interval_s);
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = hubble_sat_port_packet_send_async(packet, retries, interval_s,
+						cb, user_data);
+	if (ret < 0) {
+		HUBBLE_LOG_WARNING(
+			"Hubble Satellite packet could not be queued");
+	}
+
+	return ret;
+}
+#endif /* CONFIG_HUBBLE_SAT_NETWORK_ASYNC */
+
+#ifdef CONFIG_HUBBLE_SAT_NETWORK_PRIORITY
+int hubble_sat_packet_enqueue(const struct hubble_sat_packet *packet,
+			      enum hubble_sat_transmission_mode mode,
+			      const struct hubble_sat_packet_options *options,
+			      hubble_sat_packet_sent_cb_t cb, void *user_data)
+{
+	static const struct hubble_sat_packet_options defaults = {0};
+	uint8_t interval_s, retries;
+
+	if (packet == NULL) {
+		return -EINVAL;
+	}
+
+	/* Callable from an ISR: the retries covering the clock drift are
+	 * added by the transmit thread.
+	 */
+	if (_transmission_params_get(mode, &retries, &interval_s) < 0) {
+		return -EINVAL;
+	}
+
+	return hubble_sat_port_packet_enqueue(
+		packet, retries, interval_s,
+		(options != NULL) ? options : &defaults, cb, user_data);
+}
+#endif /* CONFIG_HUBBLE_SAT_NETWORK_PRIORITY */
@@ -12,7 +12,9 @@
 #include <hubble/port/sys.h>
 
 #include "reed_solomon_encoder.h"
+#include "reed_solomon_decoder.h"
 #include "hubble_priv.h"
+#include "hubble_sat_packet_tables.h"
 #include "utils/bitarray.h"
 #include "utils/macros.h"
 
@@ -43,38 +45,6 @@
 
 #define HUBBLE_SAT_CHANNEL_DEFAULT           5U
 
-static int _encode(const struct hubble_bitarray *bit_array, int *symbols,
-		   size_t symbols_size)
-{
-	uint8_t symbol = 0U;
-	int symbol_bit_index = 0;
-	int index = 0;
-
-	if ((bit_array->index / HUBBLE_SYMBOL_SIZE) > symbols_size) {
-		return -EINVAL;
-	}
-
-	for (size_t i = 0; i < bit_array->index; i++) {
-		symbol |= (bit_array->data[i / 8] >> (i % 8) & 1)
-			  << ((HUBBLE_SYMBOL_SIZE - symbol_bit_index - 1) %
-			      HUBBLE_SYMBOL_SIZE);
-		symbol_bit_index++;
-		if ((i + 1) % HUBBLE_SYMBOL_SIZE == 0) {
-			symbols[index] = symbol;
-			symbol = 0;
-			symbol_bit_index = 0;
-			index++;
-		}
-	}
-
-	/* Additional padding needed. */
-	if ((bit_array->index % 6) > 0) {
-		symbols[index++] = symbol;
-	}
-
-	return index;
-}
-
 static int _packet_payload_ecc_get(size_t len)
 {
 	int ecc;
@@ -127,29 +97,19 @@ static int8_t _packet_payload_size_get(size_t len, uint8_t *length,
 	return 0;
 }
 
-static int _whitening(uint8_t seed, int *symbols, size_t len)
+/* Whitening is its own inverse, it also removes it */
+static int _whitening(uint8_t channel, uint8_t *symbols, size_t len)
 {
-	uint8_t state;
-	size_t symbols_idx = 0U;
-	uint8_t symbol_state = 0U;
+	const uint8_t *sequence;
 
-	seed = 0x40 | seed;
-	state = (3 << 5) | seed;
-
-	for (int i = 0; i < len * 6; i++) {
-		int fb;
-
-		/*pack 6 bits into one symbol (MSB-first within the 6-bit symbol) */
-		symbol_state |= (((state & 0x40) >> 6) << (5 - (i % 6)));
-
-		/* Every six bits we have to XOR */
-		if ((i % 6) == 5) {
-			symbols[symbols_idx++] ^= symbol_state;
-			symbol_state = 0;
-		}
+	if ((channel >= HUBBLE_SAT_NUM_CHANNELS) ||
+	    (len > HUBBLE_SAT_WHITENING_SIZE)) {
+		return -EINVAL;
+	}
 
-		fb = ((state >> 6U) ^ (state >> 3U)) & 1U;
-		state = ((state << 1) & 0x7FU) | fb;
+	sequence = _whitening_symbols[channel];
+	for (size_t i = 0; i < len; i++) {
+		symbols[i] ^= sequence[i];
 	}
 
 	return 0;
@@ -160,8 +120,7 @@ int hubble_sat_packet_get(struct hubble_sat_packet *packet, const void *payload,
 {
 	int ret;
 	struct hubble_bitarray bit_array;
-	int symbols[HUBBLE_PACKET_MAX_SIZE] = {0};
-	int *rs_symbols;
+	uint8_t *symbols;
 	uint8_t ecc, payload_symbols_length, payload_length_symbol, channel;
 	uint8_t auth_tag[HUBBLE_AUTH_TAG_SIZE / HUBBLE_BITS_PER_BYTE];
 	uint8_t out[HUBBLE_PAYLOAD_MAX_SIZE];
@@ -193,50 +152,20 @@ int hubble_sat_packet_get(struct hubble_sat_packet *packet, const void *payload,
 		return -EINVAL;
 	}
 
-	/* Let's encode physical frame (without preamble) */
-	hubble_bitarray_init(&bit_array);
-
 #define _CHECK_RET(_ret)                                                       \
 	if (_ret < 0) {                                                        \
 		return _ret;                                                   \
 	}
 
-	ret = hubble_bitarray_append(
-		&bit_array, (uint8_t *)&(uint8_t){HUBBLE_PHY_PROTOCOL_VERSION},
-		HUBBLE_PHY_PROTOCOL_SIZE);
-	_CHECK_RET(ret);
-
-	ret = hubble_bitarray_append(&bit_array, &payload_length_symbol,
-				     HUBBLE_PHY_PAYLOAD_SIZE);
-	_CHECK_RET(ret);
-
-	ret = hubble_bitarray_append(
-		&bit_array, (uint8_t *)&(uint8_t){packet->hopping_sequence},
-		HUBBLE_PHY_HOP_INFO_SIZE);
-	_CHECK_RET(ret);
-
-	ret = hubble_bitarray_append(&bit_array,
-				     (uint8_t *)&(uint8_t){packet->channel},
-				     HUBBLE_PHY_CHANNEL_SIZE);
-	_CHECK_RET(ret);
-
-	ret = _encode(&bit_array, symbols, HUBBLE_PHY_SYMBOLS_SIZE);
-	_CHECK_RET(ret);
-
-	for (uint8_t i = 0; i < HUBBLE_PHY_SYMBOLS_SIZE; i++) {
-		packet->data[i] = symbols[i];
-	}
-	packet->length = HUBBLE_PHY_SYMBOLS_SIZE;
-
-	rse_gf_generate();
-	rse_poly_generate(HUBBLE_PHY_ECC_SYMBOLS_SIZE / 2);
-	rs_symbols = rse_rs_encode(symbols, HUBBLE_PHY_SYMBOLS_SIZE,
-				   HUBBLE_PHY_ECC_SYMBOLS_SIZE / 2);
-
-	for (uint8_t i = 0; i < HUBBLE_PHY_ECC_SYMBOLS_SIZE; i++) {
-		packet->data[i + packet->length] = rs_symbols[i];
-	}
-	packet->length += HUBBLE_PHY_ECC_SYMBOLS_SIZE;
+	/* Physical frame (without preamble), only the 4 least significant
+	 * bits of the channel are sent.
+	 */
+	memcpy(packet->data,
+	       _phy_headers[payload_length_symbol][packet->hopping_sequence]
+			   [packet->channel &
+			    (HUBBLE_BIT(HUBBLE_PHY_CHANNEL_SIZE) - 1U)],
+	       HUBBLE_SAT_PHY_HEADER_SIZE);
+	packet->length = HUBBLE_SAT_PHY_HEADER_SIZE;
 
 	/* End of physical frame */
 
@@ -252,15 +181,14 @@ int hubble_sat_packet_get(struct hubble_sat_packet *packet, const void *payload,
 	hubble_bitarray_init(&bit_array);
 
 	/* Payload version */
-	ret = hubble_bitarray_append(
-		&bit_array,
-		(uint8_t *)&(uint8_t){HUBBLE_PAYLOAD_PROTOCOL_VERSION},
+	ret = hubble_bitarray_append_value(
+		&bit_array, HUBBLE_PAYLOAD_PROTOCOL_VERSION,
 		HUBBLE_PAYLOAD_PROTOCOL_VERSION_SIZE);
 	_CHECK_RET(ret);
 
 	/* Sequence number */
-	ret = hubble_bitarray_append(&bit_array, (uint8_t *)&seq_no,
-				     HUBBLE_SEQUENCE_NUMBER_SIZE);
+	ret = hubble_bitarray_append_value(&bit_array, seq_no,
+					   HUBBLE_SEQUENCE_NUMBER_SIZE);
 	_CHECK_RET(ret);
 
 	/* Device ID */
@@ -277,31 +205,251 @@ int hubble_sat_packet_get(struct hubble_sat_packet *packet, const void *payload,
 				     length * HUBBLE_BITS_PER_BYTE);
 	_CHECK_RET(ret);
 
-	/* This returns the number of symbols */
-	ret = _encode(&bit_array, symbols, HUBBLE_PACKET_MAX_SIZE);
-	_CHECK_RET(ret);
-
-	/* generate error control symbols */
-	rse_gf_generate();
+	/* generate error control symbols, they are appended to the symbols
+	 * since they are whitened too (lfsr7 state).
+	 */
 	ecc = _packet_payload_ecc_get(length);
-	rse_poly_generate(ecc / 2);
-	rs_symbols = rse_rs_encode(symbols, ret, ecc / 2);
+	symbols = &packet->data[packet->length];
 
-	/* We need to append rs_symbols to symbols before whitening them
-	 * due lfsr7 state.
-	 */
-	memcpy(&symbols[ret], rs_symbols, ecc * sizeof(int));
+	ret = hubble_bitarray_symbols_get(&bit_array, symbols,
+					  payload_symbols_length);
+	_CHECK_RET(ret);
 
-	/* data whitening symbols before add them to the packet */
-	ret = _whitening(packet->channel, symbols, ret + ecc);
+	ret = rse_rs_encode(symbols, payload_symbols_length, ecc / 2,
+			    &symbols[payload_symbols_length]);
+	_CHECK_RET(ret);
+
+	ret = _whitening(packet->channel, symbols,
+			 payload_symbols_length + ecc);
 	_CHECK_RET(ret);
 
-	for (uint8_t i = 0; i < payload_symbols_length + ecc; i++) {
-		packet->data[packet->length + i] = symbols[i];
-	}
 	packet->length += payload_symbols_length + ecc;
 
 #undef _CHECK_RET
 
 	return 0;
 }
+
+#ifdef CONFIG_HUBBLE_SAT_NETWORK_DECODER
+
+/* Largest value of a symbol */
+#define HUBBLE_SYMBOL_MAX ((1U << HUBBLE_SYMBOL_SIZE) - 1U)
+
+/* Payload length for each payload length symbol of the PHY header */
+static const uint8_t _payload_lengths[] = {0, 4, 9, 13};
+
+/* Reads a field the way hubble_bitarray_append() wrote it */
+static void _bits_get(const uint8_t *symbols, size_t *offset, uint8_t *out,
+		      size_t bits)
+{
+	memset(out, 0,
+	       (bits + HUBBLE_BITS_PER_BYTE - 1) / HUBBLE_BITS_PER_BYTE);
+
+	for (size_t i = bits; i-- > 0; (*offset)++) {
+		int bit = (symbols[*offset / HUBBLE_SYMBOL_SIZE] >>
+			   (HUBBLE_SYMBOL_SIZE - 1 -
+			    (*offset % HUBBLE_SYMBOL_SIZE))) &
+			  1;
+
+		out[i / HUBBLE_BITS_PER_BYTE] |= bit
+						 << (i % HUBBLE_BITS_PER_BYTE);
+	}
+}
+
+/* Copies symbols of a codeword, returns the number of erasures */
+static int _symbols_get(const struct hubble_sat_packet *packet,
+			const bool *erased, size_t start, size_t len,
+			uint8_t *symbols, int *erasures)
+{
+	int count = 0;
+
+	for (size_t i = 0; i < len; i++) {
+		uint8_t symbol = packet->data[start + i];
+
+		if (erased[start + i] || (symbol > HUBBLE_SYMBOL_MAX)) {
+			erasures[count++] = i;
+			symbol = 0U;
+		}
+		symbols[i] = symbol;
+	}
+
+	return count;
+}
+
+int hubble_sat_packet_frame_get(const struct hubble_sat_packet *packet,
+				const uint8_t *erasures, size_t erasure_count,
+				struct hubble_sat_frame *frame)
+{
+	int ret;
+	int count;
+	int ecc;
+	bool erased[HUBBLE_PACKET_MAX_SIZE] = {false};
+	uint8_t symbols[HUBBLE_PACKET_MAX_SIZE];
+	int positions[HUBBLE_PACKET_MAX_SIZE];
+	uint8_t field[sizeof(uint32_t)];
+	uint8_t payload_symbols_length, payload_length_symbol;
+	size_t offset = 0U;
+	size_t length;
+	size_t padding;
+
+	if ((packet == NULL) || (frame == NULL) ||
+	    ((erasures == NULL) && (erasure_count > 0U)) ||
+	    (packet->length < HUBBLE_SAT_PHY_HEADER_SIZE) ||
+	    (packet->length > HUBBLE_PACKET_MAX_SIZE) ||
+	    (packet->channel >= HUBBLE_SAT_NUM_CHANNELS)) {
+		return -EINVAL;
+	}
+
+	for (size_t i = 0; i < erasure_count; i++) {
+		if (erasures[i] >= packet->length) {
+			return -EINVAL;
+		}
+		erased[erasures[i]] = true;
+	}
+
+	/* Physical frame header, it is not whitened */
+	count = _symbols_get(packet, erased, 0U, HUBBLE_SAT_PHY_HEADER_SIZE,
+			     symbols, positions);
+	ret = rsd_rs_decode(symbols, HUBBLE_PHY_SYMBOLS_SIZE,
+			    HUBBLE_PHY_ECC_SYMBOLS_SIZE / 2, positions, count);
+	if (ret < 0) {
+		return ret;
+	}
+	frame->corrected = ret;
+
+	_bits_get(symbols, &offset, field, HUBBLE_PHY_PROTOCOL_SIZE);
+	if (field[0] != HUBBLE_PHY_PROTOCOL_VERSION) {
+		return -ENOTSUP;
+	}
+
+	_bits_get(symbols, &offset, field, HUBBLE_PHY_PAYLOAD_SIZE);
+	length = _payload_lengths[field[0]];
+
+	_bits_get(symbols, &offset, field, HUBBLE_PHY_HOP_INFO_SIZE);
+	frame->hopping_sequence = field[0];
+
+	_bits_get(symbols, &offset, field, HUBBLE_PHY_CHANNEL_SIZE);
+	frame->channel = field[0];
+
+	if (frame->channel !=
+	    (packet->channel & (HUBBLE_BIT(HUBBLE_PHY_CHANNEL_SIZE) - 1U))) {
+		return -EBADMSG;
+	}
+
+	if (_packet_payload_size_get(length, &payload_symbols_length,
+				     &payload_length_symbol) < 0) {
+		return -EINVAL;
+	}
+	ecc = _packet_payload_ecc_get(length);
+
+	if (packet->length !=
+	    (HUBBLE_SAT_PHY_HEADER_SIZE + payload_symbols_length + ecc)) {
+		return -EINVAL;
+	}
+
+	/* Packet payload, erased symbols are whitened too but it does not
+	 * matter as their value is ignored.
+	 */
+	count = _symbols_get(packet, erased, HUBBLE_SAT_PHY_HEADER_SIZE,
+			     payload_symbols_length + ecc, symbols, positions);
+	ret = _whitening(packet->channel, symbols,
+			 payload_symbols_length + ecc);
+	if (ret < 0) {
+		return ret;
+	}
+	ret = rsd_rs_decode(symbols, payload_symbols_length, ecc / 2,
+			    positions, count);
+	if (ret < 0) {
+		return ret;
+	}
+	frame->corrected += ret;
+
+	offset = 0U;
+	_bits_get(symbols, &offset, field,
+		  HUBBLE_PAYLOAD_PROTOCOL_VERSION_SIZE);
+	if (field[0] != HUBBLE_PAYLOAD_PROTOCOL_VERSION) {
+		return -ENOTSUP;
+	}
+
+	_bits_get(symbols, &offset, field, HUBBLE_SEQUENCE_NUMBER_SIZE);
+	frame->seq_no = field[0] | (field[1] << 8);
+
+	_bits_get(symbols, &offset, field, HUBBLE_DEVICE_ID_SIZE);
+	memcpy(&frame->eid, field, sizeof(frame->eid));
+
+	_bits_get(symbols, &offset, frame->auth_tag, HUBBLE_AUTH_TAG_SIZE);
+
+	_bits_get(symbols, &offset, frame->data,
+		  length * HUBBLE_BITS_PER_BYTE);
+	frame->data_len = length;
+
+	/* Padding of the last symbol must be zero */
+	padding = (payload_symbols_length * HUBBLE_SYMBOL_SIZE) - offset;
+	if ((symbols[payload_symbols_length - 1] &
+	     (HUBBLE_BIT(padding) - 1U)) != 0) {
+		return -EBADMSG;
+	}
+
+	return 0;
+}
+
+int hubble_sat_packet_dewhiten(uint8_t channel, uint8_t *symbols, size_t len)
+{
+	if ((symbols == NULL) && (len > 0U)) {
+		return -EINVAL;
+	}
+
+	return _whitening(channel, symbols, len);
+}
+
+int hubble_sat_frame_verify(const struct hubble_sat_frame *frame,
+			    const void *key, uint32_t time_counter,
+			    void *payload, size_t *length)
+{
+	int ret;
+	struct hubble_internal_day_keys keys;
+	uint8_t nonce_counter[HUBBLE_NONCE_BUFFER_SIZE];
+	uint8_t encryption_key[CONFIG_HUBBLE_KEY_SIZE];
+
+	if ((frame == NULL) || (key == NULL) || (payload == NULL) ||
+	    (length == NULL) || (frame->data_len > HUBBLE_SAT_PAYLOAD_MAX)) {
+		return -EINVAL;
+	}
+
+	ret = hubble_internal_key_day_keys_get(key, time_counter, &keys);
+	if (ret != 0) {
+		return ret;
+	}
+
+	/* Not worth deriving anything for a device ID of another key */
+	if (keys.device_id != frame->eid) {
+		ret = -EBADMSG;
+		goto exit;
+	}
+
+	ret = hubble_internal_seq_keys_get(keys.nonce_key, keys.encryption_key,
+					   frame->seq_no, nonce_counter,
+					   encryption_key);
+	if (ret != 0) {
+		goto exit;
+	}
+
+	/* Gives the payload back once the tag is checked */
+	ret = hubble_internal_sat_tag_check(encryption_key, nonce_counter,
+					    frame->data, frame->data_len,
+					    frame->auth_tag,
+					    sizeof(frame->auth_tag));
+	if (ret == 0) {
+		memcpy(payload, frame->data, frame->data_len);
+		*length = frame->data_len;
+	}
+
+exit:
+	hubble_crypto_zeroize(&keys, sizeof(keys));
+	hubble_crypto_zeroize(nonce_counter, sizeof(nonce_counter));
+	hubble_crypto_zeroize(encryption_key, sizeof(encryption_key));
+
+	return ret;
+}
+
+#endif /* CONFIG_HUBBLE_SAT_NETWORK_DECODER */
@@ -84,33 +84,6 @@ static bool _payload_length_check(size_t length)
 			       8);
 }
 
-static int _encode(const struct hubble_bitarray *bit_array, int *symbols,
-		   size_t symbols_size)
-{
-	uint8_t symbol = 0U;
-	int symbol_bit_index = 0;
-	int index = 0;
-
-	if ((bit_array->index / HUBBLE_SYMBOL_SIZE) > symbols_size) {
-		return -EINVAL;
-	}
-
-	for (size_t i = 0; i < bit_array->index; i++) {
-		symbol |= (bit_array->data[i / 8] >> (i % 8) & 1)
-			  << ((HUBBLE_SYMBOL_SIZE - symbol_bit_index - 1) %
-			      HUBBLE_SYMBOL_SIZE);
-		symbol_bit_index++;
-		if ((i + 1) % HUBBLE_SYMBOL_SIZE == 0) {
-			symbols[index] = symbol;
-			symbol = 0U;
-			symbol_bit_index = 0;
-			index++;
-		}
-	}
-
-	return index;
-}
-
 int hubble_sat_static_device_id_set(uint64_t id)
 {
 	_device_id = id;
@@ -129,8 +102,8 @@ int hubble_sat_packet_get(struct hubble_sat_packet *packet, const void *payload,
 	uint8_t symbol_index;
 	uint8_t ecc;
 	uint8_t channel;
-	int symbols[HUBBLE_PACKET_FRAME_MAX_SIZE];
-	int *rs_symbols;
+	uint8_t symbols[HUBBLE_PACKET_FRAME_MAX_SIZE];
+	uint8_t rs_symbols[2 * RSE_TT_MAX];
 
 	if (!_payload_length_check(length)) {
 		return -EINVAL;
@@ -195,17 +168,21 @@ int hubble_sat_packet_get(struct hubble_sat_packet *packet, const void *payload,
 		number_of_symbols++;
 	}
 
-	ret = _encode(&bit_array, symbols, HUBBLE_PACKET_MAX_SIZE);
+	ret = hubble_bitarray_symbols_get(&bit_array, symbols,
+					  HUBBLE_PACKET_FRAME_MAX_SIZE);
+	if (ret < 0) {
+		return ret;
+	}
 
 	/* Packet length field == 11 + <5 bit value represented in header symbols> */
 	packet_length = symbol_index;
 
 	/* generate error control symbols */
-	rse_gf_generate();
-
 	ecc = _hubble_mac_error_control_symbols[symbol_index] / 2U;
-	rse_poly_generate(ecc);
-	rs_symbols = rse_rs_encode(symbols, number_of_symbols, ecc);
+	ret = rse_rs_encode(symbols, number_of_symbols, ecc, rs_symbols);
+	if (ret < 0) {
+		return ret;
+	}
 
 	for (uint8_t mac_idx = 0, rs_idx = 0, i = 0;
 	     i < _hubble_packet_total_symbols[symbol_index]; i++) {
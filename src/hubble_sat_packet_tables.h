@@ -0,0 +1,469 @@
+/*
+ * Copyright (c) 2026 Hubble Network, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * This file contents was automatically generated by
+ * tools/sat_packet_tables.py, do not edit.
+ */
+
+#ifndef SRC_HUBBLE_SAT_PACKET_TABLES_H
+#define SRC_HUBBLE_SAT_PACKET_TABLES_H
+
+#include <stdint.h>
+
+#include <hubble/port/sat_radio.h>
+
+/* Symbols of a payload and its parity symbols, the PHY header excluded */
+#define HUBBLE_SAT_WHITENING_SIZE 46U
+
+/* Whitening symbols, XORed to the payload symbols, for each channel */
+static const uint8_t _whitening_symbols[HUBBLE_SAT_NUM_CHANNELS]
+				       [HUBBLE_SAT_WHITENING_SIZE] = {
+	/* Channel 0 */
+	{
+		48, 25, 42, 28, 61, 40, 21, 31, 18, 35, 28, 31, 48, 59, 50, 50,
+		16, 8, 38, 11, 43, 24, 12, 53, 14, 30, 52, 10, 47, 41, 17, 46,
+		15, 56, 29, 57, 25, 8, 4, 19, 5, 53, 44, 6, 26, 39,
+	},
+	/* Channel 1 */
+	{
+		48, 59, 50, 50, 16, 8, 38, 11, 43, 24, 12, 53, 14, 30, 52, 10,
+		47, 41, 17, 46, 15, 56, 29, 57, 25, 8, 4, 19, 5, 53, 44, 6, 26,
+		39, 15, 26, 5, 23, 52, 40, 55, 7, 60, 14, 60, 44,
+	},
+	/* Channel 2 */
+	{
+		49, 29, 27, 1, 38, 41, 51, 54, 33, 21, 61, 10, 13, 49, 63, 3,
+		47, 11, 9, 0, 34, 24, 46, 45, 32, 51, 20, 57, 59, 16, 42, 62,
+		37, 6, 56, 63, 33, 55, 37, 36, 32, 17, 12, 23, 22, 48,
+	},
+	/* Channel 3 */
+	{
+		49, 63, 3, 47, 11, 9, 0, 34, 24, 46, 45, 32, 51, 20, 57, 59, 16,
+		42, 62, 37, 6, 56, 63, 33, 55, 37, 36, 32, 17, 12, 23, 22, 48,
+		25, 42, 28, 61, 40, 21, 31, 18, 35, 28, 31, 48, 59,
+	},
+	/* Channel 4 */
+	{
+		50, 16, 8, 38, 11, 43, 24, 12, 53, 14, 30, 52, 10, 47, 41, 17,
+		46, 15, 56, 29, 57, 25, 8, 4, 19, 5, 53, 44, 6, 26, 39, 15, 26,
+		5, 23, 52, 40, 55, 7, 60, 14, 60, 44, 36, 2, 9,
+	},
+	/* Channel 5 */
+	{
+		50, 50, 16, 8, 38, 11, 43, 24, 12, 53, 14, 30, 52, 10, 47, 41,
+		17, 46, 15, 56, 29, 57, 25, 8, 4, 19, 5, 53, 44, 6, 26, 39, 15,
+		26, 5, 23, 52, 40, 55, 7, 60, 14, 60, 44, 36, 2,
+	},
+	/* Channel 6 */
+	{
+		51, 20, 57, 59, 16, 42, 62, 37, 6, 56, 63, 33, 55, 37, 36, 32,
+		17, 12, 23, 22, 48, 25, 42, 28, 61, 40, 21, 31, 18, 35, 28, 31,
+		48, 59, 50, 50, 16, 8, 38, 11, 43, 24, 12, 53, 14, 30,
+	},
+	/* Channel 7 */
+	{
+		51, 54, 33, 21, 61, 10, 13, 49, 63, 3, 47, 11, 9, 0, 34, 24, 46,
+		45, 32, 51, 20, 57, 59, 16, 42, 62, 37, 6, 56, 63, 33, 55, 37,
+		36, 32, 17, 12, 23, 22, 48, 25, 42, 28, 61, 40, 21,
+	},
+	/* Channel 8 */
+	{
+		52, 10, 47, 41, 17, 46, 15, 56, 29, 57, 25, 8, 4, 19, 5, 53, 44,
+		6, 26, 39, 15, 26, 5, 23, 52, 40, 55, 7, 60, 14, 60, 44, 36, 2,
+		9, 34, 58, 54, 3, 13, 19, 39, 45, 2, 43, 58,
+	},
+	/* Channel 9 */
+	{
+		52, 40, 55, 7, 60, 14, 60, 44, 36, 2, 9, 34, 58, 54, 3, 13, 19,
+		39, 45, 2, 43, 58, 20, 27, 35, 62, 7, 30, 22, 18, 1, 4, 49, 29,
+		27, 1, 38, 41, 51, 54, 33, 21, 61, 10, 13, 49,
+	},
+	/* Channel 10 */
+	{
+		53, 14, 30, 52, 10, 47, 41, 17, 46, 15, 56, 29, 57, 25, 8, 4,
+		19, 5, 53, 44, 6, 26, 39, 15, 26, 5, 23, 52, 40, 55, 7, 60, 14,
+		60, 44, 36, 2, 9, 34, 58, 54, 3, 13, 19, 39, 45,
+	},
+	/* Channel 11 */
+	{
+		53, 44, 6, 26, 39, 15, 26, 5, 23, 52, 40, 55, 7, 60, 14, 60, 44,
+		36, 2, 9, 34, 58, 54, 3, 13, 19, 39, 45, 2, 43, 58, 20, 27, 35,
+		62, 7, 30, 22, 18, 1, 4, 49, 29, 27, 1, 38,
+	},
+	/* Channel 12 */
+	{
+		54, 3, 13, 19, 39, 45, 2, 43, 58, 20, 27, 35, 62, 7, 30, 22, 18,
+		1, 4, 49, 29, 27, 1, 38, 41, 51, 54, 33, 21, 61, 10, 13, 49, 63,
+		3, 47, 11, 9, 0, 34, 24, 46, 45, 32, 51, 20,
+	},
+	/* Channel 13 */
+	{
+		54, 33, 21, 61, 10, 13, 49, 63, 3, 47, 11, 9, 0, 34, 24, 46, 45,
+		32, 51, 20, 57, 59, 16, 42, 62, 37, 6, 56, 63, 33, 55, 37, 36,
+		32, 17, 12, 23, 22, 48, 25, 42, 28, 61, 40, 21, 31,
+	},
+	/* Channel 14 */
+	{
+		55, 7, 60, 14, 60, 44, 36, 2, 9, 34, 58, 54, 3, 13, 19, 39, 45,
+		2, 43, 58, 20, 27, 35, 62, 7, 30, 22, 18, 1, 4, 49, 29, 27, 1,
+		38, 41, 51, 54, 33, 21, 61, 10, 13, 49, 63, 3,
+	},
+	/* Channel 15 */
+	{
+		55, 37, 36, 32, 17, 12, 23, 22, 48, 25, 42, 28, 61, 40, 21, 31,
+		18, 35, 28, 31, 48, 59, 50, 50, 16, 8, 38, 11, 43, 24, 12, 53,
+		14, 30, 52, 10, 47, 41, 17, 46, 15, 56, 29, 57, 25, 8,
+	},
+	/* Channel 16 */
+	{
+		56, 29, 57, 25, 8, 4, 19, 5, 53, 44, 6, 26, 39, 15, 26, 5, 23,
+		52, 40, 55, 7, 60, 14, 60, 44, 36, 2, 9, 34, 58, 54, 3, 13, 19,
+		39, 45, 2, 43, 58, 20, 27, 35, 62, 7, 30, 22,
+	},
+	/* Channel 17 */
+	{
+		56, 63, 33, 55, 37, 36, 32, 17, 12, 23, 22, 48, 25, 42, 28, 61,
+		40, 21, 31, 18, 35, 28, 31, 48, 59, 50, 50, 16, 8, 38, 11, 43,
+		24, 12, 53, 14, 30, 52, 10, 47, 41, 17, 46, 15, 56, 29,
+	},
+	/* Channel 18 */
+	{
+		57, 25, 8, 4, 19, 5, 53, 44, 6, 26, 39, 15, 26, 5, 23, 52, 40,
+		55, 7, 60, 14, 60, 44, 36, 2, 9, 34, 58, 54, 3, 13, 19, 39, 45,
+		2, 43, 58, 20, 27, 35, 62, 7, 30, 22, 18, 1,
+	},
+};
+
+/* PHY header data and parity symbols */
+#define HUBBLE_SAT_PHY_HEADER_SIZE 6U
+
+/*
+ * PHY headers of version 1 for each payload length symbol, hopping
+ * sequence and channel field (the 4 least significant bits of the
+ * channel).
+ */
+static const uint8_t _phy_headers[4][4][16]
+				 [HUBBLE_SAT_PHY_HEADER_SIZE] = {
+	/* Payload length symbol 0 */
+	{
+		/* Hopping sequence 0 */
+		{
+			{4, 0, 24, 38, 28, 37},
+			{4, 1, 6, 59, 13, 21},
+			{4, 2, 36, 28, 62, 6},
+			{4, 3, 58, 1, 47, 54},
+			{4, 4, 35, 17, 27, 32},
+			{4, 5, 61, 12, 10, 16},
+			{4, 6, 31, 43, 57, 3},
+			{4, 7, 1, 54, 40, 51},
+			{4, 8, 45, 11, 18, 47},
+			{4, 9, 51, 22, 3, 31},
+			{4, 10, 17, 49, 48, 12},
+			{4, 11, 15, 44, 33, 60},
+			{4, 12, 22, 60, 21, 42},
+			{4, 13, 8, 33, 4, 26},
+			{4, 14, 42, 6, 55, 9},
+			{4, 15, 52, 27, 38, 57},
+		},
+		/* Hopping sequence 1 */
+		{
+			{4, 16, 49, 63, 0, 49},
+			{4, 17, 47, 34, 17, 1},
+			{4, 18, 13, 5, 34, 18},
+			{4, 19, 19, 24, 51, 34},
+			{4, 20, 10, 8, 7, 52},
+			{4, 21, 20, 21, 22, 4},
+			{4, 22, 54, 50, 37, 23},
+			{4, 23, 40, 47, 52, 39},
+			{4, 24, 4, 18, 14, 59},
+			{4, 25, 26, 15, 31, 11},
+			{4, 26, 56, 40, 44, 24},
+			{4, 27, 38, 53, 61, 40},
+			{4, 28, 63, 37, 9, 62},
+			{4, 29, 33, 56, 24, 14},
+			{4, 30, 3, 31, 43, 29},
+			{4, 31, 29, 2, 58, 45},
+		},
+		/* Hopping sequence 2 */
+		{
+			{4, 32, 9, 20, 36, 13},
+			{4, 33, 23, 9, 53, 61},
+			{4, 34, 53, 46, 6, 46},
+			{4, 35, 43, 51, 23, 30},
+			{4, 36, 50, 35, 35, 8},
+			{4, 37, 44, 62, 50, 56},
+			{4, 38, 14, 25, 1, 43},
+			{4, 39, 16, 4, 16, 27},
+			{4, 40, 60, 57, 42, 7},
+			{4, 41, 34, 36, 59, 55},
+			{4, 42, 0, 3, 8, 36},
+			{4, 43, 30, 30, 25, 20},
+			{4, 44, 7, 14, 45, 2},
+			{4, 45, 25, 19, 60, 50},
+			{4, 46, 59, 52, 15, 33},
+			{4, 47, 37, 41, 30, 17},
+		},
+		/* Hopping sequence 3 */
+		{
+			{4, 48, 32, 13, 56, 25},
+			{4, 49, 62, 16, 41, 41},
+			{4, 50, 28, 55, 26, 58},
+			{4, 51, 2, 42, 11, 10},
+			{4, 52, 27, 58, 63, 28},
+			{4, 53, 5, 39, 46, 44},
+			{4, 54, 39, 0, 29, 63},
+			{4, 55, 57, 29, 12, 15},
+			{4, 56, 21, 32, 54, 19},
+			{4, 57, 11, 61, 39, 35},
+			{4, 58, 41, 26, 20, 48},
+			{4, 59, 55, 7, 5, 0},
+			{4, 60, 46, 23, 49, 22},
+			{4, 61, 48, 10, 32, 38},
+			{4, 62, 18, 45, 19, 53},
+			{4, 63, 12, 48, 2, 5},
+		},
+	},
+	/* Payload length symbol 1 */
+	{
+		/* Hopping sequence 0 */
+		{
+			{5, 0, 30, 14, 27, 29},
+			{5, 1, 0, 19, 10, 45},
+			{5, 2, 34, 52, 57, 62},
+			{5, 3, 60, 41, 40, 14},
+			{5, 4, 37, 57, 28, 24},
+			{5, 5, 59, 36, 13, 40},
+			{5, 6, 25, 3, 62, 59},
+			{5, 7, 7, 30, 47, 11},
+			{5, 8, 43, 35, 21, 23},
+			{5, 9, 53, 62, 4, 39},
+			{5, 10, 23, 25, 55, 52},
+			{5, 11, 9, 4, 38, 4},
+			{5, 12, 16, 20, 18, 18},
+			{5, 13, 14, 9, 3, 34},
+			{5, 14, 44, 46, 48, 49},
+			{5, 15, 50, 51, 33, 1},
+		},
+		/* Hopping sequence 1 */
+		{
+			{5, 16, 55, 23, 7, 9},
+			{5, 17, 41, 10, 22, 57},
+			{5, 18, 11, 45, 37, 42},
+			{5, 19, 21, 48, 52, 26},
+			{5, 20, 12, 32, 0, 12},
+			{5, 21, 18, 61, 17, 60},
+			{5, 22, 48, 26, 34, 47},
+			{5, 23, 46, 7, 51, 31},
+			{5, 24, 2, 58, 9, 3},
+			{5, 25, 28, 39, 24, 51},
+			{5, 26, 62, 0, 43, 32},
+			{5, 27, 32, 29, 58, 16},
+			{5, 28, 57, 13, 14, 6},
+			{5, 29, 39, 16, 31, 54},
+			{5, 30, 5, 55, 44, 37},
+			{5, 31, 27, 42, 61, 21},
+		},
+		/* Hopping sequence 2 */
+		{
+			{5, 32, 15, 60, 35, 53},
+			{5, 33, 17, 33, 50, 5},
+			{5, 34, 51, 6, 1, 22},
+			{5, 35, 45, 27, 16, 38},
+			{5, 36, 52, 11, 36, 48},
+			{5, 37, 42, 22, 53, 0},
+			{5, 38, 8, 49, 6, 19},
+			{5, 39, 22, 44, 23, 35},
+			{5, 40, 58, 17, 45, 63},
+			{5, 41, 36, 12, 60, 15},
+			{5, 42, 6, 43, 15, 28},
+			{5, 43, 24, 54, 30, 44},
+			{5, 44, 1, 38, 42, 58},
+			{5, 45, 31, 59, 59, 10},
+			{5, 46, 61, 28, 8, 25},
+			{5, 47, 35, 1, 25, 41},
+		},
+		/* Hopping sequence 3 */
+		{
+			{5, 48, 38, 37, 63, 33},
+			{5, 49, 56, 56, 46, 17},
+			{5, 50, 26, 31, 29, 2},
+			{5, 51, 4, 2, 12, 50},
+			{5, 52, 29, 18, 56, 36},
+			{5, 53, 3, 15, 41, 20},
+			{5, 54, 33, 40, 26, 7},
+			{5, 55, 63, 53, 11, 55},
+			{5, 56, 19, 8, 49, 43},
+			{5, 57, 13, 21, 32, 27},
+			{5, 58, 47, 50, 19, 8},
+			{5, 59, 49, 47, 2, 56},
+			{5, 60, 40, 63, 54, 46},
+			{5, 61, 54, 34, 39, 30},
+			{5, 62, 20, 5, 20, 13},
+			{5, 63, 10, 24, 5, 61},
+		},
+	},
+	/* Payload length symbol 2 */
+	{
+		/* Hopping sequence 0 */
+		{
+			{6, 0, 20, 53, 18, 22},
+			{6, 1, 10, 40, 3, 38},
+			{6, 2, 40, 15, 48, 53},
+			{6, 3, 54, 18, 33, 5},
+			{6, 4, 47, 2, 21, 19},
+			{6, 5, 49, 31, 4, 35},
+			{6, 6, 19, 56, 55, 48},
+			{6, 7, 13, 37, 38, 0},
+			{6, 8, 33, 24, 28, 28},
+			{6, 9, 63, 5, 13, 44},
+			{6, 10, 29, 34, 62, 63},
+			{6, 11, 3, 63, 47, 15},
+			{6, 12, 26, 47, 27, 25},
+			{6, 13, 4, 50, 10, 41},
+			{6, 14, 38, 21, 57, 58},
+			{6, 15, 56, 8, 40, 10},
+		},
+		/* Hopping sequence 1 */
+		{
+			{6, 16, 61, 44, 14, 2},
+			{6, 17, 35, 49, 31, 50},
+			{6, 18, 1, 22, 44, 33},
+			{6, 19, 31, 11, 61, 17},
+			{6, 20, 6, 27, 9, 7},
+			{6, 21, 24, 6, 24, 55},
+			{6, 22, 58, 33, 43, 36},
+			{6, 23, 36, 60, 58, 20},
+			{6, 24, 8, 1, 0, 8},
+			{6, 25, 22, 28, 17, 56},
+			{6, 26, 52, 59, 34, 43},
+			{6, 27, 42, 38, 51, 27},
+			{6, 28, 51, 54, 7, 13},
+			{6, 29, 45, 43, 22, 61},
+			{6, 30, 15, 12, 37, 46},
+			{6, 31, 17, 17, 52, 30},
+		},
+		/* Hopping sequence 2 */
+		{
+			{6, 32, 5, 7, 42, 62},
+			{6, 33, 27, 26, 59, 14},
+			{6, 34, 57, 61, 8, 29},
+			{6, 35, 39, 32, 25, 45},
+			{6, 36, 62, 48, 45, 59},
+			{6, 37, 32, 45, 60, 11},
+			{6, 38, 2, 10, 15, 24},
+			{6, 39, 28, 23, 30, 40},
+			{6, 40, 48, 42, 36, 52},
+			{6, 41, 46, 55, 53, 4},
+			{6, 42, 12, 16, 6, 23},
+			{6, 43, 18, 13, 23, 39},
+			{6, 44, 11, 29, 35, 49},
+			{6, 45, 21, 0, 50, 1},
+			{6, 46, 55, 39, 1, 18},
+			{6, 47, 41, 58, 16, 34},
+		},
+		/* Hopping sequence 3 */
+		{
+			{6, 48, 44, 30, 54, 42},
+			{6, 49, 50, 3, 39, 26},
+			{6, 50, 16, 36, 20, 9},
+			{6, 51, 14, 57, 5, 57},
+			{6, 52, 23, 41, 49, 47},
+			{6, 53, 9, 52, 32, 31},
+			{6, 54, 43, 19, 19, 12},
+			{6, 55, 53, 14, 2, 60},
+			{6, 56, 25, 51, 56, 32},
+			{6, 57, 7, 46, 41, 16},
+			{6, 58, 37, 9, 26, 3},
+			{6, 59, 59, 20, 11, 51},
+			{6, 60, 34, 4, 63, 37},
+			{6, 61, 60, 25, 46, 21},
+			{6, 62, 30, 62, 29, 6},
+			{6, 63, 0, 35, 12, 54},
+		},
+	},
+	/* Payload length symbol 3 */
+	{
+		/* Hopping sequence 0 */
+		{
+			{7, 0, 18, 29, 21, 46},
+			{7, 1, 12, 0, 4, 30},
+			{7, 2, 46, 39, 55, 13},
+			{7, 3, 48, 58, 38, 61},
+			{7, 4, 41, 42, 18, 43},
+			{7, 5, 55, 55, 3, 27},
+			{7, 6, 21, 16, 48, 8},
+			{7, 7, 11, 13, 33, 56},
+			{7, 8, 39, 48, 27, 36},
+			{7, 9, 57, 45, 10, 20},
+			{7, 10, 27, 10, 57, 7},
+			{7, 11, 5, 23, 40, 55},
+			{7, 12, 28, 7, 28, 33},
+			{7, 13, 2, 26, 13, 17},
+			{7, 14, 32, 61, 62, 2},
+			{7, 15, 62, 32, 47, 50},
+		},
+		/* Hopping sequence 1 */
+		{
+			{7, 16, 59, 4, 9, 58},
+			{7, 17, 37, 25, 24, 10},
+			{7, 18, 7, 62, 43, 25},
+			{7, 19, 25, 35, 58, 41},
+			{7, 20, 0, 51, 14, 63},
+			{7, 21, 30, 46, 31, 15},
+			{7, 22, 60, 9, 44, 28},
+			{7, 23, 34, 20, 61, 44},
+			{7, 24, 14, 41, 7, 48},
+			{7, 25, 16, 52, 22, 0},
+			{7, 26, 50, 19, 37, 19},
+			{7, 27, 44, 14, 52, 35},
+			{7, 28, 53, 30, 0, 53},
+			{7, 29, 43, 3, 17, 5},
+			{7, 30, 9, 36, 34, 22},
+			{7, 31, 23, 57, 51, 38},
+		},
+		/* Hopping sequence 2 */
+		{
+			{7, 32, 3, 47, 45, 6},
+			{7, 33, 29, 50, 60, 54},
+			{7, 34, 63, 21, 15, 37},
+			{7, 35, 33, 8, 30, 21},
+			{7, 36, 56, 24, 42, 3},
+			{7, 37, 38, 5, 59, 51},
+			{7, 38, 4, 34, 8, 32},
+			{7, 39, 26, 63, 25, 16},
+			{7, 40, 54, 2, 35, 12},
+			{7, 41, 40, 31, 50, 60},
+			{7, 42, 10, 56, 1, 47},
+			{7, 43, 20, 37, 16, 31},
+			{7, 44, 13, 53, 36, 9},
+			{7, 45, 19, 40, 53, 57},
+			{7, 46, 49, 15, 6, 42},
+			{7, 47, 47, 18, 23, 26},
+		},
+		/* Hopping sequence 3 */
+		{
+			{7, 48, 42, 54, 49, 18},
+			{7, 49, 52, 43, 32, 34},
+			{7, 50, 22, 12, 19, 49},
+			{7, 51, 8, 17, 2, 1},
+			{7, 52, 17, 1, 54, 23},
+			{7, 53, 15, 28, 39, 39},
+			{7, 54, 45, 59, 20, 52},
+			{7, 55, 51, 38, 5, 4},
+			{7, 56, 31, 27, 63, 24},
+			{7, 57, 1, 6, 46, 40},
+			{7, 58, 35, 33, 29, 59},
+			{7, 59, 61, 60, 12, 11},
+			{7, 60, 36, 44, 56, 29},
+			{7, 61, 58, 49, 41, 45},
+			{7, 62, 24, 22, 26, 62},
+			{7, 63, 6, 11, 11, 14},
+		},
+	},
+};
+
+#endif /* SRC_HUBBLE_SAT_PACKET_TABLES_H */
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2026 Hubble Network, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <hubble/sat.h>
+#include <hubble/sat/ephemeris.h>
+
+#include "hubble_sat_pass.h"
+#include "utils/macros.h"
+
+#define _MSEC_PER_SEC 1000ULL
+#define _PPM          1000000ULL
+
+#define _PASS_DURATION_S CONFIG_HUBBLE_SAT_NETWORK_PASS_WINDOW_DURATION_S
+
+/*
+ * A pass less than an orbit away can be missed by the prediction, the
+ * search starts more than a low Earth orbit earlier.
+ */
+#define _PASS_LOOKBACK_S 7200U
+
+/* Passes already over looked at before giving up */
+#define _PASS_SEARCH_MAX 8
+
+static uint64_t _guard_ms_get(uint64_t utc_ms, uint64_t synced_ms)
+{
+	if (utc_ms <= synced_ms) {
+		return 0U;
+	}
+
+	return ((utc_ms - synced_ms) * CONFIG_HUBBLE_SAT_NETWORK_DEVICE_TDR) /
+	       _PPM;
+}
+
+int hubble_sat_pass_window_next(const struct hubble_sat_pass_target *target,
+				uint64_t utc_ms, uint64_t synced_ms,
+				uint64_t *open_ms, uint64_t *close_ms)
+{
+	struct hubble_sat_pass_info pass;
+	uint64_t start_ms, end_ms, guard_ms;
+	uint64_t t;
+	int ret;
+
+	/* Starts early enough to find a pass that is already going on */
+	t = (utc_ms - HUBBLE_MIN(utc_ms, _guard_ms_get(utc_ms, synced_ms))) /
+	    _MSEC_PER_SEC;
+	t -= HUBBLE_MIN(t, _PASS_DURATION_S + _PASS_LOOKBACK_S);
+
+	for (int i = 0; i < _PASS_SEARCH_MAX; i++) {
+		if (target->use_region) {
+			ret = hubble_next_pass_region_get(
+				&target->orbit, t, &target->region, &pass);
+		} else {
+			ret = hubble_next_pass_get(&target->orbit, t,
+						   &target->pos, &pass);
+		}
+
+		if (ret != 0) {
+			return -ENOENT;
+		}
+
+		start_ms = pass.t * _MSEC_PER_SEC;
+		if (!target->use_region) {
+			/* Centered on the crossing */
+			pass.duration = _PASS_DURATION_S;
+			start_ms -= (pass.duration * _MSEC_PER_SEC) / 2U;
+		}
+
+		end_ms = start_ms + (pass.duration * _MSEC_PER_SEC);
+		guard_ms = _guard_ms_get(end_ms, synced_ms);
+
+		if ((end_ms + guard_ms) > utc_ms) {
+			*open_ms = start_ms - HUBBLE_MIN(start_ms, guard_ms);
+			*close_ms = end_ms + guard_ms;
+			return 0;
+		}
+
+		/* Already over, the next one is searched after it */
+		t = end_ms / _MSEC_PER_SEC;
+	}
+
+	return -ENOENT;
+}
+
+static int _target_set(const struct hubble_sat_orbital_params *orbit,
+		       const struct hubble_sat_device_pos *pos,
+		       const struct hubble_sat_device_region *region)
+{
+	struct hubble_sat_pass_target target = {0};
+
+	if (orbit == NULL) {
+		hubble_sat_port_pass_target_set(NULL);
+		return 0;
+	}
+
+	if ((pos == NULL) && (region == NULL)) {
+		return -EINVAL;
+	}
+
+	target.orbit = *orbit;
+	if (region != NULL) {
+		target.region = *region;
+		target.use_region = true;
+	} else {
+		target.pos = *pos;
+	}
+
+	hubble_sat_port_pass_target_set(&target);
+
+	return 0;
+}
+
+int hubble_sat_pass_window_set(const struct hubble_sat_orbital_params *orbit,
+			       const struct hubble_sat_device_pos *pos)
+{
+	return _target_set(orbit, pos, NULL);
+}
+
+int hubble_sat_pass_window_region_set(
+	const struct hubble_sat_orbital_params *orbit,
+	const struct hubble_sat_device_region *region)
+{
+	return _target_set(orbit, NULL, region);
+}
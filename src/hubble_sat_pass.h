@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2026 Hubble Network, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SRC_HUBBLE_SAT_PASS_H
+#define SRC_HUBBLE_SAT_PASS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <hubble/sat/ephemeris.h>
+
+/* What the satellite passes are predicted for */
+struct hubble_sat_pass_target {
+	struct hubble_sat_orbital_params orbit;
+	struct hubble_sat_device_pos pos;
+	struct hubble_sat_device_region region;
+	/* Passes over region instead of pos */
+	bool use_region;
+};
+
+/**
+ * @brief Gets the transmission window of the next satellite pass.
+ *
+ * A pass over a location spans
+ * CONFIG_HUBBLE_SAT_NETWORK_PASS_WINDOW_DURATION_S centered on the predicted
+ * crossing, a pass over a region spans the predicted crossing of the region.
+ * Both are widened on each side by a guard time covering the clock drift
+ * since the last UTC sync, CONFIG_HUBBLE_SAT_NETWORK_DEVICE_TDR parts per
+ * million of the time elapsed at the end of the pass.
+ *
+ * A window that is already open at @p utc_ms is returned.
+ *
+ * @param target    Orbit and location of the device.
+ * @param utc_ms    Current UTC time in milliseconds.
+ * @param synced_ms UTC time in milliseconds of the last sync.
+ * @param open_ms   Set to the UTC time in milliseconds the window opens.
+ * @param close_ms  Set to the UTC time in milliseconds the window closes,
+ *                  after @p utc_ms.
+ *
+ * @return 0 on success, -ENOENT if no pass could be predicted.
+ */
+int hubble_sat_pass_window_next(const struct hubble_sat_pass_target *target,
+				uint64_t utc_ms, uint64_t synced_ms,
+				uint64_t *open_ms, uint64_t *close_ms);
+
+/**
+ * @brief Sets the passes transmissions are held for.
+ *
+ * Implemented by the port, @p target is copied. Called with NULL when the
+ * transmissions are not restricted anymore.
+ */
+void hubble_sat_port_pass_target_set(
+	const struct hubble_sat_pass_target *target);
+
+#endif /* SRC_HUBBLE_SAT_PASS_H */
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2026 Hubble Network, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hubble_sat_queue.h"
+
+int hubble_sat_queue_push(struct hubble_sat_queue *queue,
+			  const struct hubble_sat_queue_item *item)
+{
+	size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+	size_t next = (head + 1U) % queue->ring_size;
+
+	if (next == atomic_load_explicit(&queue->tail, memory_order_acquire)) {
+		return -EAGAIN;
+	}
+
+	queue->ring[head] = *item;
+
+	/* Publishes the item to the consumer */
+	atomic_store_explicit(&queue->head, next, memory_order_release);
+
+	return 0;
+}
+
+bool hubble_sat_queue_get(struct hubble_sat_queue *queue,
+			  struct hubble_sat_queue_item *item)
+{
+	size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+
+	if (tail == atomic_load_explicit(&queue->head, memory_order_acquire)) {
+		return false;
+	}
+
+	*item = queue->ring[tail];
+
+	/* Hands the slot back to the producer */
+	atomic_store_explicit(&queue->tail, (tail + 1U) % queue->ring_size,
+			      memory_order_release);
+
+	return true;
+}
+
+static inline bool _fresher(const struct hubble_sat_queue_entry *a,
+			    const struct hubble_sat_queue_entry *b)
+{
+	/* Still right once the sequence wrapped */
+	return (int32_t)(a->seq - b->seq) > 0;
+}
+
+static void _release(struct hubble_sat_queue *queue,
+		     struct hubble_sat_queue_entry *entry, int status)
+{
+	hubble_sat_packet_sent_cb_t cb = entry->item.cb;
+	void *user_data = entry->item.user_data;
+
+	/* Released first, the callback can queue a packet */
+	entry->used = false;
+	queue->count--;
+
+	if (cb != NULL) {
+		cb(status, user_data);
+	}
+}
+
+static void _expire(struct hubble_sat_queue *queue, uint64_t now_ms)
+{
+	for (size_t i = 0; i < queue->pool_size; i++) {
+		struct hubble_sat_queue_entry *entry = &queue->pool[i];
+
+		if (entry->used && (entry->deadline_ms <= now_ms)) {
+			_release(queue, entry, -ETIMEDOUT);
+		}
+	}
+}
+
+static struct hubble_sat_queue_entry *
+_slot_get(struct hubble_sat_queue *queue,
+	  const struct hubble_sat_queue_item *item)
+{
+	struct hubble_sat_queue_entry *victim = NULL;
+
+	for (size_t i = 0; i < queue->pool_size; i++) {
+		struct hubble_sat_queue_entry *entry = &queue->pool[i];
+
+		if (!entry->used) {
+			return entry;
+		}
+
+		if ((victim == NULL) ||
+		    (entry->item.priority < victim->item.priority) ||
+		    ((entry->item.priority == victim->item.priority) &&
+		     _fresher(victim, entry))) {
+			victim = entry;
+		}
+	}
+
+	if ((victim == NULL) || (item->priority < victim->item.priority)) {
+		return NULL;
+	}
+
+	_release(queue, victim, -ENOBUFS);
+
+	return victim;
+}
+
+void hubble_sat_queue_insert(struct hubble_sat_queue *queue,
+			     const struct hubble_sat_queue_item *item,
+			     uint64_t now_ms)
+{
+	struct hubble_sat_queue_entry *entry = NULL;
+	struct hubble_sat_queue_item old = {0};
+
+	_expire(queue, now_ms);
+
+	for (size_t i = 0; (item->key != 0U) && (i < queue->pool_size); i++) {
+		if (queue->pool[i].used &&
+		    (queue->pool[i].item.key == item->key)) {
+			entry = &queue->pool[i];
+			break;
+		}
+	}
+
+	if (entry != NULL) {
+		old = entry->item;
+	} else {
+		entry = _slot_get(queue, item);
+		if (entry == NULL) {
+			if (item->cb != NULL) {
+				item->cb(-ENOBUFS, item->user_data);
+			}
+			return;
+		}
+		entry->used = true;
+		queue->count++;
+	}
+
+	entry->item = *item;
+	entry->deadline_ms = hubble_sat_queue_deadline_get(item, now_ms);
+	entry->seq = queue->seq++;
+
+	/* Superseded, the newer packet took its place */
+	if (old.cb != NULL) {
+		old.cb(-ECANCELED, old.user_data);
+	}
+}
+
+bool hubble_sat_queue_pop(struct hubble_sat_queue *queue, uint64_t now_ms,
+			  struct hubble_sat_queue_item *item,
+			  uint64_t *deadline_ms)
+{
+	struct hubble_sat_queue_entry *next = NULL;
+
+	_expire(queue, now_ms);
+
+	for (size_t i = 0; i < queue->pool_size; i++) {
+		struct hubble_sat_queue_entry *entry = &queue->pool[i];
+
+		if (!entry->used) {
+			continue;
+		}
+
+		if ((next == NULL) ||
+		    (entry->item.priority > next->item.priority) ||
+		    ((entry->item.priority == next->item.priority) &&
+		     _fresher(entry, next))) {
+			next = entry;
+		}
+	}
+
+	if (next == NULL) {
+		return false;
+	}
+
+	*item = next->item;
+	*deadline_ms = next->deadline_ms;
+
+	next->used = false;
+	queue->count--;
+
+	return true;
+}
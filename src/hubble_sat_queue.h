@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2026 Hubble Network, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SRC_HUBBLE_SAT_QUEUE_H
+#define SRC_HUBBLE_SAT_QUEUE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <hubble/sat.h>
+
+#include "utils/macros.h"
+
+/*
+ * Priority queue in front of the transmit scheduler.
+ *
+ * Packets are pushed into a lock-free ring by a single producer (which can
+ * be an ISR) and moved by the transmit thread, the single consumer, into a
+ * bounded pool. The pool hands out the packet with the highest priority,
+ * the freshest first among the same priority, drops the packets that
+ * expired, and replaces a waiting packet by a newer one with the same
+ * coalescing key. When the pool is full, the oldest packet with the lowest
+ * priority is evicted to make room for one with at least that priority.
+ *
+ * Like the scheduler, it has no notion of time: the consumer passes the
+ * current uptime.
+ */
+
+struct hubble_sat_queue_item {
+	struct hubble_sat_packet packet;
+	hubble_sat_packet_sent_cb_t cb;
+	void *user_data;
+	/* Time (ms) it can wait before being transmitted, 0 for no limit */
+	uint32_t lifetime_ms;
+	/* Coalescing key, 0 for none */
+	uint16_t key;
+	uint8_t priority;
+	uint8_t retries;
+	uint8_t interval_s;
+};
+
+struct hubble_sat_queue_entry {
+	struct hubble_sat_queue_item item;
+	/* Uptime (ms) it expires at */
+	uint64_t deadline_ms;
+	/* Insertion order, the higher the fresher */
+	uint32_t seq;
+	bool used;
+};
+
+struct hubble_sat_queue {
+	/* Ring, one slot is kept empty to tell a full ring from an empty one */
+	struct hubble_sat_queue_item *ring;
+	size_t ring_size;
+	/* Written by the producer only */
+	atomic_size_t head;
+	/* Written by the consumer only */
+	atomic_size_t tail;
+	/* Pool, only touched by the consumer */
+	struct hubble_sat_queue_entry *pool;
+	size_t pool_size;
+	size_t count;
+	uint32_t seq;
+};
+
+/**
+ * @brief Static initializer of a queue.
+ *
+ * @param _ring Array of struct hubble_sat_queue_item, one more than the
+ *              number of packets the producer can push ahead of the
+ *              consumer.
+ * @param _pool Array of struct hubble_sat_queue_entry, the number of packets
+ *              waiting for the scheduler.
+ */
+#define HUBBLE_SAT_QUEUE_INITIALIZER(_ring, _pool)                             \
+	{                                                                      \
+		.ring = (_ring),                                               \
+		.ring_size = HUBBLE_ARRAY_SIZE(_ring),                         \
+		.head = 0,                                                     \
+		.tail = 0,                                                     \
+		.pool = (_pool),                                               \
+		.pool_size = HUBBLE_ARRAY_SIZE(_pool),                         \
+		.count = 0,                                                    \
+		.seq = 0,                                                      \
+	}
+
+/**
+ * @brief Pushes a packet into the ring (producer side).
+ *
+ * It does not block nor take any lock, so it can be called from an ISR. It
+ * must not be called concurrently from several contexts.
+ *
+ * @return 0 on success, -EAGAIN if the ring is full.
+ */
+int hubble_sat_queue_push(struct hubble_sat_queue *queue,
+			  const struct hubble_sat_queue_item *item);
+
+/**
+ * @brief Pops a packet from the ring (consumer side), in the order they were
+ *        pushed.
+ *
+ * @return true if @p item was set, false if the ring is empty.
+ */
+bool hubble_sat_queue_get(struct hubble_sat_queue *queue,
+			  struct hubble_sat_queue_item *item);
+
+/**
+ * @brief Adds a packet to the pool (consumer side).
+ *
+ * The packet waiting with the same non-zero key is replaced, its callback
+ * is called with -ECANCELED. When the pool is full, either the oldest
+ * packet with the lowest priority or @p item, if its priority is lower, is
+ * dropped and its callback is called with -ENOBUFS.
+ *
+ * @param queue  Queue.
+ * @param item   Packet to add.
+ * @param now_ms Current uptime in milliseconds, the lifetime of @p item
+ *               starts from it.
+ */
+void hubble_sat_queue_insert(struct hubble_sat_queue *queue,
+			     const struct hubble_sat_queue_item *item,
+			     uint64_t now_ms);
+
+/**
+ * @brief Takes the packet to hand to the scheduler out of the pool
+ *        (consumer side).
+ *
+ * The packets expired at @p now_ms are dropped first and their callback is
+ * called with -ETIMEDOUT.
+ *
+ * @param queue       Queue.
+ * @param now_ms      Current uptime in milliseconds.
+ * @param item        Set to the packet with the highest priority, the
+ *                    freshest one among the same priority.
+ * @param deadline_ms Set to the uptime in milliseconds @p item expires at,
+ *                    UINT64_MAX if it does not.
+ *
+ * @return true if @p item was set, false if the pool is empty.
+ */
+bool hubble_sat_queue_pop(struct hubble_sat_queue *queue, uint64_t now_ms,
+			  struct hubble_sat_queue_item *item,
+			  uint64_t *deadline_ms);
+
+/**
+ * @brief Returns the uptime in milliseconds @p item expires at when it is
+ *        queued at @p now_ms, UINT64_MAX if it does not.
+ */
+static inline uint64_t
+hubble_sat_queue_deadline_get(const struct hubble_sat_queue_item *item,
+			      uint64_t now_ms)
+{
+	return (item->lifetime_ms == 0U) ? UINT64_MAX
+					 : (now_ms + item->lifetime_ms);
+}
+
+/**
+ * @brief Returns true if the pool is full.
+ */
+static inline bool hubble_sat_queue_full(const struct hubble_sat_queue *queue)
+{
+	return queue->count == queue->pool_size;
+}
+
+#endif /* SRC_HUBBLE_SAT_QUEUE_H */
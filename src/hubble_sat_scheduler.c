@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2026 Hubble Network, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "hubble_sat_scheduler.h"
+#include "utils/macros.h"
+
+#define _MSEC_PER_SEC 1000U
+
+void hubble_sat_scheduler_init(struct hubble_sat_scheduler *sched,
+			       struct hubble_sat_scheduler_entry *entries,
+			       size_t size)
+{
+	memset(entries, 0, size * sizeof(entries[0]));
+
+	sched->entries = entries;
+	sched->size = size;
+	sched->count = 0U;
+
+	hubble_sat_scheduler_window_clear(sched);
+}
+
+void hubble_sat_scheduler_window_set(struct hubble_sat_scheduler *sched,
+				     uint64_t open_ms, uint64_t close_ms)
+{
+	sched->window_open_ms = open_ms;
+	sched->window_close_ms = close_ms;
+}
+
+static void _entry_set(struct hubble_sat_scheduler_entry *entry,
+		       const struct hubble_sat_packet *packet, uint8_t retries,
+		       uint8_t interval_s, uint8_t priority, uint16_t key,
+		       uint64_t deadline_ms, hubble_sat_packet_sent_cb_t cb,
+		       void *user_data, uint64_t now_ms)
+{
+	entry->packet = *packet;
+	entry->cb = cb;
+	entry->user_data = user_data;
+	entry->due_ms = now_ms;
+	entry->deadline_ms = deadline_ms;
+	entry->retries = retries;
+	entry->interval_s = interval_s;
+	entry->priority = priority;
+	entry->key = key;
+}
+
+int hubble_sat_scheduler_add_priority(struct hubble_sat_scheduler *sched,
+				      const struct hubble_sat_packet *packet,
+				      uint8_t retries, uint8_t interval_s,
+				      uint8_t priority, uint16_t key,
+				      uint64_t deadline_ms,
+				      hubble_sat_packet_sent_cb_t cb,
+				      void *user_data, uint64_t now_ms)
+{
+	if (retries == 0U) {
+		return -EINVAL;
+	}
+
+	for (size_t i = 0; i < sched->size; i++) {
+		struct hubble_sat_scheduler_entry *entry = &sched->entries[i];
+
+		if (entry->retries != 0U) {
+			continue;
+		}
+
+		_entry_set(entry, packet, retries, interval_s, priority, key,
+			   deadline_ms, cb, user_data, now_ms);
+		sched->count++;
+
+		return 0;
+	}
+
+	return -EAGAIN;
+}
+
+int hubble_sat_scheduler_replace(struct hubble_sat_scheduler *sched,
+				 const struct hubble_sat_packet *packet,
+				 uint8_t retries, uint8_t interval_s,
+				 uint8_t priority, uint16_t key,
+				 uint64_t deadline_ms,
+				 hubble_sat_packet_sent_cb_t cb,
+				 void *user_data, uint64_t now_ms)
+{
+	hubble_sat_packet_sent_cb_t old_cb;
+	void *old_user_data;
+
+	if ((retries == 0U) || (key == 0U)) {
+		return -EINVAL;
+	}
+
+	for (size_t i = 0; i < sched->size; i++) {
+		struct hubble_sat_scheduler_entry *entry = &sched->entries[i];
+
+		if ((entry->retries == 0U) || (entry->key != key)) {
+			continue;
+		}
+
+		old_cb = entry->cb;
+		old_user_data = entry->user_data;
+
+		_entry_set(entry, packet, retries, interval_s, priority, key,
+			   deadline_ms, cb, user_data, now_ms);
+
+		/* Superseded, the newer packet took its place */
+		if (old_cb != NULL) {
+			old_cb(-ECANCELED, old_user_data);
+		}
+
+		return 0;
+	}
+
+	return -ENOENT;
+}
+
+static void _release(struct hubble_sat_scheduler *sched,
+		     struct hubble_sat_scheduler_entry *entry, int status)
+{
+	hubble_sat_packet_sent_cb_t cb = entry->cb;
+	void *user_data = entry->user_data;
+
+	/* Released first, the callback can add a packet */
+	entry->retries = 0U;
+	sched->count--;
+
+	if (cb != NULL) {
+		cb(status, user_data);
+	}
+}
+
+struct hubble_sat_scheduler_entry *
+hubble_sat_scheduler_next(struct hubble_sat_scheduler *sched, uint64_t now_ms,
+			  uint64_t *wait_ms)
+{
+	struct hubble_sat_scheduler_entry *next = NULL;
+	uint64_t first_ms = HUBBLE_SAT_SCHEDULER_WAIT_FOREVER;
+	uint64_t expire_ms = HUBBLE_SAT_SCHEDULER_WAIT_FOREVER;
+	uint64_t due_ms;
+
+	/* Dropped first, their callbacks can add packets */
+	for (size_t i = 0; i < sched->size; i++) {
+		struct hubble_sat_scheduler_entry *entry = &sched->entries[i];
+
+		if ((entry->retries != 0U) && (entry->deadline_ms <= now_ms)) {
+			_release(sched, entry, -ETIMEDOUT);
+		}
+	}
+
+	for (size_t i = 0; i < sched->size; i++) {
+		struct hubble_sat_scheduler_entry *entry = &sched->entries[i];
+
+		if (entry->retries == 0U) {
+			continue;
+		}
+
+		expire_ms = HUBBLE_MIN(expire_ms, entry->deadline_ms);
+		due_ms = HUBBLE_MAX(entry->due_ms, sched->window_open_ms);
+		first_ms = HUBBLE_MIN(first_ms, due_ms);
+		if (due_ms > now_ms) {
+			continue;
+		}
+
+		if ((next == NULL) || (entry->priority > next->priority) ||
+		    ((entry->priority == next->priority) &&
+		     (entry->due_ms < next->due_ms))) {
+			next = entry;
+		}
+	}
+
+	if (sched->count == 0U) {
+		*wait_ms = HUBBLE_SAT_SCHEDULER_WAIT_FOREVER;
+		return NULL;
+	}
+
+	if (first_ms >= sched->window_close_ms) {
+		/* Held until the next window */
+		*wait_ms = (sched->window_close_ms > now_ms)
+				   ? (sched->window_close_ms - now_ms)
+				   : HUBBLE_SAT_SCHEDULER_WAIT_FOREVER;
+	} else if (next == NULL) {
+		*wait_ms = first_ms - now_ms;
+	} else {
+		/* Transmitted from now on, it can no longer be superseded */
+		next->key = 0U;
+		*wait_ms = 0U;
+		return next;
+	}
+
+	/* Woken up to report the expiry */
+	if (expire_ms != HUBBLE_SAT_SCHEDULER_WAIT_FOREVER) {
+		*wait_ms = HUBBLE_MIN(*wait_ms, expire_ms - now_ms);
+	}
+
+	return NULL;
+}
+
+void hubble_sat_scheduler_done(struct hubble_sat_scheduler *sched,
+			       struct hubble_sat_scheduler_entry *entry,
+			       int status, uint64_t now_ms, int16_t offset_ms)
+{
+	int64_t delay_ms;
+
+	entry->retries--;
+	if ((status != 0) || (entry->retries == 0U)) {
+		_release(sched, entry, status);
+		return;
+	}
+
+	/* Only the first transmission has a deadline */
+	entry->deadline_ms = HUBBLE_SAT_SCHEDULER_WAIT_FOREVER;
+
+	delay_ms = ((int64_t)entry->interval_s * _MSEC_PER_SEC) + offset_ms;
+	entry->due_ms = now_ms + HUBBLE_MAX(0, delay_ms);
+}
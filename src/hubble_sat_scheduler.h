@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2026 Hubble Network, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SRC_HUBBLE_SAT_SCHEDULER_H
+#define SRC_HUBBLE_SAT_SCHEDULER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <hubble/sat.h>
+
+/*
+ * Transmit scheduler: keeps several packets in flight and hands out their
+ * transmissions in the order they become due, so the interval between two
+ * retries of a packet is used to transmit the other ones.
+ *
+ * Transmissions can be restricted to a window (e.g. a satellite pass):
+ * packets due before it opens are held until then, and the retries left
+ * when it closes wait for the next one.
+ *
+ * It has no notion of time or threads: the caller passes the current
+ * uptime and the random offset of each retry, and owns the scheduler
+ * (only one context must use it).
+ */
+
+/* Wait returned by hubble_sat_scheduler_next() when nothing is queued */
+#define HUBBLE_SAT_SCHEDULER_WAIT_FOREVER UINT64_MAX
+
+struct hubble_sat_scheduler_entry {
+	struct hubble_sat_packet packet;
+	hubble_sat_packet_sent_cb_t cb;
+	void *user_data;
+	/* Uptime (ms) of the next transmission */
+	uint64_t due_ms;
+	/* Uptime (ms) the first transmission must start by */
+	uint64_t deadline_ms;
+	/* Transmissions left, 0 if the entry is free */
+	uint8_t retries;
+	uint8_t interval_s;
+	uint8_t priority;
+	/* Coalescing key, cleared when the first transmission starts */
+	uint16_t key;
+};
+
+struct hubble_sat_scheduler {
+	struct hubble_sat_scheduler_entry *entries;
+	size_t size;
+	size_t count;
+	/* Uptime (ms) transmissions are allowed in, [open, close) */
+	uint64_t window_open_ms;
+	uint64_t window_close_ms;
+};
+
+/**
+ * @brief Initializes a scheduler using @p entries as storage.
+ *
+ * Transmissions are not restricted to a window.
+ *
+ * @param sched   Scheduler.
+ * @param entries Storage for the packets in flight.
+ * @param size    Number of @p entries.
+ */
+void hubble_sat_scheduler_init(struct hubble_sat_scheduler *sched,
+			       struct hubble_sat_scheduler_entry *entries,
+			       size_t size);
+
+/**
+ * @brief Adds a packet, its first transmission is due at @p now_ms.
+ *
+ * When several transmissions are due, the one of the packet with the
+ * highest @p priority goes first. If the first transmission did not start
+ * by @p deadline_ms, the packet is dropped and its callback is called with
+ * -ETIMEDOUT. Until then, hubble_sat_scheduler_replace() can supersede it
+ * by a packet with the same non-zero @p key.
+ *
+ * @return 0 on success, -EINVAL if @p retries is 0, -EAGAIN if all the
+ *         entries are used.
+ */
+int hubble_sat_scheduler_add_priority(struct hubble_sat_scheduler *sched,
+				      const struct hubble_sat_packet *packet,
+				      uint8_t retries, uint8_t interval_s,
+				      uint8_t priority, uint16_t key,
+				      uint64_t deadline_ms,
+				      hubble_sat_packet_sent_cb_t cb,
+				      void *user_data, uint64_t now_ms);
+
+/**
+ * @brief Replaces the packet added with the same non-zero @p key, if its
+ *        first transmission did not start yet (e.g. it is held until a
+ *        window opens).
+ *
+ * The new packet takes the entry of the older one, whose callback is
+ * called with -ECANCELED, and its first transmission is due at @p now_ms.
+ *
+ * @return 0 on success, -EINVAL if @p retries or @p key is 0, -ENOENT if no
+ *         packet waits with @p key.
+ */
+int hubble_sat_scheduler_replace(struct hubble_sat_scheduler *sched,
+				 const struct hubble_sat_packet *packet,
+				 uint8_t retries, uint8_t interval_s,
+				 uint8_t priority, uint16_t key,
+				 uint64_t deadline_ms,
+				 hubble_sat_packet_sent_cb_t cb,
+				 void *user_data, uint64_t now_ms);
+
+/**
+ * @brief Adds a packet, its first transmission is due at @p now_ms.
+ *
+ * @return 0 on success, -EINVAL if @p retries is 0, -EAGAIN if all the
+ *         entries are used.
+ */
+static inline int
+hubble_sat_scheduler_add(struct hubble_sat_scheduler *sched,
+			 const struct hubble_sat_packet *packet,
+			 uint8_t retries, uint8_t interval_s,
+			 hubble_sat_packet_sent_cb_t cb, void *user_data,
+			 uint64_t now_ms)
+{
+	return hubble_sat_scheduler_add_priority(
+		sched, packet, retries, interval_s, 0U, 0U,
+		HUBBLE_SAT_SCHEDULER_WAIT_FOREVER, cb, user_data, now_ms);
+}
+
+/**
+ * @brief Returns true if no packet can be added.
+ */
+static inline bool
+hubble_sat_scheduler_full(const struct hubble_sat_scheduler *sched)
+{
+	return sched->count == sched->size;
+}
+
+/**
+ * @brief Restricts the transmissions to [@p open_ms, @p close_ms).
+ *
+ * @param sched    Scheduler.
+ * @param open_ms  Uptime in milliseconds the window opens.
+ * @param close_ms Uptime in milliseconds the window closes.
+ */
+void hubble_sat_scheduler_window_set(struct hubble_sat_scheduler *sched,
+				     uint64_t open_ms, uint64_t close_ms);
+
+/**
+ * @brief Lifts the restriction set by hubble_sat_scheduler_window_set().
+ */
+static inline void
+hubble_sat_scheduler_window_clear(struct hubble_sat_scheduler *sched)
+{
+	hubble_sat_scheduler_window_set(sched, 0U,
+					HUBBLE_SAT_SCHEDULER_WAIT_FOREVER);
+}
+
+/**
+ * @brief Returns true if the window closed before @p now_ms.
+ *
+ * Nothing is transmitted until a new window is set.
+ */
+static inline bool
+hubble_sat_scheduler_window_over(const struct hubble_sat_scheduler *sched,
+				 uint64_t now_ms)
+{
+	return now_ms >= sched->window_close_ms;
+}
+
+/**
+ * @brief Gets the packet to transmit at @p now_ms.
+ *
+ * Among the entries due, the one with the highest priority is returned,
+ * then the one due the earliest, ties go to the first entry. Within a
+ * window, an entry due before it opens is due when it opens.
+ *
+ * The entries that missed their deadline are released and their callback
+ * is called with -ETIMEDOUT.
+ *
+ * @param sched   Scheduler.
+ * @param now_ms  Current uptime in milliseconds.
+ * @param wait_ms Set to the time until the next transmission is due when
+ *                none is due yet, HUBBLE_SAT_SCHEDULER_WAIT_FOREVER if the
+ *                scheduler is empty. When the next transmission is only due
+ *                after the window, it is the time until the window closes
+ *                (HUBBLE_SAT_SCHEDULER_WAIT_FOREVER if it is already
+ *                closed). It is capped to the time until the earliest
+ *                deadline.
+ *
+ * @return The entry to transmit, NULL if none is due.
+ */
+struct hubble_sat_scheduler_entry *
+hubble_sat_scheduler_next(struct hubble_sat_scheduler *sched, uint64_t now_ms,
+			  uint64_t *wait_ms);
+
+/**
+ * @brief Reports the transmission of an entry from
+ *        hubble_sat_scheduler_next().
+ *
+ * The next retry is due @p entry->interval_s seconds plus @p offset_ms after
+ * @p now_ms. When it was the last retry, or if @p status is an error, the
+ * entry is released and its callback is called with @p status.
+ *
+ * @param sched     Scheduler.
+ * @param entry     Entry transmitted.
+ * @param status    Result of the transmission.
+ * @param now_ms    Uptime in milliseconds at the end of the transmission.
+ * @param offset_ms Random offset added to the interval.
+ */
+void hubble_sat_scheduler_done(struct hubble_sat_scheduler *sched,
+			       struct hubble_sat_scheduler_entry *entry,
+			       int status, uint64_t now_ms, int16_t offset_ms);
+
+#endif /* SRC_HUBBLE_SAT_SCHEDULER_H */
@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2026 Hubble Network, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Errors and erasures decoder for the codes built by reed_solomon_encoder.c:
+ * RS(63, k) over GF(2^6) generated by p(X) = 1 + X + X^6, with the roots
+ * alpha^1 .. alpha^2tt, shortened to kk + 2tt symbols.
+ *
+ * The symbol transmitted first is the coefficient of the highest degree,
+ * so the symbol at position i is located at X = alpha^(n - 1 - i).
+ *
+ * Decoding is done in four steps: syndromes, Berlekamp-Massey initialized
+ * with the erasure locator, Chien search and Forney algorithm. All the
+ * arithmetic goes through the log / antilog tables of the encoder and the
+ * state lives on the stack, so several codewords can be decoded
+ * concurrently.
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "reed_solomon_decoder.h"
+#include "reed_solomon_encoder.h"
+
+#define NN RSE_NN
+#define A0 RSE_GF_LOG_ZERO
+
+static inline uint8_t _mul(uint8_t a, uint8_t b)
+{
+	return rse_gf_exp[rse_gf_log[a] + rse_gf_log[b]];
+}
+
+/* Multiplies by alpha^e, 0 <= e < NN */
+static inline uint8_t _mul_exp(uint8_t a, unsigned int e)
+{
+	return rse_gf_exp[rse_gf_log[a] + e];
+}
+
+/* a must not be 0 */
+static inline uint8_t _inv(uint8_t a)
+{
+	return rse_gf_exp[NN - rse_gf_log[a]];
+}
+
+/* Returns true if at least one syndrome is not zero */
+static bool _syndromes_get(const uint8_t data[], int n, int tt, uint8_t *s)
+{
+	uint8_t any = 0U;
+
+	memset(s, 0, (2 * tt + 1) * sizeof(s[0]));
+
+	/* Horner, the syndromes are independent so they are interleaved */
+	for (int i = 0; i < n; i++) {
+		for (int j = 1; j <= 2 * tt; j++) {
+			s[j] = _mul_exp(s[j], j) ^ data[i];
+		}
+	}
+
+	for (int j = 1; j <= 2 * tt; j++) {
+		any |= s[j];
+	}
+
+	return any != 0U;
+}
+
+/* Returns the degree of the error and erasure locator */
+static int _locator_get(const uint8_t *s, int n, int tt, const int erasures[],
+			int erasure_count, uint8_t *lambda)
+{
+	uint8_t b[2 * RSD_TT_MAX + 2] = {0};
+	uint8_t t[2 * RSD_TT_MAX + 1];
+	int el = erasure_count;
+	int deg = 0;
+
+	/* Erasure locator, product of (1 + X_k x) */
+	memset(lambda, 0, (2 * tt + 1) * sizeof(lambda[0]));
+	lambda[0] = 1U;
+	for (int k = 0; k < erasure_count; k++) {
+		unsigned int e = n - 1 - erasures[k];
+
+		for (int i = k + 1; i > 0; i--) {
+			lambda[i] ^= _mul_exp(lambda[i - 1], e);
+		}
+	}
+
+	/* Berlekamp-Massey, starting from the erasure locator */
+	memcpy(b, lambda, (2 * tt + 1) * sizeof(b[0]));
+	for (int r = erasure_count + 1; r <= 2 * tt; r++) {
+		uint8_t discr = 0U;
+
+		for (int i = 0; i < r; i++) {
+			discr ^= _mul(lambda[i], s[r - i]);
+		}
+
+		if (discr != 0U) {
+			t[0] = lambda[0];
+			for (int i = 1; i <= 2 * tt; i++) {
+				t[i] = lambda[i] ^ _mul(discr, b[i - 1]);
+			}
+
+			if (2 * el <= r + erasure_count - 1) {
+				uint8_t inv = _inv(discr);
+
+				el = r + erasure_count - el;
+				for (int i = 0; i <= 2 * tt; i++) {
+					b[i] = _mul(lambda[i], inv);
+				}
+				memcpy(lambda, t, (2 * tt + 1) * sizeof(t[0]));
+				continue;
+			}
+
+			memcpy(lambda, t, (2 * tt + 1) * sizeof(t[0]));
+		}
+
+		/* b(x) = x * b(x) */
+		memmove(&b[1], &b[0], (2 * tt) * sizeof(b[0]));
+		b[0] = 0U;
+	}
+
+	for (int i = 0; i <= 2 * tt; i++) {
+		if (lambda[i] != 0U) {
+			deg = i;
+		}
+	}
+
+	return deg;
+}
+
+/*
+ * Chien search over the positions of the shortened code. Returns the
+ * number of roots, or -1 if there are more than @p deg of them.
+ */
+static int _roots_get(const uint8_t *lambda, int deg, int n, int *loc)
+{
+	uint8_t reg[2 * RSD_TT_MAX + 1];
+	int count = 0;
+
+	/* lambda_i * X^-i for the first position, X = alpha^(n - 1) */
+	for (int i = 1; i <= deg; i++) {
+		if (lambda[i] == 0U) {
+			reg[i] = A0;
+		} else {
+			reg[i] = (rse_gf_log[lambda[i]] + i * (NN - (n - 1))) %
+				 NN;
+		}
+	}
+
+	for (int pos = 0; pos < n; pos++) {
+		uint8_t v = lambda[0];
+
+		for (int i = 1; i <= deg; i++) {
+			if (reg[i] != A0) {
+				v ^= rse_gf_exp[reg[i]];
+				/* Next position is X * alpha^-1 */
+				reg[i] = (reg[i] + i) % NN;
+			}
+		}
+
+		if (v == 0U) {
+			if (count == deg) {
+				return -1;
+			}
+			loc[count++] = pos;
+		}
+	}
+
+	return count;
+}
+
+int rsd_rs_decode(uint8_t data[], int kk, int tt, const int erasures[],
+		  int erasure_count)
+{
+	int n = kk + 2 * tt;
+	uint8_t s[2 * RSD_TT_MAX + 1];
+	uint8_t lambda[2 * RSD_TT_MAX + 1];
+	uint8_t omega[2 * RSD_TT_MAX] = {0};
+	int loc[2 * RSD_TT_MAX];
+	uint8_t err[2 * RSD_TT_MAX];
+	int deg_lambda;
+	int count;
+	int corrected = 0;
+
+	if ((data == NULL) || (kk <= 0) || (tt <= 0) || (tt > RSD_TT_MAX) ||
+	    (n > NN) || (erasure_count < 0) ||
+	    ((erasure_count > 0) && (erasures == NULL))) {
+		return -EINVAL;
+	}
+
+	for (int i = 0; i < n; i++) {
+		if (data[i] > NN) {
+			return -EINVAL;
+		}
+	}
+
+	for (int i = 0; i < erasure_count; i++) {
+		if ((erasures[i] < 0) || (erasures[i] >= n)) {
+			return -EINVAL;
+		}
+	}
+
+	if (erasure_count > 2 * tt) {
+		return -EBADMSG;
+	}
+
+	if (!_syndromes_get(data, n, tt, s)) {
+		return 0;
+	}
+
+	deg_lambda = _locator_get(s, n, tt, erasures, erasure_count, lambda);
+
+	count = _roots_get(lambda, deg_lambda, n, loc);
+	if (count != deg_lambda) {
+		return -EBADMSG;
+	}
+
+	/* Error evaluator, S(x) * lambda(x) mod x^2tt */
+	for (int i = 0; i < 2 * tt; i++) {
+		for (int j = 0; j <= i; j++) {
+			omega[i] ^= _mul(s[j + 1], lambda[i - j]);
+		}
+	}
+
+	/* Forney, with the first root being alpha^1 */
+	for (int k = 0; k < count; k++) {
+		unsigned int x_inv = (NN - (n - 1 - loc[k])) % NN;
+		unsigned int x2_inv = (2 * x_inv) % NN;
+		uint8_t num = 0U;
+		uint8_t den = 0U;
+
+		for (int i = 2 * tt - 1; i >= 0; i--) {
+			num = _mul_exp(num, x_inv) ^ omega[i];
+		}
+
+		/* Formal derivative of lambda, only odd powers remain */
+		for (int i = deg_lambda - ((deg_lambda + 1) % 2); i >= 1;
+		     i -= 2) {
+			den = _mul_exp(den, x2_inv) ^ lambda[i];
+		}
+
+		if (den == 0U) {
+			return -EBADMSG;
+		}
+
+		err[k] = _mul(num, _inv(den));
+	}
+
+	/*
+	 * Past the correction capability the locator can have all its roots
+	 * and still not lead to a codeword, check that the error values
+	 * cancel the syndromes before touching the data.
+	 */
+	for (int j = 1; j <= 2 * tt; j++) {
+		uint8_t v = s[j];
+
+		for (int k = 0; k < count; k++) {
+			v ^= _mul_exp(err[k], (j * (n - 1 - loc[k])) % NN);
+		}
+
+		if (v != 0U) {
+			return -EBADMSG;
+		}
+	}
+
+	for (int k = 0; k < count; k++) {
+		if (err[k] != 0U) {
+			data[loc[k]] ^= err[k];
+			corrected++;
+		}
+	}
+
+	return corrected;
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2026 Hubble Network, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SRC_REED_SOLOMON_DECODER_H
+#define SRC_REED_SOLOMON_DECODER_H
+
+#include <stdint.h>
+
+/* Largest error correcting capability supported by the decoder */
+#define RSD_TT_MAX 8
+
+/**
+ * @brief Decodes a Reed-Solomon codeword produced by ~rse_rs_encode~.
+ *
+ * The codeword is the @p kk data symbols followed by the 2 * @p tt parity
+ * symbols, in the order they are transmitted. It is corrected in place.
+ *
+ * Errors and erasures (symbols known to be unreliable) are corrected as
+ * long as 2 * errors + erasures <= 2 * @p tt. @p data is left untouched
+ * when the codeword cannot be corrected.
+ *
+ * The decoder keeps no state, it can be called from several threads.
+ *
+ * @param[in,out] data          Codeword of kk + 2 * tt symbols.
+ * @param[in]     kk            Number of data symbols.
+ * @param[in]     tt            Number of errors the code can correct, at
+ *                              most RSD_TT_MAX.
+ * @param[in]     erasures      Positions of the erased symbols in @p data,
+ *                              can be NULL if @p erasure_count is 0.
+ * @param[in]     erasure_count Number of erased symbols.
+ *
+ * @return Number of symbols corrected on success, -EBADMSG if the codeword
+ *         cannot be corrected, -EINVAL if a parameter is invalid.
+ */
+int rsd_rs_decode(uint8_t data[], int kk, int tt, const int erasures[],
+		  int erasure_count);
+
+#endif /* SRC_REED_SOLOMON_DECODER_H */
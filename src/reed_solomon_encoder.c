@@ -45,120 +45,104 @@
 				 Simon Rockliff, 26th June 1991
 */
 
-#include <math.h>
+/*
+ * Reworked since then for the Hubble packets: the codes are fixed to
+ * GF(2^6) with p(X) = 1 + X + X^6, the field tables and the generator
+ * polynomials of the error correcting capabilities in use are constant,
+ * and the parity symbols go to a buffer owned by the caller, so packets
+ * can be encoded from several threads without any setup.
+ */
+
+#include <errno.h>
+#include <stddef.h>
 #include <stdint.h>
-#include <stdio.h>
-
-#define mm  6  /* RS code over GF(2**4) - change to suit */
-#define nn  63 /* nn=2**mm -1   length of codeword */
-#define ttt 3  /* number of errors that can be corrected */
-#define kkk 41 /* kk = nn-2*tt  */
-
-/* specify irreducible polynomial coeffts */
-static int pp[mm + 1] = {1, 1, 0, 0, 0, 0, 1};
-static int alpha_to[nn + 1], index_of[nn + 1], gg[nn - kkk + 1];
-static int bb[nn - kkk];
-
-/* generate GF(2**mm) from the irreducible polynomial p(X) in pp[0]..pp[mm]
-   lookup tables:  index->polynomial form   alpha_to[] contains j=alpha**i;
-		   polynomial form -> index form  index_of[j=alpha**i] = i
-   alpha=2 is the primitive element of GF(2**mm)
-*/
-void rse_gf_generate()
-{
-	register int i, mask;
-	mask = 1;
-	alpha_to[mm] = 0;
-
-	for (i = 0; i < mm; i++) {
-		alpha_to[i] = mask;
-		index_of[alpha_to[i]] = i;
-		if (pp[i] != 0) {
-			alpha_to[mm] ^= mask;
-		}
-		mask <<= 1;
-	}
-	index_of[alpha_to[mm]] = mm;
-	mask >>= 1;
-	for (i = mm + 1; i < nn; i++) {
-		if (alpha_to[i - 1] >= mask) {
-			alpha_to[i] =
-				alpha_to[mm] ^ ((alpha_to[i - 1] ^ mask) << 1);
-		} else {
-			alpha_to[i] = alpha_to[i - 1] << 1;
-		}
-		index_of[alpha_to[i]] = i;
-	}
-	index_of[0] = -1;
-}
 
-/* Obtain the generator polynomial of the tt-error correcting, length
-  nn=(2**mm -1) Reed Solomon code  from the product of (X+alpha**i), i=1..2*tt
-*/
-void rse_poly_generate(int tt)
-{
-	register int i, j;
-	gg[0] = 2; /* primitive element alpha = 2  for GF(2**mm) */
-	gg[1] = 1; /* g(x) = (X+alpha) initially */
-
-	for (i = 2; i <= 2 * tt; i++) {
-		gg[i] = 1;
-		for (j = i - 1; j > 0; j--) {
-			if (gg[j] != 0) {
-				gg[j] = gg[j - 1] ^
-					alpha_to[(index_of[gg[j]] + i) % nn];
-			} else {
-				gg[j] = gg[j - 1];
-			}
-		}
-		gg[0] = alpha_to[(index_of[gg[0]] + i) % nn]; /* gg[0] can never be zero */
-	}
-	/* convert gg[] to index form for quicker encoding */
-	for (i = 0; i <= 2 * tt; i++) {
-		gg[i] = index_of[gg[i]];
-	}
-}
+#include "reed_solomon_encoder.h"
+
+#define NN RSE_NN
+#define A0 RSE_GF_LOG_ZERO
+
+/*
+ * alpha^i, twice so that the sum of two logs does not need a modulo. The
+ * entries from A0 on are 0, so multiplying by 0 does not need a branch.
+ */
+const uint8_t rse_gf_exp[2 * RSE_GF_LOG_ZERO + 1] = {
+	1, 2, 4, 8, 16, 32, 3, 6, 12, 24, 48, 35, 5, 10, 20, 40, 19, 38, 15,
+	30, 60, 59, 53, 41, 17, 34, 7, 14, 28, 56, 51, 37, 9, 18, 36, 11, 22,
+	44, 27, 54, 47, 29, 58, 55, 45, 25, 50, 39, 13, 26, 52, 43, 21, 42, 23,
+	46, 31, 62, 63, 61, 57, 49, 33, 1, 2, 4, 8, 16, 32, 3, 6, 12, 24, 48,
+	35, 5, 10, 20, 40, 19, 38, 15, 30, 60, 59, 53, 41, 17, 34, 7, 14, 28,
+	56, 51, 37, 9, 18, 36, 11, 22, 44, 27, 54, 47, 29, 58, 55, 45, 25, 50,
+	39, 13, 26, 52, 43, 21, 42, 23, 46, 31, 62, 63, 61, 57, 49, 33,
+};
+
+/* log_alpha(x), the entry of 0 is A0 */
+const uint8_t rse_gf_log[RSE_NN + 1] = {
+	A0, 0, 1, 6, 2, 12, 7, 26, 3, 32, 13, 35, 8, 48, 27, 18, 4, 24, 33,
+	16, 14, 52, 36, 54, 9, 45, 49, 38, 28, 41, 19, 56, 5, 62, 25, 11, 34,
+	31, 17, 47, 15, 23, 53, 51, 37, 44, 55, 40, 10, 61, 46, 30, 50, 22, 39,
+	43, 29, 60, 42, 21, 20, 59, 57, 58,
+};
+
+/*
+ * Generator polynomials, product of (X + alpha^i) for i = 1 .. 2tt, in
+ * log form from g_0 to g_2tt-1 (g_2tt is 1). None of the coefficients
+ * is 0.
+ */
+static const uint8_t _gg_t2[4] = {10, 24, 41, 19};
+static const uint8_t _gg_t5[10] = {55, 37, 61, 6, 1, 60, 53, 47, 28, 56};
+static const uint8_t _gg_t6[12] = {
+	15, 62, 1, 20, 32, 10, 28, 60, 6, 44, 12, 60,
+};
+static const uint8_t _gg_t7[14] = {
+	42, 11, 21, 42, 32, 21, 56, 7, 41, 54, 50, 45, 9, 47,
+};
+static const uint8_t _gg_t8[16] = {
+	10, 21, 17, 23, 21, 12, 25, 50, 38, 33, 54, 24, 16, 1, 41, 28,
+};
+
+static const uint8_t *const _generators[RSE_TT_MAX + 1] = {
+	[2] = _gg_t2, [5] = _gg_t5, [6] = _gg_t6, [7] = _gg_t7, [8] = _gg_t8,
+};
 
 /* take the string of symbols in data[i], i=0..(k-1) and encode systematically
    to produce 2*tt parity symbols in bb[0]..bb[2*tt-1]
-   data[] is input and bb[] is output in polynomial form.
    Encoding is done by using a feedback shift register with appropriate
-   connections specified by the elements of gg[], which was generated above.
+   connections specified by the elements of gg[].
    Codeword is   c(X) = data(X)*X**(nn-kk)+ b(X)
 */
-int *rse_rs_encode(int data[], int kk, int tt)
+int rse_rs_encode(const uint8_t data[], int kk, int tt, uint8_t parity[])
 {
-	register int i, j, temp;
-	int feedback;
+	const uint8_t *gg;
+	uint8_t bb[2 * RSE_TT_MAX] = {0};
+	int n = 2 * tt;
 
-	for (i = 0; i < 2 * tt; i++) {
-		bb[i] = 0;
+	if ((data == NULL) || (parity == NULL) || (kk <= 0) || (tt <= 0) ||
+	    (tt > RSE_TT_MAX) || (kk + n > NN) || (_generators[tt] == NULL)) {
+		return -EINVAL;
 	}
-	for (i = 0; i < kk; i++) {
-		feedback = index_of[data[i] ^ bb[2 * tt - 1]];
-		if (feedback != -1) {
-			for (j = 2 * tt - 1; j > 0; j--) {
-				if (gg[j] != -1) {
-					bb[j] = bb[j - 1] ^
-						alpha_to[(gg[j] + feedback) % nn];
-				} else {
-					bb[j] = bb[j - 1];
-				}
-			}
-			bb[0] = alpha_to[(gg[0] + feedback) % nn];
-		} else {
-			for (j = 2 * tt - 1; j > 0; j--) {
-				bb[j] = bb[j - 1];
-			}
-			bb[0] = 0;
+
+	gg = _generators[tt];
+
+	for (int i = 0; i < kk; i++) {
+		unsigned int feedback;
+
+		if (data[i] > NN) {
+			return -EINVAL;
+		}
+
+		/* A0 when the feedback is 0, every tap then gives 0 */
+		feedback = rse_gf_log[data[i] ^ bb[n - 1]];
+		for (int j = n - 1; j > 0; j--) {
+			bb[j] = bb[j - 1] ^ rse_gf_exp[gg[j] + feedback];
 		}
+		bb[0] = rse_gf_exp[gg[0] + feedback];
 	}
 
-	for (i = 0; i < tt; i++) {
-		temp = bb[i];
-		bb[i] = bb[2 * tt - i - 1];
-		bb[2 * tt - i - 1] = temp;
+	/* Highest degree first, the order the symbols are transmitted in */
+	for (int i = 0; i < n; i++) {
+		parity[i] = bb[n - 1 - i];
 	}
 
-	return bb;
+	return 0;
 }
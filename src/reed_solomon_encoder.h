@@ -9,46 +9,44 @@
 
 #include <stdint.h>
 
+/* Length of a full codeword, 2^6 - 1 symbols */
+#define RSE_NN 63
+
+/* Log of 0 in ~rse_gf_log~, exponents from it on give 0 in ~rse_gf_exp~ */
+#define RSE_GF_LOG_ZERO (2 * RSE_NN)
+
+/* Largest error correcting capability supported by the encoder */
+#define RSE_TT_MAX 8
+
 /**
- * @brief Generates the Galois Field (GF) for Reed-Solomon encoding.
- *
- * This function initializes the lookup tables required for efficient arithmetic
- * operations in the Galois Field. It must be called before any other encoding
- * functions.
- *
- * @note This function does not take any parameters or return any values.
+ * @brief Antilog table of GF(2^6): alpha^i for i < 2 * RSE_NN, 0 after.
  */
-void rse_gf_generate(void);
+extern const uint8_t rse_gf_exp[2 * RSE_GF_LOG_ZERO + 1];
 
 /**
- * @brief Generates the generator polynomial for the Reed-Solomon code.
- *
- * The generator polynomial is used to encode data and append parity symbols.
- *
- * @param[in] tt The number of error-correcting symbols (or the error-correcting
- *               capability of the code).
- *
- * @note Ensure that the Galois Field is generated using ~rse_gf_generate~
- *       before calling this function.
+ * @brief Log table of GF(2^6), the entry of 0 is RSE_GF_LOG_ZERO.
  */
-void rse_poly_generate(int tt);
+extern const uint8_t rse_gf_log[RSE_NN + 1];
 
 /**
  * @brief Encodes the input data using the Reed-Solomon algorithm.
  *
- * This function takes an array of input data symbols, appends parity symbols,
- * and returns the encoded message.
+ * This function takes an array of input data symbols and computes the
+ * parity symbols to append to them. It does not keep any state, so it
+ * can be called from several threads.
  *
- * @param[in] data Array of input data symbols to be encoded.
- * @param[in] kk Number of data symbols.
- * @param[in] tt Number of error-correcting symbols.
+ * @param[in]  data   Array of input data symbols to be encoded.
+ * @param[in]  kk     Number of data symbols.
+ * @param[in]  tt     Number of errors the code can correct, one of 2, 5,
+ *                    6, 7 or 8.
+ * @param[out] parity Array of 2 * @p tt symbols that receives the parity
+ *                    symbols, in the order they are transmitted.
  *
- * @return A pointer to an array containing the encoded data, including
- *         parity symbols.
+ * @return 0 on success, -EINVAL if a parameter is invalid, @p tt is not
+ *         supported or a data symbol does not fit in 6 bits.
  *
  * @note The total length of the encoded message is ~kk + 2 * tt~.
- *       The caller is responsible for managing the memory of the returned array.
  */
-int *rse_rs_encode(int data[], int kk, int tt);
+int rse_rs_encode(const uint8_t data[], int kk, int tt, uint8_t parity[]);
 
 #endif /* SRC_REED_SOLOMON_ENCODER_H */
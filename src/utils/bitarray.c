@@ -8,25 +8,6 @@
 #include "macros.h"
 
 #include <errno.h>
-#include <stdlib.h>
-#include <sys/types.h>
-
-static int _append_bit(struct hubble_bitarray *bit_array, uint8_t value)
-{
-	size_t index = bit_array->index;
-
-	if (value != 0U) {
-		bit_array->data[index / HUBBLE_BITS_PER_BYTE] |=
-			(1 << (index % HUBBLE_BITS_PER_BYTE));
-	} else {
-		bit_array->data[index / HUBBLE_BITS_PER_BYTE] &=
-			~(1 << (index % HUBBLE_BITS_PER_BYTE));
-	}
-
-	bit_array->index++;
-
-	return 0;
-}
 
 int hubble_bitarray_set_bit(struct hubble_bitarray *bit_array, size_t index,
 			    uint8_t value)
@@ -57,36 +38,153 @@ int hubble_bitarray_get_bit(struct hubble_bitarray *bit_array, size_t index)
 	       1;
 }
 
+/* Largest field written at once, so that it fits in the accumulator along
+ * with the bits already in the last byte.
+ */
+#define HUBBLE_BITARRAY_CHUNK_BITS 24U
+
+/* Bits in a symbol, 3 bytes hold 4 of them */
+#define HUBBLE_BITARRAY_SYMBOL_BITS 6U
+
+static uint32_t _bit_reverse(uint32_t value)
+{
+	value = ((value >> 1) & 0x55555555U) | ((value & 0x55555555U) << 1);
+	value = ((value >> 2) & 0x33333333U) | ((value & 0x33333333U) << 2);
+	value = ((value >> 4) & 0x0F0F0F0FU) | ((value & 0x0F0F0F0FU) << 4);
+	value = ((value >> 8) & 0x00FF00FFU) | ((value & 0x00FF00FFU) << 8);
+
+	return (value >> 16) | (value << 16);
+}
+
+/*
+ * Writes the @p len (at most HUBBLE_BITARRAY_CHUNK_BITS) least significant
+ * bits of @p value, most significant first, the bits above are ignored.
+ * The first bit of the stream is the least significant bit of data[0], so
+ * the field is bit reversed and merged with the bits already in the last
+ * byte.
+ */
+static void _append_chunk(struct hubble_bitarray *bit_array, uint32_t value,
+			  size_t len)
+{
+	size_t offset = bit_array->index % HUBBLE_BITS_PER_BYTE;
+	uint8_t *data;
+	uint32_t acc;
+
+	data = &bit_array->data[bit_array->index / HUBBLE_BITS_PER_BYTE];
+
+	acc = (_bit_reverse(value) >> (32U - len)) << offset;
+	acc |= data[0] & ((1U << offset) - 1U);
+
+	bit_array->index += len;
+	len += offset;
+
+	for (; len >= HUBBLE_BITS_PER_BYTE; len -= HUBBLE_BITS_PER_BYTE) {
+		*data++ = (uint8_t)acc;
+		acc >>= HUBBLE_BITS_PER_BYTE;
+	}
+
+	/* Bits past the end are left as they were */
+	if (len > 0U) {
+		*data = (*data & ~((1U << len) - 1U)) | (uint8_t)acc;
+	}
+}
+
+int hubble_bitarray_append_value(struct hubble_bitarray *bit_array,
+				 uint32_t value, size_t len)
+{
+	if ((len > 32U) || ((bit_array->index + len) >=
+			    (HUBBLE_MAX_SYMBOLS * HUBBLE_BITS_PER_BYTE))) {
+		return -EINVAL;
+	}
+
+	if (len > HUBBLE_BITARRAY_CHUNK_BITS) {
+		_append_chunk(bit_array, value >> HUBBLE_BITARRAY_CHUNK_BITS,
+			      len - HUBBLE_BITARRAY_CHUNK_BITS);
+		len = HUBBLE_BITARRAY_CHUNK_BITS;
+	}
+
+	if (len > 0U) {
+		_append_chunk(bit_array, value, len);
+	}
+
+	return 0;
+}
+
 int hubble_bitarray_append(struct hubble_bitarray *bit_array,
 			   const uint8_t *input, size_t input_len_bits)
 {
-	size_t byte_index = input_len_bits / HUBBLE_BITS_PER_BYTE;
-
 	if ((bit_array->index + input_len_bits) >=
 	    (HUBBLE_MAX_SYMBOLS * HUBBLE_BITS_PER_BYTE)) {
 		return -EINVAL;
 	}
 
-	for (ssize_t i = input_len_bits - 1, j = 0; i >= 0; i--, j++) {
-		int err;
-		uint8_t bit_value;
-
-		if (((i + 1) % HUBBLE_BITS_PER_BYTE) == 0) {
-			byte_index--;
+	/*
+	 * The input is a little endian integer written most significant bit
+	 * first: go from its last chunk down, the chunks below the first one
+	 * are whole bytes.
+	 */
+	while (input_len_bits > 0U) {
+		size_t len = input_len_bits % HUBBLE_BITARRAY_CHUNK_BITS;
+		const uint8_t *chunk;
+		uint32_t value;
+
+		if (len == 0U) {
+			len = HUBBLE_BITARRAY_CHUNK_BITS;
 		}
-		bit_value = (input[byte_index] >> (i % HUBBLE_BITS_PER_BYTE)) &
-			    1; // Extract the i-th bit from the character
-		err = _append_bit(bit_array,
-				  bit_value); // Set the bit in the array
 
-		if (err != 0) {
-			return err;
+		chunk = &input[(input_len_bits - len) / HUBBLE_BITS_PER_BYTE];
+		value = chunk[0];
+		for (size_t i = 1; (i * HUBBLE_BITS_PER_BYTE) < len; i++) {
+			value |= (uint32_t)chunk[i]
+				 << (i * HUBBLE_BITS_PER_BYTE);
 		}
+
+		_append_chunk(bit_array, value, len);
+		input_len_bits -= len;
 	}
 
 	return 0;
 }
 
+int hubble_bitarray_symbols_get(const struct hubble_bitarray *bit_array,
+				uint8_t *symbols, size_t symbols_size)
+{
+	size_t bytes = (bit_array->index + HUBBLE_BITS_PER_BYTE - 1U) /
+		       HUBBLE_BITS_PER_BYTE;
+	size_t count = (bit_array->index + HUBBLE_BITARRAY_SYMBOL_BITS - 1U) /
+		       HUBBLE_BITARRAY_SYMBOL_BITS;
+
+	if (count > symbols_size) {
+		return -EINVAL;
+	}
+
+	/* 3 bytes give 4 symbols */
+	for (size_t i = 0, byte = 0; i < count; i += 4, byte += 3) {
+		size_t left = bit_array->index - (byte * HUBBLE_BITS_PER_BYTE);
+		uint32_t value = 0U;
+
+		for (size_t j = 0; (j < 3U) && ((byte + j) < bytes); j++) {
+			value |= (uint32_t)bit_array->data[byte + j]
+				 << (j * HUBBLE_BITS_PER_BYTE);
+		}
+
+		/* The last symbol is padded with zeros */
+		if (left < HUBBLE_BITARRAY_CHUNK_BITS) {
+			value &= (1UL << left) - 1U;
+		}
+
+		/* First bit of the stream on bit 23 */
+		value = _bit_reverse(value) >> 8;
+
+		for (size_t j = i; (j < (i + 4U)) && (j < count); j++) {
+			symbols[j] = (value >> 18U) & 0x3FU;
+			value <<= HUBBLE_BITARRAY_SYMBOL_BITS;
+		}
+	}
+
+	return count;
+}
+
 void hubble_bitarray_init(struct hubble_bitarray *bit_array)
 {
 	bit_array->index = 0;
@@ -42,6 +42,36 @@ void hubble_bitarray_init(struct hubble_bitarray *bit_array);
 int hubble_bitarray_append(struct hubble_bitarray *bit_array,
 			   const uint8_t *input, size_t input_len_bits);
 
+/**
+ * @brief Append an integer to a hubble bit array.
+ *
+ * This function appends the @p len least significant bits of @p value,
+ * most significant bit first, like hubble_bitarray_append() does with the
+ * bytes of a little endian integer.
+ *
+ * @param bit_array Pointer to the hubble bit array structure.
+ * @param value Value to append.
+ * @param len Number of bits to append, at most 32.
+ * @return int 0 on success, non-zero on failure.
+ **/
+int hubble_bitarray_append_value(struct hubble_bitarray *bit_array,
+				 uint32_t value, size_t len);
+
+/**
+ * @brief Split a hubble bit array in 6 bits symbols.
+ *
+ * The first bit of the array becomes the most significant bit of the first
+ * symbol. The last symbol is padded with zeros.
+ *
+ * @param bit_array Pointer to the hubble bit array structure.
+ * @param symbols Output symbols.
+ * @param symbols_size Number of entries in @p symbols.
+ * @return int Number of symbols on success, -EINVAL if they do not fit in
+ *         @p symbols.
+ **/
+int hubble_bitarray_symbols_get(const struct hubble_bitarray *bit_array,
+				uint8_t *symbols, size_t symbols_size);
+
 /**
  * @brief Set a bit in the hubble bit array.
  *
@@ -29,6 +29,20 @@
 
 #define HUBBLE_BITS_PER_BYTE 8U
 
+#define HUBBLE_BIT(n)        (1UL << (n))
+
+/* Prevents the compiler from re-ordering memory accesses across it */
+#define HUBBLE_COMPILER_BARRIER() __asm__ volatile("" ::: "memory")
+
+/* Weak symbols, for port functions with a default implementation */
+#if defined(__CC_ARM)
+#define HUBBLE_WEAK __attribute__((weak))
+#elif defined(__ICCARM__)
+#define HUBBLE_WEAK __weak
+#elif defined(__GNUC__)
+#define HUBBLE_WEAK __attribute__((weak))
+#endif
+
 #define HUBBLE_KEY_SIZE_BITS (CONFIG_HUBBLE_KEY_SIZE * HUBBLE_BITS_PER_BYTE)
 
 #endif /* SRC_UTILS_MACROS_H */
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2026 Hubble Network, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Measure the throughput of hubble_eid_batch_get() from one thread up
+ * to the number of online CPUs (or the given maximum), doubling the
+ * number of threads each time. The EIDs of every run are checked
+ * against the single thread run.
+ */
+
+#include <hubble/eid_index.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCHMARK_KEYS         100000U
+#define BENCHMARK_DAYS         2U
+#define BENCHMARK_TIME_COUNTER 20000U
+
+static double _now_s(void)
+{
+	struct timespec ts;
+
+	(void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+static double _batch_run(const uint8_t (*keys)[CONFIG_HUBBLE_KEY_SIZE],
+			 uint32_t key_count, uint32_t days, uint32_t *eids,
+			 unsigned int threads)
+{
+	double start = _now_s();
+	int err = hubble_eid_batch_get(keys, key_count, BENCHMARK_TIME_COUNTER,
+				       days, eids, threads);
+
+	if (err != 0) {
+		fprintf(stderr, "hubble_eid_batch_get() failed: %d\n", err);
+		exit(EXIT_FAILURE);
+	}
+
+	return _now_s() - start;
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t key_count = (argc > 1) ? strtoul(argv[1], NULL, 0)
+					: BENCHMARK_KEYS;
+	uint32_t days = (argc > 2) ? strtoul(argv[2], NULL, 0)
+				   : BENCHMARK_DAYS;
+	long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	unsigned int max_threads = (argc > 3)
+					   ? strtoul(argv[3], NULL, 0)
+					   : ((cpus > 0) ? (unsigned int)cpus
+							 : 1U);
+	uint8_t (*keys)[CONFIG_HUBBLE_KEY_SIZE];
+	uint32_t *expected;
+	uint32_t *eids;
+	double base;
+
+	if ((key_count == 0U) || (days == 0U) || (max_threads == 0U)) {
+		fprintf(stderr, "usage: %s [keys] [days] [max threads]\n",
+			argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	keys = malloc((size_t)key_count * sizeof(*keys));
+	expected = malloc((size_t)key_count * days * sizeof(*expected));
+	eids = malloc((size_t)key_count * days * sizeof(*eids));
+	if ((keys == NULL) || (expected == NULL) || (eids == NULL)) {
+		fprintf(stderr, "out of memory\n");
+		return EXIT_FAILURE;
+	}
+
+	srand(1);
+	for (size_t i = 0; i < (size_t)key_count * sizeof(*keys); i++) {
+		((uint8_t *)keys)[i] = (uint8_t)rand();
+	}
+
+	printf("%u keys, %u days, %ld online CPUs\n", key_count, days, cpus);
+	printf("threads     EIDs/s  speedup  efficiency\n");
+
+	base = _batch_run((const uint8_t (*)[CONFIG_HUBBLE_KEY_SIZE])keys,
+			  key_count, days, expected, 1U);
+
+	for (unsigned int threads = 1U; threads <= max_threads;
+	     threads *= 2U) {
+		double elapsed = _batch_run(
+			(const uint8_t (*)[CONFIG_HUBBLE_KEY_SIZE])keys,
+			key_count, days, eids, threads);
+
+		if (memcmp(eids, expected,
+			   (size_t)key_count * days * sizeof(*eids)) != 0) {
+			fprintf(stderr, "%u threads: EIDs differ\n", threads);
+			return EXIT_FAILURE;
+		}
+
+		printf("%7u %10.0f %8.2f %10.0f%%\n", threads,
+		       ((double)key_count * days) / elapsed, base / elapsed,
+		       (100.0 * base) / (elapsed * threads));
+
+		/* Also measure the exact CPU count when not a power of 2 */
+		if ((threads < max_threads) && ((threads * 2U) > max_threads)) {
+			threads = max_threads / 2U;
+		}
+	}
+
+	free(keys);
+	free(expected);
+	free(eids);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2026 Hubble Network, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Measure the cost of packing the fields of a satellite packet payload,
+ * against a bit at a time packer.
+ */
+
+#include <utils/bitarray.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/ztest.h>
+
+#include <string.h>
+
+#include "benchmark.h"
+
+#define BENCHMARK_ITERATIONS 1024U
+
+/* Version, sequence number, device ID, authentication tag and payload */
+static const size_t field_bits[] = {2, 10, 32, 32, 104};
+
+static const uint8_t field_data[13] = {
+	0x48, 0x75, 0x62, 0x62, 0x6c, 0x65, 0x20,
+	0x4e, 0x65, 0x74, 0x77, 0x6f, 0x72,
+};
+
+/* What hubble_bitarray_append() used to do */
+static void _reference_append(struct hubble_bitarray *bit_array,
+			      const uint8_t *input, size_t input_len_bits)
+{
+	for (size_t i = input_len_bits; i > 0; i--) {
+		size_t index = bit_array->index++;
+		uint8_t bit = (input[(i - 1) / 8] >> ((i - 1) % 8)) & 1;
+
+		if (bit != 0U) {
+			bit_array->data[index / 8] |= 1 << (index % 8);
+		} else {
+			bit_array->data[index / 8] &= ~(1 << (index % 8));
+		}
+	}
+}
+
+ZTEST(bitarray_benchmark, test_append_payload)
+{
+	static struct hubble_bitarray bit_array;
+	static struct hubble_bitarray expected;
+	uint32_t start, cycles;
+
+	start = benchmark_start();
+	for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+		hubble_bitarray_init(&bit_array);
+		for (size_t f = 0; f < ARRAY_SIZE(field_bits); f++) {
+			zassert_ok(hubble_bitarray_append(
+				&bit_array, field_data, field_bits[f]));
+		}
+	}
+	cycles = benchmark_cycles(start);
+
+	benchmark_print("append (180 bits)", cycles, BENCHMARK_ITERATIONS);
+
+	start = benchmark_start();
+	for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+		hubble_bitarray_init(&expected);
+		for (size_t f = 0; f < ARRAY_SIZE(field_bits); f++) {
+			_reference_append(&expected, field_data, field_bits[f]);
+		}
+	}
+	cycles = benchmark_cycles(start);
+
+	benchmark_print("bit at a time (180 bits)", cycles,
+			BENCHMARK_ITERATIONS);
+
+	zassert_equal(bit_array.index, expected.index);
+	zassert_mem_equal(bit_array.data, expected.data,
+			  DIV_ROUND_UP(expected.index, 8));
+}
+
+ZTEST(bitarray_benchmark, test_append_value)
+{
+	static struct hubble_bitarray bit_array;
+	uint32_t start, cycles;
+
+	start = benchmark_start();
+	for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+		hubble_bitarray_init(&bit_array);
+		for (size_t f = 0; f < 4; f++) {
+			zassert_ok(hubble_bitarray_append_value(
+				&bit_array, i, field_bits[f]));
+		}
+	}
+	cycles = benchmark_cycles(start);
+
+	benchmark_print("append value (76 bits)", cycles,
+			BENCHMARK_ITERATIONS);
+}
+
+ZTEST_SUITE(bitarray_benchmark, NULL, NULL, NULL, NULL, NULL);
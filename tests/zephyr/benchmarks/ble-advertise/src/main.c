@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2026 Hubble Network, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Measure the cost of building BLE advertisements. Run the test
+ * variants (see testcase.yaml) to compare the different crypto
+ * configurations.
+ */
+
+#include <hubble/hubble.h>
+#include <hubble/ble.h>
+#include <hubble/port/crypto.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/ztest.h>
+
+#include "benchmark.h"
+
+#define BENCHMARK_ITERATIONS    256U
+#define TEST_ADV_BUFFER_SZ      31
+#define TIMER_COUNTER_FREQUENCY 86400000ULL
+
+static uint16_t test_seq;
+
+static const uint64_t test_utc_time = (uint64_t)20 * TIMER_COUNTER_FREQUENCY;
+
+static const uint8_t test_key[CONFIG_HUBBLE_KEY_SIZE] = {
+	0xcd, 0x15, 0xa5, 0xab, 0xc0, 0x60, 0xb6, 0x72, 0x88, 0xa6, 0x1e,
+	0x44, 0xe9, 0x95, 0xba, 0x77, 0xd1, 0x40, 0xbd, 0x46, 0x56, 0x4b,
+	0x88, 0xde, 0x41, 0xc1, 0x5a, 0x92, 0x73, 0xb0, 0xce, 0x85};
+
+uint16_t hubble_sequence_counter_get(void)
+{
+	return test_seq++ & HUBBLE_MAX_SEQ_COUNTER;
+}
+
+uint64_t hubble_uptime_get(void)
+{
+	return 0;
+}
+
+static void _advertise_run(const char *name, const uint8_t *payload,
+			   size_t payload_len)
+{
+	uint8_t output[TEST_ADV_BUFFER_SZ];
+	uint32_t start, cycles;
+
+	start = benchmark_start();
+	for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+		size_t output_len = sizeof(output);
+
+		zassert_ok(hubble_ble_advertise_get(payload, payload_len,
+						    output, &output_len));
+	}
+	cycles = benchmark_cycles(start);
+
+	benchmark_print(name, cycles, BENCHMARK_ITERATIONS);
+}
+
+ZTEST(ble_advertise_benchmark, test_advertise_empty)
+{
+	_advertise_run("advertise (0 bytes)", NULL, 0);
+}
+
+ZTEST(ble_advertise_benchmark, test_advertise_max_payload)
+{
+	uint8_t payload[HUBBLE_BLE_MAX_DATA_LEN] = {0};
+
+	_advertise_run("advertise (13 bytes)", payload, sizeof(payload));
+}
+
+ZTEST(ble_advertise_benchmark, test_advertise_batch)
+{
+	static uint8_t frames[BENCHMARK_ITERATIONS][HUBBLE_BLE_ADV_FRAME_SIZE];
+	uint8_t payload[HUBBLE_BLE_MAX_DATA_LEN] = {0};
+	size_t frames_len;
+	uint32_t start, cycles;
+
+	start = benchmark_start();
+	zassert_ok(hubble_ble_advertise_batch_get(payload, sizeof(payload), 0,
+						  BENCHMARK_ITERATIONS, frames,
+						  &frames_len));
+	cycles = benchmark_cycles(start);
+
+	benchmark_print("advertise batch (13 bytes)", cycles,
+			BENCHMARK_ITERATIONS);
+}
+
+ZTEST(ble_advertise_benchmark, test_crypto_cmac)
+{
+	uint8_t input[HUBBLE_AES_BLOCK_SIZE] = {0};
+	uint8_t output[HUBBLE_AES_BLOCK_SIZE];
+	uint32_t start, cycles;
+
+	/* Same key on every call, like the keys derived from the master key */
+	start = benchmark_start();
+	for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+		zassert_ok(hubble_crypto_cmac(test_key, input, sizeof(input),
+					      output));
+	}
+	cycles = benchmark_cycles(start);
+
+	benchmark_print("cmac (16 bytes)", cycles, BENCHMARK_ITERATIONS);
+}
+
+static void *ble_advertise_benchmark_setup(void)
+{
+	zassert_ok(hubble_init(test_utc_time, test_key));
+	test_seq = 0;
+
+	return NULL;
+}
+
+ZTEST_SUITE(ble_advertise_benchmark, NULL, ble_advertise_benchmark_setup,
+	    NULL, NULL, NULL);
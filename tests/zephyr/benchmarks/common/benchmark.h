@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2026 Hubble Network, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Timing helpers shared by the benchmarks. */
+
+#ifndef TESTS_ZEPHYR_BENCHMARKS_COMMON_BENCHMARK_H
+#define TESTS_ZEPHYR_BENCHMARKS_COMMON_BENCHMARK_H
+
+#include <stdint.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+/* Cycle counter at the start of a measurement */
+static inline uint32_t benchmark_start(void)
+{
+	return k_cycle_get_32();
+}
+
+/* Cycles elapsed since @p start */
+static inline uint32_t benchmark_cycles(uint32_t start)
+{
+	return k_cycle_get_32() - start;
+}
+
+/* Prints the cost of one @p unit and the throughput, @p count of them
+ * took @p cycles.
+ */
+static inline void benchmark_print_unit(const char *name, const char *unit,
+					uint32_t cycles, uint32_t count)
+{
+	uint64_t ns = k_cyc_to_ns_floor64(cycles);
+
+	TC_PRINT("%s: %u cycles/%s, %llu ns/%s, %llu %ss/s\n", name,
+		 cycles / count, unit, ns / count, unit,
+		 (ns > 0U) ? ((uint64_t)count * NSEC_PER_SEC) / ns : 0U,
+		 unit);
+}
+
+static inline void benchmark_print(const char *name, uint32_t cycles,
+				   uint32_t count)
+{
+	benchmark_print_unit(name, "op", cycles, count);
+}
+
+#endif /* TESTS_ZEPHYR_BENCHMARKS_COMMON_BENCHMARK_H */
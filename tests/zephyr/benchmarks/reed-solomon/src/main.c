@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2026 Hubble Network, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Measure the Reed-Solomon encoder and decoder throughput, in codewords
+ * per second, on the largest satellite payload code.
+ */
+
+#include <reed_solomon_decoder.h>
+#include <reed_solomon_encoder.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/ztest.h>
+
+#include <string.h>
+
+#include "benchmark.h"
+
+#define BENCHMARK_ITERATIONS 1024U
+
+/* RS(46, 30), 13 bytes payload */
+#define BENCHMARK_KK 30
+#define BENCHMARK_TT 8
+#define BENCHMARK_NN (BENCHMARK_KK + (2 * BENCHMARK_TT))
+
+static uint8_t codeword[BENCHMARK_NN];
+
+/* Decodes the codeword with @p errors errors and @p erasure_count erasures */
+static void _decode_run(const char *name, int errors, int erasure_count)
+{
+	uint8_t received[BENCHMARK_NN];
+	int erasures[2 * BENCHMARK_TT];
+	uint32_t start, cycles = 0U;
+
+	for (int i = 0; i < erasure_count; i++) {
+		erasures[i] = 2 * i;
+	}
+
+	for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+		int ret;
+
+		/* Erasures on even positions, errors on odd ones */
+		memcpy(received, codeword, sizeof(received));
+		for (int e = 0; e < erasure_count; e++) {
+			received[2 * e] ^= 1 + ((i + e) % 63);
+		}
+		for (int e = 0; e < errors; e++) {
+			received[(2 * e) + 1] ^= 1 + ((i + e) % 63);
+		}
+
+		start = benchmark_start();
+		ret = rsd_rs_decode(received, BENCHMARK_KK, BENCHMARK_TT,
+				    erasures, erasure_count);
+		cycles += benchmark_cycles(start);
+
+		zassert_true(ret >= 0);
+	}
+
+	zassert_mem_equal(received, codeword, sizeof(received));
+
+	benchmark_print_unit(name, "codeword", cycles,
+			     BENCHMARK_ITERATIONS);
+}
+
+ZTEST(reed_solomon_benchmark, test_decode_clean)
+{
+	_decode_run("decode (no errors)", 0, 0);
+}
+
+ZTEST(reed_solomon_benchmark, test_decode_errors)
+{
+	_decode_run("decode (8 errors)", BENCHMARK_TT, 0);
+}
+
+ZTEST(reed_solomon_benchmark, test_decode_erasures)
+{
+	_decode_run("decode (16 erasures)", 0, 2 * BENCHMARK_TT);
+}
+
+ZTEST(reed_solomon_benchmark, test_decode_mixed)
+{
+	_decode_run("decode (4 errors, 8 erasures)", BENCHMARK_TT / 2,
+		    BENCHMARK_TT);
+}
+
+ZTEST(reed_solomon_benchmark, test_encode)
+{
+	uint8_t parity[2 * BENCHMARK_TT];
+	uint32_t start, cycles;
+
+	start = benchmark_start();
+	for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+		zassert_ok(rse_rs_encode(codeword, BENCHMARK_KK, BENCHMARK_TT,
+					 parity));
+	}
+	cycles = benchmark_cycles(start);
+
+	zassert_mem_equal(parity, &codeword[BENCHMARK_KK], sizeof(parity));
+
+	benchmark_print_unit("encode", "codeword", cycles,
+			     BENCHMARK_ITERATIONS);
+}
+
+static void *reed_solomon_benchmark_setup(void)
+{
+	for (int i = 0; i < BENCHMARK_KK; i++) {
+		codeword[i] = (i * 37) % 64;
+	}
+
+	zassert_ok(rse_rs_encode(codeword, BENCHMARK_KK, BENCHMARK_TT,
+				 &codeword[BENCHMARK_KK]));
+
+	return NULL;
+}
+
+ZTEST_SUITE(reed_solomon_benchmark, NULL, reed_solomon_benchmark_setup, NULL,
+	    NULL, NULL);
@@ -12,6 +12,7 @@
 #include <zephyr/types.h>
 #include <zephyr/ztest.h>
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -37,13 +38,21 @@ int hubble_sat_board_init(void)
 	return 0;
 }
 
+static bool _board_on;
+static uint8_t _enable_count;
+
 int hubble_sat_board_enable(void)
 {
+	_board_on = true;
+	_enable_count++;
+
 	return 0;
 }
 
 int hubble_sat_board_disable(void)
 {
+	_board_on = false;
+
 	return 0;
 }
 
@@ -144,6 +153,362 @@ ZTEST(sat_test, test_profile)
 	zassert_equal(0, _transmission_count);
 }
 
+#ifdef CONFIG_HUBBLE_SAT_NETWORK_ASYNC
+static K_SEM_DEFINE(_sent_sem, 0, 2);
+static int _sent_status;
+static void *_sent_user_data;
+
+static void _sent_cb(int status, void *user_data)
+{
+	_sent_status = status;
+	_sent_user_data = user_data;
+	k_sem_give(&_sent_sem);
+}
+#endif
+
+ZTEST(sat_test, test_profile_async)
+{
+	int err;
+	struct hubble_sat_packet pkt;
+
+#ifndef CONFIG_HUBBLE_SAT_NETWORK_ASYNC
+	err = hubble_sat_packet_send_async(&pkt, HUBBLE_SAT_RELIABILITY_NONE,
+					   NULL, NULL);
+	zassert_equal(err, -ENOSYS);
+#else
+	int64_t start;
+
+	err = hubble_sat_packet_get(&pkt, NULL, 0);
+	zassert_ok(err);
+
+	/* Sanity check. Invalid packet and reliability */
+	err = hubble_sat_packet_send_async(NULL, HUBBLE_SAT_RELIABILITY_NORMAL,
+					   _sent_cb, NULL);
+	zassert_equal(err, -EINVAL);
+	err = hubble_sat_packet_send_async(&pkt, 255, _sent_cb, NULL);
+	zassert_equal(err, -EINVAL);
+	zassert_equal(k_sem_take(&_sent_sem, K_NO_WAIT), -EBUSY);
+
+	_transmission_count = 1U;
+	err = hubble_sat_packet_send_async(&pkt, HUBBLE_SAT_RELIABILITY_NONE,
+					   _sent_cb, &pkt);
+	zassert_ok(err);
+	zassert_ok(k_sem_take(&_sent_sem, K_SECONDS(5)));
+	zassert_ok(_sent_status);
+	zassert_equal(_sent_user_data, &pkt);
+	zassert_equal(0, _transmission_count);
+
+	/* The caller is not blocked during the retries */
+	_transmission_count = 8U;
+	err = hubble_sat_packet_send_async(&pkt, HUBBLE_SAT_RELIABILITY_NORMAL,
+					   _sent_cb, NULL);
+	zassert_ok(err);
+	k_sleep(K_SECONDS(1));
+	zassert_equal(7U, _transmission_count);
+	zassert_equal(k_sem_take(&_sent_sem, K_NO_WAIT), -EBUSY);
+
+	zassert_ok(k_sem_take(&_sent_sem, K_SECONDS(8 * 21)));
+	zassert_ok(_sent_status);
+	zassert_equal(0, _transmission_count);
+
+	/* Retries of two packets are interleaved, not done one after the
+	 * other (at least 2 * 7 * 19 s).
+	 */
+	_transmission_count = 16U;
+	start = k_uptime_get();
+	err = hubble_sat_packet_send_async(&pkt, HUBBLE_SAT_RELIABILITY_NORMAL,
+					   _sent_cb, NULL);
+	zassert_ok(err);
+	err = hubble_sat_packet_send_async(&pkt, HUBBLE_SAT_RELIABILITY_NORMAL,
+					   _sent_cb, NULL);
+	zassert_ok(err);
+
+	zassert_ok(k_sem_take(&_sent_sem, K_SECONDS(8 * 21)));
+	zassert_ok(k_sem_take(&_sent_sem, K_SECONDS(8 * 21)));
+	zassert_true(k_uptime_get() - start < (8 * 21 * MSEC_PER_SEC));
+	zassert_equal(0, _transmission_count);
+
+	/* Fire and forget */
+	_transmission_count = 1U;
+	err = hubble_sat_packet_send_async(&pkt, HUBBLE_SAT_RELIABILITY_NONE,
+					   NULL, NULL);
+	zassert_ok(err);
+	k_sleep(K_SECONDS(1));
+	zassert_equal(0, _transmission_count);
+#endif
+}
+
+ZTEST(sat_test, test_session)
+{
+#ifndef CONFIG_HUBBLE_SAT_NETWORK_SESSION
+	zassert_equal(hubble_sat_session_begin(), -ENOSYS);
+	zassert_equal(hubble_sat_session_end(), -ENOSYS);
+#else
+	int err;
+	struct hubble_sat_packet pkt;
+
+	err = hubble_sat_packet_get(&pkt, NULL, 0);
+	zassert_ok(err);
+
+	zassert_equal(hubble_sat_session_end(), -EALREADY);
+
+	/* Without a session, the board is powered for each packet */
+	_enable_count = 0U;
+	_transmission_count = 2U;
+	zassert_ok(hubble_sat_packet_send(&pkt, HUBBLE_SAT_RELIABILITY_NONE));
+	zassert_false(_board_on);
+	zassert_ok(hubble_sat_packet_send(&pkt, HUBBLE_SAT_RELIABILITY_NONE));
+	zassert_false(_board_on);
+	zassert_equal(2U, _enable_count);
+
+	/* Packets close to each other keep it powered */
+	_enable_count = 0U;
+	_transmission_count = 3U;
+	zassert_ok(hubble_sat_session_begin());
+	for (int i = 0; i < 3; i++) {
+		zassert_ok(hubble_sat_packet_send(&pkt,
+						  HUBBLE_SAT_RELIABILITY_NONE));
+		zassert_true(_board_on);
+		k_sleep(K_MSEC(CONFIG_HUBBLE_SAT_NETWORK_SESSION_IDLE_MS / 2));
+	}
+	zassert_equal(1U, _enable_count);
+	zassert_equal(0, _transmission_count);
+
+	/* Powered down once idle for too long, even in a session */
+	k_sleep(K_MSEC(CONFIG_HUBBLE_SAT_NETWORK_SESSION_IDLE_MS));
+	zassert_false(_board_on);
+
+	/* Retries are further apart than the idle time */
+	_enable_count = 0U;
+	_transmission_count = 8U;
+	zassert_ok(hubble_sat_packet_send(&pkt,
+					  HUBBLE_SAT_RELIABILITY_NORMAL));
+	zassert_equal(8U, _enable_count);
+
+	/* Wake-ups do not take the room of the packets */
+	for (int i = 0; i < (CONFIG_HUBBLE_SAT_NETWORK_ASYNC_QUEUE_SIZE * 4);
+	     i++) {
+		zassert_ok(hubble_sat_session_begin());
+		zassert_ok(hubble_sat_session_end());
+	}
+	_transmission_count = CONFIG_HUBBLE_SAT_NETWORK_ASYNC_QUEUE_SIZE;
+	for (int i = 0; i < CONFIG_HUBBLE_SAT_NETWORK_ASYNC_QUEUE_SIZE; i++) {
+		zassert_ok(hubble_sat_packet_send_async(
+			&pkt, HUBBLE_SAT_RELIABILITY_NONE, NULL, NULL));
+	}
+	k_sleep(K_SECONDS(1));
+	zassert_equal(0, _transmission_count);
+
+	/* Ending the session powers the board down right away */
+	_transmission_count = 1U;
+	zassert_ok(hubble_sat_packet_send(&pkt, HUBBLE_SAT_RELIABILITY_NONE));
+	zassert_true(_board_on);
+	zassert_ok(hubble_sat_session_end());
+	k_sleep(K_MSEC(10));
+	zassert_false(_board_on);
+	zassert_equal(hubble_sat_session_end(), -EALREADY);
+#endif
+}
+
+#ifdef CONFIG_HUBBLE_SAT_NETWORK_PASS_WINDOW
+static const struct hubble_sat_orbital_params _orbit = {
+	.t0 = 1711296587,
+	.n0 = 0.00017559780215620866,
+	.ndot = 3.6984685877857914e-14,
+	.raan0 = -2.62346138227064,
+	.raandot = 1.992330418167161e-07,
+	.aop0 = 3.523598389978097,
+	.aopdot = -6.981828658074634e-07,
+	.inclination = 97.4608,
+	.eccentricity = 0.0010652,
+};
+
+static const struct hubble_sat_device_pos _pos = {47.0, -122.0};
+
+/* Predicted within a few seconds */
+#define PASS_T_S         1713564682ULL
+#define PASS_DELTA_S     6ULL
+#define PASS_HALF_WIDTH_S (CONFIG_HUBBLE_SAT_NETWORK_PASS_WINDOW_DURATION_S / 2)
+#endif
+
+ZTEST(sat_test, test_pass_window)
+{
+#ifndef CONFIG_HUBBLE_SAT_NETWORK_PASS_WINDOW
+	zassert_equal(hubble_sat_pass_window_set(NULL, NULL), -ENOSYS);
+	zassert_equal(hubble_sat_pass_window_region_set(NULL, NULL), -ENOSYS);
+#else
+	int err;
+	struct hubble_sat_packet pkt;
+
+	err = hubble_sat_packet_get(&pkt, NULL, 0);
+	zassert_ok(err);
+
+	zassert_equal(hubble_sat_pass_window_set(&_orbit, NULL), -EINVAL);
+	zassert_equal(hubble_sat_pass_window_region_set(&_orbit, NULL),
+		      -EINVAL);
+
+	/* Held until the pass begins */
+	zassert_ok(hubble_utc_set(
+		(PASS_T_S - PASS_HALF_WIDTH_S - PASS_DELTA_S) * MSEC_PER_SEC));
+	zassert_ok(hubble_sat_pass_window_set(&_orbit, &_pos));
+
+	_transmission_count = 1U;
+	err = hubble_sat_packet_send_async(&pkt, HUBBLE_SAT_RELIABILITY_NONE,
+					   _sent_cb, NULL);
+	zassert_ok(err);
+	zassert_equal(k_sem_take(&_sent_sem, K_SECONDS(PASS_DELTA_S / 2)),
+		      -EAGAIN);
+	zassert_equal(1U, _transmission_count);
+	zassert_ok(k_sem_take(&_sent_sem, K_SECONDS(3 * PASS_DELTA_S)));
+	zassert_equal(0, _transmission_count);
+
+	/* Retries left when the pass ends wait for the next one */
+	zassert_ok(hubble_utc_set(
+		(PASS_T_S + PASS_HALF_WIDTH_S - PASS_DELTA_S) * MSEC_PER_SEC));
+	zassert_ok(hubble_sat_pass_window_set(&_orbit, &_pos));
+
+	_transmission_count = 8U;
+	err = hubble_sat_packet_send_async(&pkt, HUBBLE_SAT_RELIABILITY_NORMAL,
+					   _sent_cb, NULL);
+	zassert_ok(err);
+	zassert_equal(k_sem_take(&_sent_sem, K_SECONDS(2 * 21)), -EAGAIN);
+	zassert_equal(7U, _transmission_count);
+
+	/* Back to transmitting regardless of the passes */
+	zassert_ok(hubble_sat_pass_window_set(NULL, NULL));
+	zassert_ok(k_sem_take(&_sent_sem, K_SECONDS(8 * 21)));
+	zassert_equal(0, _transmission_count);
+
+	zassert_ok(hubble_utc_set(_utc));
+#endif
+}
+
+#ifdef CONFIG_HUBBLE_SAT_NETWORK_PRIORITY
+static K_SEM_DEFINE(_done_sem, 0, 8);
+static int _done_status[8];
+static int _done_order[8];
+static int _done_count;
+
+static void _done_cb(int status, void *user_data)
+{
+	int id = POINTER_TO_INT(user_data);
+
+	_done_status[id] = status;
+	_done_order[_done_count++] = id;
+	k_sem_give(&_done_sem);
+}
+#endif
+
+ZTEST(sat_test, test_priority)
+{
+#ifndef CONFIG_HUBBLE_SAT_NETWORK_PRIORITY
+	zassert_equal(hubble_sat_packet_enqueue(NULL,
+						HUBBLE_SAT_RELIABILITY_NONE,
+						NULL, NULL, NULL),
+		      -ENOSYS);
+#else
+	static const int expected[] = {0, 3, 2, 1, 4};
+	struct hubble_sat_packet_options options = {0};
+	struct hubble_sat_packet pkt;
+	int err;
+
+	err = hubble_sat_packet_get(&pkt, NULL, 0);
+	zassert_ok(err);
+
+	/* Sanity check. Invalid packet and reliability */
+	err = hubble_sat_packet_enqueue(NULL, HUBBLE_SAT_RELIABILITY_NONE,
+					NULL, NULL, NULL);
+	zassert_equal(err, -EINVAL);
+	err = hubble_sat_packet_enqueue(&pkt, 255, NULL, NULL, NULL);
+	zassert_equal(err, -EINVAL);
+
+	/* Keep the transmit thread busy so the next packets wait */
+	_transmission_count =
+		(CONFIG_HUBBLE_SAT_NETWORK_ASYNC_QUEUE_SIZE * 8U) + 3U;
+	for (int i = 0; i < CONFIG_HUBBLE_SAT_NETWORK_ASYNC_QUEUE_SIZE; i++) {
+		zassert_ok(hubble_sat_packet_enqueue(
+			&pkt, HUBBLE_SAT_RELIABILITY_NORMAL, NULL, NULL, NULL));
+	}
+	k_sleep(K_MSEC(10));
+
+	/* 1 supersedes 0 */
+	options.priority = 1U;
+	options.key = 7U;
+	zassert_ok(hubble_sat_packet_enqueue(&pkt, HUBBLE_SAT_RELIABILITY_NONE,
+					     &options, _done_cb,
+					     INT_TO_POINTER(0)));
+	zassert_ok(hubble_sat_packet_enqueue(&pkt, HUBBLE_SAT_RELIABILITY_NONE,
+					     &options, _done_cb,
+					     INT_TO_POINTER(1)));
+
+	/* 2 goes first */
+	options.priority = 2U;
+	options.key = 0U;
+	zassert_ok(hubble_sat_packet_enqueue(&pkt, HUBBLE_SAT_RELIABILITY_NONE,
+					     &options, _done_cb,
+					     INT_TO_POINTER(2)));
+
+	/* 3 expires before the transmit thread gets to it */
+	options.priority = 0U;
+	options.lifetime_ms = MSEC_PER_SEC;
+	zassert_ok(hubble_sat_packet_enqueue(&pkt, HUBBLE_SAT_RELIABILITY_NONE,
+					     &options, _done_cb,
+					     INT_TO_POINTER(3)));
+
+	/* 4 goes last, same as packets sent without options */
+	zassert_ok(hubble_sat_packet_enqueue(&pkt, HUBBLE_SAT_RELIABILITY_NONE,
+					     NULL, _done_cb,
+					     INT_TO_POINTER(4)));
+
+	for (size_t i = 0; i < ARRAY_SIZE(expected); i++) {
+		zassert_ok(k_sem_take(&_done_sem, K_SECONDS(8 * 21)));
+		zassert_equal(_done_order[i], expected[i], "packet %zu", i);
+	}
+
+	zassert_equal(_done_status[0], -ECANCELED);
+	zassert_ok(_done_status[1]);
+	zassert_ok(_done_status[2]);
+	zassert_equal(_done_status[3], -ETIMEDOUT);
+	zassert_ok(_done_status[4]);
+
+	/* The packets keeping the thread busy are done shortly after */
+	k_sleep(K_SECONDS(21));
+	zassert_equal(0, _transmission_count);
+
+#ifdef CONFIG_HUBBLE_SAT_NETWORK_PASS_WINDOW
+	/* 6 supersedes 5, already held by the scheduler until the pass */
+	zassert_ok(hubble_utc_set(
+		(PASS_T_S - PASS_HALF_WIDTH_S - PASS_DELTA_S) * MSEC_PER_SEC));
+	zassert_ok(hubble_sat_pass_window_set(&_orbit, &_pos));
+
+	_done_count = 0;
+	_transmission_count = 1U;
+	options.lifetime_ms = 0U;
+	options.key = 7U;
+	zassert_ok(hubble_sat_packet_enqueue(&pkt, HUBBLE_SAT_RELIABILITY_NONE,
+					     &options, _done_cb,
+					     INT_TO_POINTER(5)));
+	k_sleep(K_MSEC(10));
+	zassert_ok(hubble_sat_packet_enqueue(&pkt, HUBBLE_SAT_RELIABILITY_NONE,
+					     &options, _done_cb,
+					     INT_TO_POINTER(6)));
+
+	zassert_ok(k_sem_take(&_done_sem, K_SECONDS(PASS_DELTA_S / 2)));
+	zassert_equal(_done_order[0], 5);
+	zassert_equal(_done_status[5], -ECANCELED);
+	zassert_equal(1U, _transmission_count);
+
+	zassert_ok(k_sem_take(&_done_sem, K_SECONDS(3 * PASS_DELTA_S)));
+	zassert_equal(_done_order[1], 6);
+	zassert_ok(_done_status[6]);
+	zassert_equal(0, _transmission_count);
+
+	zassert_ok(hubble_sat_pass_window_set(NULL, NULL));
+	zassert_ok(hubble_utc_set(_utc));
+#endif
+#endif
+}
+
 ZTEST(sat_test, test_channel_hopping)
 {
 	int ret;
@@ -11,6 +11,7 @@
 #include <utils/bitarray.h>
 
 #include <limits.h>
+#include <string.h>
 
 ZTEST(bitarray, test_overflow)
 {
@@ -77,4 +78,123 @@ ZTEST(bitarray, test_regular_usage)
 	zassert_equal(test, 0xf0fd);
 }
 
+/* Bit at a time reference of hubble_bitarray_append() */
+static void test_reference_append(struct hubble_bitarray *bit_array,
+				  const uint8_t *input, size_t input_len_bits)
+{
+	for (size_t i = input_len_bits; i > 0; i--) {
+		size_t index = bit_array->index++;
+		uint8_t bit = (input[(i - 1) / 8] >> ((i - 1) % 8)) & 1;
+
+		bit_array->data[index / 8] &= ~(1 << (index % 8));
+		bit_array->data[index / 8] |= bit << (index % 8);
+	}
+}
+
+ZTEST(bitarray, test_layout)
+{
+	struct hubble_bitarray bit_array;
+	struct hubble_bitarray expected;
+	uint32_t state = 1U;
+	uint8_t input[13];
+
+	for (int trial = 0; trial < 64; trial++) {
+		hubble_bitarray_init(&bit_array);
+		hubble_bitarray_init(&expected);
+		memset(bit_array.data, 0xa5, sizeof(bit_array.data));
+		memset(expected.data, 0xa5, sizeof(expected.data));
+
+		/* Fields of every length, at every offset */
+		for (;;) {
+			size_t len;
+
+			state = (state * 1103515245U) + 12345U;
+			len = (state >> 16) % ((sizeof(input) * 8) + 1);
+			if ((bit_array.index + len) >=
+			    (HUBBLE_MAX_SYMBOLS * 8)) {
+				break;
+			}
+
+			for (size_t i = 0; i < sizeof(input); i++) {
+				state = (state * 1103515245U) + 12345U;
+				input[i] = state >> 24;
+			}
+
+			zassert_ok(hubble_bitarray_append(&bit_array, input,
+							  len));
+			test_reference_append(&expected, input, len);
+			zassert_equal(bit_array.index, expected.index);
+		}
+
+		zassert_mem_equal(bit_array.data, expected.data,
+				  sizeof(bit_array.data));
+	}
+}
+
+ZTEST(bitarray, test_append_value)
+{
+	struct hubble_bitarray bit_array;
+	struct hubble_bitarray expected;
+	const uint32_t value = 0x89abcdefU;
+
+	hubble_bitarray_init(&bit_array);
+	hubble_bitarray_init(&expected);
+	memset(bit_array.data, 0, sizeof(bit_array.data));
+	memset(expected.data, 0, sizeof(expected.data));
+
+	for (size_t len = 0; len <= 32; len++) {
+		zassert_ok(
+			hubble_bitarray_append_value(&bit_array, value, len));
+		test_reference_append(&expected, (const uint8_t *)&value, len);
+	}
+
+	zassert_equal(bit_array.index, expected.index);
+	zassert_mem_equal(bit_array.data, expected.data,
+			  sizeof(bit_array.data));
+
+	zassert_equal(hubble_bitarray_append_value(&bit_array, value, 33),
+		      -EINVAL);
+}
+
+ZTEST(bitarray, test_symbols)
+{
+	struct hubble_bitarray bit_array;
+	uint8_t symbols[DIV_ROUND_UP(HUBBLE_MAX_SYMBOLS * 8, 6)];
+	uint32_t state = 2U;
+
+	for (size_t len = 0; len < (HUBBLE_MAX_SYMBOLS * 8); len++) {
+		hubble_bitarray_init(&bit_array);
+
+		/* Bits past the end must not end up in the last symbol */
+		memset(bit_array.data, 0xff, sizeof(bit_array.data));
+
+		for (size_t i = 0; i < len; i++) {
+			state = (state * 1103515245U) + 12345U;
+			zassert_ok(hubble_bitarray_append_value(
+				&bit_array, state >> 31, 1));
+		}
+
+		zassert_equal(hubble_bitarray_symbols_get(&bit_array, symbols,
+							  ARRAY_SIZE(symbols)),
+			      DIV_ROUND_UP(len, 6));
+
+		for (size_t i = 0; i < DIV_ROUND_UP(len, 6) * 6; i++) {
+			int bit = 0;
+
+			if (i < len) {
+				bit = hubble_bitarray_get_bit(&bit_array, i);
+			}
+
+			zassert_equal((symbols[i / 6] >> (5 - (i % 6))) & 1,
+				      bit, "%zu bits, bit %zu", len, i);
+		}
+	}
+
+	/* Does not fit */
+	zassert_equal(hubble_bitarray_symbols_get(&bit_array, symbols,
+						  DIV_ROUND_UP(bit_array.index,
+							       6) - 1),
+		      -EINVAL);
+}
+
 ZTEST_SUITE(bitarray, NULL, NULL, NULL, NULL, NULL);
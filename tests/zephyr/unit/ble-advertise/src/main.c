@@ -45,6 +45,11 @@ static const uint8_t test_key_primary[CONFIG_HUBBLE_KEY_SIZE] = {
 	0x44, 0xe9, 0x95, 0xba, 0x77, 0xd1, 0x40, 0xbd, 0x46, 0x56, 0x4b,
 	0x88, 0xde, 0x41, 0xc1, 0x5a, 0x92, 0x73, 0xb0, 0xce, 0x85};
 
+static const uint8_t test_key_secondary[CONFIG_HUBBLE_KEY_SIZE] = {
+	0x3a, 0x7f, 0x01, 0x9c, 0x55, 0xe2, 0x10, 0xb8, 0x6d, 0x44, 0xc7,
+	0x2e, 0x91, 0x08, 0xfa, 0x63, 0x0b, 0xd9, 0x7e, 0x25, 0xa4, 0x5c,
+	0xe0, 0x13, 0x88, 0x6f, 0x32, 0xcd, 0x99, 0x47, 0xb1, 0x0e};
+
 /*===========================================================================*/
 /* Test Suite: ble_advertise_test - Core Encryption Tests                   */
 /*===========================================================================*/
@@ -81,6 +86,46 @@ ZTEST(ble_advertise_test, test_advertise_with_test_vectors)
 	}
 }
 
+#ifdef CONFIG_HUBBLE_BLE_NETWORK_PRECOMPUTE
+ZTEST(ble_advertise_test, test_advertise_precomputed_test_vectors)
+{
+	for (size_t i = 0; i < test_vectors_count; i++) {
+		const struct ble_adv_test_vector *tv = &test_vectors[i];
+
+		uint64_t utc_time =
+			(uint64_t)tv->time_counter * TIMER_COUNTER_FREQUENCY;
+
+		int ret = hubble_init(utc_time, test_key_primary);
+		zassert_ok(ret, "hubble_init failed");
+		test_seq_override = tv->seq_no;
+
+		ret = hubble_ble_advertise_precompute(tv->seq_no, 1);
+		zassert_ok(ret, "Vector %zu (%s) pre-computation failed", i,
+			   tv->description);
+
+		uint8_t output[TEST_ADV_BUFFER_SZ];
+		size_t output_len = sizeof(output);
+
+		ret = hubble_ble_advertise_get(tv->payload, tv->payload_len,
+					       output, &output_len);
+		zassert_ok(ret, "Vector %zu (%s) failed with error %d", i,
+			   tv->description, ret);
+
+		zassert_equal(output_len, tv->expected_len,
+			      "Vector %zu (%s) length mismatch", i,
+			      tv->description);
+		zassert_mem_equal(output, tv->expected, output_len,
+				  "Vector %zu (%s) output mismatch", i,
+				  tv->description);
+	}
+
+	/* More sequence numbers than available slots */
+	int ret = hubble_ble_advertise_precompute(
+		0, CONFIG_HUBBLE_BLE_NETWORK_PRECOMPUTE_SLOTS + 1);
+	zassert_equal(ret, -EINVAL);
+}
+#endif /* CONFIG_HUBBLE_BLE_NETWORK_PRECOMPUTE */
+
 ZTEST(ble_advertise_test, test_advertise_null_input_handling)
 {
 	int ret = hubble_init(test_utc_time, test_key_primary);
@@ -251,6 +296,220 @@ ZTEST(ble_advertise_test, test_advertise_same_time_different_sequences)
 		     "Outputs should differ due to different sequence numbers");
 }
 
+ZTEST(ble_advertise_test, test_advertise_key_change)
+{
+	uint8_t payload[] = {0x48, 0x65, 0x6c, 0x6c, 0x6f};
+
+	int ret = hubble_init(test_utc_time, test_key_primary);
+	zassert_ok(ret, "hubble_init failed");
+	test_seq_override = 100;
+
+	uint8_t output1[TEST_ADV_BUFFER_SZ];
+	size_t output_len1 = sizeof(output1);
+
+	ret = hubble_ble_advertise_get(payload, sizeof(payload), output1,
+				       &output_len1);
+	zassert_ok(ret, "First call failed");
+
+	/* Keys derived from the previous key must not be re-used */
+	ret = hubble_key_set(test_key_secondary);
+	zassert_ok(ret, "hubble_key_set failed");
+
+	uint8_t output2[TEST_ADV_BUFFER_SZ];
+	size_t output_len2 = sizeof(output2);
+
+	ret = hubble_ble_advertise_get(payload, sizeof(payload), output2,
+				       &output_len2);
+	zassert_ok(ret, "Second call failed");
+
+	zassert_equal(output_len1, output_len2, "Output lengths should match");
+	zassert_true(memcmp(output1, output2, output_len1) != 0,
+		     "Outputs should differ due to key change");
+
+	/* Going back to the first key gives the first output again */
+	ret = hubble_key_set(test_key_primary);
+	zassert_ok(ret, "hubble_key_set failed");
+
+	output_len2 = sizeof(output2);
+	ret = hubble_ble_advertise_get(payload, sizeof(payload), output2,
+				       &output_len2);
+	zassert_ok(ret, "Third call failed");
+
+	zassert_equal(output_len1, output_len2, "Output lengths should match");
+	zassert_mem_equal(output1, output2, output_len1,
+			  "Outputs should be identical with the same key");
+}
+
+ZTEST(ble_advertise_test, test_advertise_utc_change)
+{
+	int ret = hubble_init(test_utc_time, test_key_primary);
+	zassert_ok(ret, "hubble_init failed");
+	test_seq_override = 0;
+
+	uint8_t output1[TEST_ADV_BUFFER_SZ];
+	size_t output_len1 = sizeof(output1);
+
+	ret = hubble_ble_advertise_get(NULL, 0, output1, &output_len1);
+	zassert_ok(ret, "First call failed");
+
+	/* Move to the next day, the device ID (EID) must change */
+	ret = hubble_utc_set(test_utc_time + TIMER_COUNTER_FREQUENCY);
+	zassert_ok(ret, "hubble_utc_set failed");
+	test_seq_override = 1;
+
+	uint8_t output2[TEST_ADV_BUFFER_SZ];
+	size_t output_len2 = sizeof(output2);
+
+	ret = hubble_ble_advertise_get(NULL, 0, output2, &output_len2);
+	zassert_ok(ret, "Second call failed");
+
+	/* Device ID is in bytes 4-7 (after UUID and version/seq_no) */
+	zassert_true(memcmp(&output1[4], &output2[4], sizeof(uint32_t)) != 0,
+		     "Device ID should differ after UTC change");
+
+	/* Back to the first day, the device ID must be the original one */
+	ret = hubble_utc_set(test_utc_time);
+	zassert_ok(ret, "hubble_utc_set failed");
+	test_seq_override = 2;
+
+	output_len2 = sizeof(output2);
+	ret = hubble_ble_advertise_get(NULL, 0, output2, &output_len2);
+	zassert_ok(ret, "Third call failed");
+
+	zassert_mem_equal(&output1[4], &output2[4], sizeof(uint32_t),
+			  "Device ID should match for the same day");
+}
+
+ZTEST(ble_advertise_test, test_advertise_batch_test_vectors)
+{
+	for (size_t i = 0; i < test_vectors_count; i++) {
+		const struct ble_adv_test_vector *tv = &test_vectors[i];
+
+		uint64_t utc_time =
+			(uint64_t)tv->time_counter * TIMER_COUNTER_FREQUENCY;
+
+		int ret = hubble_init(utc_time, test_key_primary);
+		zassert_ok(ret, "hubble_init failed");
+
+		uint8_t output[1][HUBBLE_BLE_ADV_FRAME_SIZE];
+		size_t output_len;
+
+		ret = hubble_ble_advertise_batch_get(tv->payload,
+						     tv->payload_len,
+						     tv->seq_no, 1, output,
+						     &output_len);
+
+		zassert_ok(ret, "Vector %zu (%s) failed with error %d", i,
+			   tv->description, ret);
+		zassert_equal(output_len, tv->expected_len,
+			      "Vector %zu (%s) length mismatch", i,
+			      tv->description);
+		zassert_mem_equal(output[0], tv->expected, output_len,
+				  "Vector %zu (%s) output mismatch", i,
+				  tv->description);
+	}
+}
+
+ZTEST(ble_advertise_test, test_advertise_batch_matches_single)
+{
+	const uint8_t payload[] = {0xDE, 0xAD, 0xBE, 0xEF};
+	/* Start close to the end so the batch wraps the sequence number */
+	const uint16_t first_seq = 1020;
+	uint8_t frames[8][HUBBLE_BLE_ADV_FRAME_SIZE];
+	size_t frames_len;
+
+	int ret = hubble_init(test_utc_time, test_key_primary);
+	zassert_ok(ret, "hubble_init failed");
+
+	ret = hubble_ble_advertise_batch_get(payload, sizeof(payload),
+					     first_seq, ARRAY_SIZE(frames),
+					     frames, &frames_len);
+	zassert_ok(ret, "Batch call failed");
+	zassert_equal(frames_len, 12 + sizeof(payload),
+		      "Unexpected advertisement length");
+
+	for (size_t i = 0; i < ARRAY_SIZE(frames); i++) {
+		uint8_t output[TEST_ADV_BUFFER_SZ];
+		size_t output_len = sizeof(output);
+
+		test_seq_override = (first_seq + i) % 1024;
+		ret = hubble_ble_advertise_get(payload, sizeof(payload), output,
+					       &output_len);
+		zassert_ok(ret, "Single call %zu failed", i);
+		zassert_equal(output_len, frames_len, "Length mismatch at %zu",
+			      i);
+		zassert_mem_equal(output, frames[i], output_len,
+				  "Frame %zu differs from single-shot output",
+				  i);
+	}
+}
+
+ZTEST(ble_advertise_test, test_advertise_batch_invalid_args)
+{
+	uint8_t payload[HUBBLE_BLE_MAX_DATA_LEN + 1] = {0};
+	uint8_t frames[2][HUBBLE_BLE_ADV_FRAME_SIZE];
+	size_t frames_len;
+
+	int ret = hubble_init(test_utc_time, test_key_primary);
+	zassert_ok(ret, "hubble_init failed");
+
+	ret = hubble_ble_advertise_batch_get(payload, 0, 0, 2, NULL,
+					     &frames_len);
+	zassert_equal(ret, -EINVAL, "Should fail with NULL output");
+
+	ret = hubble_ble_advertise_batch_get(payload, 0, 0, 2, frames, NULL);
+	zassert_equal(ret, -EINVAL, "Should fail with NULL output length");
+
+	ret = hubble_ble_advertise_batch_get(NULL, 4, 0, 2, frames,
+					     &frames_len);
+	zassert_equal(ret, -EINVAL, "Should fail with NULL input");
+
+	ret = hubble_ble_advertise_batch_get(payload, sizeof(payload), 0, 2,
+					     frames, &frames_len);
+	zassert_equal(ret, -EINVAL, "Should fail with oversized payload");
+
+	ret = hubble_ble_advertise_batch_get(payload, 0, 0, 0, frames,
+					     &frames_len);
+	zassert_equal(ret, -EINVAL, "Should fail with zero count");
+
+	ret = hubble_ble_advertise_batch_get(payload, 0, 1024, 2, frames,
+					     &frames_len);
+	zassert_equal(ret, -EINVAL, "Should fail with invalid sequence");
+}
+
+#ifdef CONFIG_HUBBLE_NETWORK_CRYPTO_CTR_CMAC
+ZTEST(ble_advertise_test, test_crypto_ctr_cmac_matches_separate)
+{
+	uint8_t data[40];
+
+	for (size_t i = 0; i < sizeof(data); i++) {
+		data[i] = (uint8_t)(i * 13U);
+	}
+
+	/* Cover empty, partial, complete and multi-block messages */
+	for (size_t len = 0; len <= sizeof(data); len++) {
+		uint8_t nonce1[HUBBLE_NONCE_BUFFER_SIZE] = {0x01, 0x02, 0x03};
+		uint8_t nonce2[HUBBLE_NONCE_BUFFER_SIZE] = {0x01, 0x02, 0x03};
+		uint8_t out1[sizeof(data)];
+		uint8_t out2[sizeof(data)];
+		uint8_t tag1[HUBBLE_AES_BLOCK_SIZE];
+		uint8_t tag2[HUBBLE_AES_BLOCK_SIZE];
+
+		zassert_ok(hubble_crypto_aes_ctr(test_key_primary, nonce1, data,
+						 len, out1));
+		zassert_ok(hubble_crypto_cmac(test_key_primary, out1, len,
+					      tag1));
+		zassert_ok(hubble_crypto_ctr_cmac(test_key_primary, nonce2,
+						  data, len, out2, tag2));
+
+		zassert_mem_equal(out1, out2, len,
+				  "Ciphertext mismatch for length %zu", len);
+		zassert_mem_equal(tag1, tag2, sizeof(tag1),
+				  "Tag mismatch for length %zu", len);
+	}
+}
+#endif /* CONFIG_HUBBLE_NETWORK_CRYPTO_CTR_CMAC */
+
 static void *ble_advertise_test_setup(void)
 {
 	test_seq_override = 0;
@@ -360,3 +619,277 @@ static void *ble_advertise_format_test_setup(void)
 
 ZTEST_SUITE(ble_advertise_format_test, NULL, ble_advertise_format_test_setup,
 	    NULL, NULL, NULL);
+
+#ifdef CONFIG_HUBBLE_BLE_NETWORK_DECODER
+/*===========================================================================*/
+/* Test Suite: ble_decode_test - Receiver Side Decoding                     */
+/*===========================================================================*/
+
+static struct hubble_ble_decoder test_decoder;
+
+static const struct ble_adv_test_vector *test_vector_with_payload(void)
+{
+	for (size_t i = 0; i < test_vectors_count; i++) {
+		if (test_vectors[i].payload_len > 0) {
+			return &test_vectors[i];
+		}
+	}
+
+	return NULL;
+}
+
+ZTEST(ble_decode_test, test_decode_test_vectors)
+{
+	for (int pass = 0; pass < 2; pass++) {
+		for (size_t i = 0; i < test_vectors_count; i++) {
+			const struct ble_adv_test_vector *tv = &test_vectors[i];
+			uint8_t data[HUBBLE_BLE_MAX_DATA_LEN];
+			size_t data_len = 0;
+			int ret;
+
+			/* Second pass is served by the decoder memo */
+			ret = hubble_ble_decode(&test_decoder, test_key_primary,
+						tv->time_counter, tv->expected,
+						tv->expected_len, data,
+						&data_len);
+			zassert_ok(ret, "Vector %zu (%s) failed with error %d",
+				   i, tv->description, ret);
+			zassert_equal(data_len, tv->payload_len,
+				      "Vector %zu (%s) length mismatch", i,
+				      tv->description);
+			zassert_mem_equal(data, tv->payload, data_len,
+					  "Vector %zu (%s) payload mismatch",
+					  i, tv->description);
+		}
+	}
+}
+
+ZTEST(ble_decode_test, test_decode_frame_fields)
+{
+	const struct ble_adv_test_vector *tv = &test_vectors[0];
+	struct hubble_ble_frame frame;
+	uint32_t device_id;
+
+	zassert_ok(hubble_ble_frame_parse(tv->expected, tv->expected_len,
+					  &frame));
+	zassert_equal(frame.version, 0);
+	zassert_equal(frame.seq_no, tv->seq_no);
+	zassert_equal(frame.data_len, tv->payload_len);
+	zassert_equal(frame.auth_tag, tv->expected + 8);
+	zassert_equal(frame.data, tv->expected + 12);
+
+	memcpy(&device_id, tv->expected + 4, sizeof(device_id));
+	zassert_equal(frame.eid, device_id);
+}
+
+ZTEST(ble_decode_test, test_decode_rejects_forgeries)
+{
+	const struct ble_adv_test_vector *tv = test_vector_with_payload();
+	uint8_t adv[TEST_ADV_BUFFER_SZ];
+	uint8_t data[HUBBLE_BLE_MAX_DATA_LEN];
+	size_t data_len;
+
+	zassert_not_null(tv, "No test vector with payload");
+	memcpy(adv, tv->expected, tv->expected_len);
+
+	/* Wrong key or day */
+	zassert_equal(hubble_ble_decode(&test_decoder, test_key_secondary,
+					tv->time_counter, adv,
+					tv->expected_len, data, &data_len),
+		      -EBADMSG);
+	zassert_equal(hubble_ble_decode(&test_decoder, test_key_primary,
+					tv->time_counter + 1, adv,
+					tv->expected_len, data, &data_len),
+		      -EBADMSG);
+
+	/* Genuine one, remembered by the decoder */
+	zassert_ok(hubble_ble_decode(&test_decoder, test_key_primary,
+				     tv->time_counter, adv, tv->expected_len,
+				     data, &data_len));
+
+	/* Modified payload, tag, and device ID */
+	adv[12] ^= 0x01;
+	zassert_equal(hubble_ble_decode(&test_decoder, test_key_primary,
+					tv->time_counter, adv,
+					tv->expected_len, data, &data_len),
+		      -EBADMSG);
+	adv[12] ^= 0x01;
+
+	adv[8] ^= 0x80;
+	zassert_equal(hubble_ble_decode(&test_decoder, test_key_primary,
+					tv->time_counter, adv,
+					tv->expected_len, data, &data_len),
+		      -EBADMSG);
+	adv[8] ^= 0x80;
+
+	adv[4] ^= 0x01;
+	zassert_equal(hubble_ble_decode(&test_decoder, test_key_primary,
+					tv->time_counter, adv,
+					tv->expected_len, data, &data_len),
+		      -EBADMSG);
+	adv[4] ^= 0x01;
+
+	/* Truncated */
+	zassert_equal(hubble_ble_decode(&test_decoder, test_key_primary,
+					tv->time_counter, adv,
+					tv->expected_len - 1, data, &data_len),
+		      -EBADMSG);
+
+	zassert_ok(hubble_ble_decode(&test_decoder, test_key_primary,
+				     tv->time_counter, adv, tv->expected_len,
+				     data, &data_len));
+	zassert_mem_equal(data, tv->payload, tv->payload_len);
+}
+
+ZTEST(ble_decode_test, test_decode_invalid_frames)
+{
+	const struct ble_adv_test_vector *tv = &test_vectors[0];
+	uint8_t adv[TEST_ADV_BUFFER_SZ];
+	uint8_t data[HUBBLE_BLE_MAX_DATA_LEN];
+	size_t data_len;
+
+	memcpy(adv, tv->expected, tv->expected_len);
+
+	/* Too short, too long */
+	zassert_equal(hubble_ble_decode(&test_decoder, test_key_primary,
+					tv->time_counter, adv, 11, data,
+					&data_len),
+		      -EINVAL);
+	zassert_equal(hubble_ble_decode(&test_decoder, test_key_primary,
+					tv->time_counter, adv,
+					12 + HUBBLE_BLE_MAX_DATA_LEN + 1, data,
+					&data_len),
+		      -EINVAL);
+
+	/* Other service UUID */
+	adv[0] ^= 0xFF;
+	zassert_equal(hubble_ble_decode(&test_decoder, test_key_primary,
+					tv->time_counter, adv,
+					tv->expected_len, data, &data_len),
+		      -EINVAL);
+	adv[0] ^= 0xFF;
+
+	/* Unknown protocol version */
+	adv[2] |= 0x04;
+	zassert_equal(hubble_ble_decode(&test_decoder, test_key_primary,
+					tv->time_counter, adv,
+					tv->expected_len, data, &data_len),
+		      -ENOTSUP);
+
+	zassert_equal(hubble_ble_decode(&test_decoder, NULL, tv->time_counter,
+					tv->expected, tv->expected_len, data,
+					&data_len),
+		      -EINVAL);
+}
+
+ZTEST(ble_decode_test, test_decode_batch)
+{
+	struct hubble_ble_decode_job jobs[8];
+	size_t count = MIN(test_vectors_count, ARRAY_SIZE(jobs) / 2);
+
+	/* Every advertisement twice, plus one with the wrong key */
+	for (size_t i = 0; i < ARRAY_SIZE(jobs); i++) {
+		const struct ble_adv_test_vector *tv = &test_vectors[i % count];
+
+		jobs[i].key = test_key_primary;
+		jobs[i].time_counter = tv->time_counter;
+		jobs[i].adv = tv->expected;
+		jobs[i].adv_len = tv->expected_len;
+	}
+	jobs[ARRAY_SIZE(jobs) - 1].key = test_key_secondary;
+
+	zassert_equal(hubble_ble_decode_batch(&test_decoder, jobs,
+					      ARRAY_SIZE(jobs)),
+		      ARRAY_SIZE(jobs) - 1);
+
+	for (size_t i = 0; i < ARRAY_SIZE(jobs) - 1; i++) {
+		const struct ble_adv_test_vector *tv = &test_vectors[i % count];
+
+		zassert_ok(jobs[i].err, "Job %zu failed", i);
+		zassert_equal(jobs[i].data_len, tv->payload_len);
+		zassert_mem_equal(jobs[i].data, tv->payload, tv->payload_len);
+	}
+	zassert_equal(jobs[ARRAY_SIZE(jobs) - 1].err, -EBADMSG);
+}
+
+ZTEST(ble_decode_test, test_decode_batch_matches_decode)
+{
+	static struct hubble_ble_decode_job jobs[40];
+	static uint8_t tampered[TEST_ADV_BUFFER_SZ];
+	struct hubble_ble_decoder decoder;
+	uint8_t data[HUBBLE_BLE_MAX_DATA_LEN];
+	size_t data_len;
+	int errs[ARRAY_SIZE(jobs)];
+	size_t expected = 0U;
+
+	memcpy(tampered, test_vectors[1].expected,
+	       test_vectors[1].expected_len);
+	tampered[test_vectors[1].expected_len - 1] ^= 0x01;
+
+	/* More jobs than a batch handles at once, several days and
+	 * sequence numbers, repeated and failing advertisements mixed
+	 */
+	for (size_t i = 0; i < ARRAY_SIZE(jobs); i++) {
+		const struct ble_adv_test_vector *tv =
+			&test_vectors[(i * 7U) % test_vectors_count];
+
+		jobs[i].key = (i % 9U == 8U) ? test_key_secondary
+					     : test_key_primary;
+		jobs[i].time_counter = tv->time_counter;
+		jobs[i].adv = tv->expected;
+		jobs[i].adv_len = tv->expected_len;
+
+		if (i % 11U == 5U) {
+			jobs[i].time_counter = test_vectors[1].time_counter;
+			jobs[i].adv = tampered;
+			jobs[i].adv_len = test_vectors[1].expected_len;
+		}
+	}
+
+	/* Reference: one advertisement at a time */
+	hubble_ble_decoder_init(&decoder);
+	for (size_t i = 0; i < ARRAY_SIZE(jobs); i++) {
+		errs[i] = hubble_ble_decode(&decoder, jobs[i].key,
+					    jobs[i].time_counter, jobs[i].adv,
+					    jobs[i].adv_len, data, &data_len);
+		if (errs[i] == 0) {
+			expected++;
+		}
+	}
+	hubble_ble_decoder_clear(&decoder);
+	zassert_true((expected > 0U) && (expected < ARRAY_SIZE(jobs)));
+
+	zassert_equal(hubble_ble_decode_batch(&test_decoder, jobs,
+					      ARRAY_SIZE(jobs)),
+		      expected);
+
+	for (size_t i = 0; i < ARRAY_SIZE(jobs); i++) {
+		const struct ble_adv_test_vector *tv =
+			&test_vectors[(i * 7U) % test_vectors_count];
+
+		zassert_equal(jobs[i].err, errs[i], "Job %zu", i);
+		if ((errs[i] == 0) && (jobs[i].adv != tampered)) {
+			zassert_equal(jobs[i].data_len, tv->payload_len);
+			zassert_mem_equal(jobs[i].data, tv->payload,
+					  tv->payload_len);
+		}
+	}
+}
+
+static void ble_decode_test_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	hubble_ble_decoder_init(&test_decoder);
+}
+
+static void ble_decode_test_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	hubble_ble_decoder_clear(&test_decoder);
+}
+
+ZTEST_SUITE(ble_decode_test, NULL, NULL, ble_decode_test_before,
+	    ble_decode_test_after, NULL);
+#endif /* CONFIG_HUBBLE_BLE_NETWORK_DECODER */
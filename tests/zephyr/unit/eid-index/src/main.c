@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2026 Hubble Network, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <hubble/hubble.h>
+#include <hubble/ble.h>
+#include <hubble/eid_index.h>
+
+#include <zephyr/sys/util.h>
+#include <zephyr/types.h>
+#include <zephyr/ztest.h>
+
+#include <errno.h>
+#include <string.h>
+
+#define TIMER_COUNTER_FREQUENCY 86400000ULL
+
+#define TEST_KEY_COUNT    8U
+#define TEST_WINDOW       3U
+#define TEST_TIME_COUNTER 20U
+
+/* Offsets in the advertisement */
+#define ADV_SEQ_NO   2U
+#define ADV_EID      4U
+#define ADV_AUTH_TAG 8U
+#define ADV_DATA     12U
+#define ADV_TAG_SIZE 4U
+
+static uint16_t test_seq_override;
+static uint64_t test_uptime_ms;
+
+static uint8_t test_keys[TEST_KEY_COUNT][CONFIG_HUBBLE_KEY_SIZE];
+
+static uint32_t test_index_buffer[512];
+static struct hubble_eid_index *test_index =
+	(struct hubble_eid_index *)test_index_buffer;
+
+uint16_t hubble_sequence_counter_get(void)
+{
+	return test_seq_override;
+}
+
+uint64_t hubble_uptime_get(void)
+{
+	return test_uptime_ms;
+}
+
+struct test_adv {
+	uint8_t data[HUBBLE_BLE_ADV_FRAME_SIZE];
+	size_t len;
+	uint32_t eid;
+	uint16_t seq_no;
+};
+
+static const uint8_t test_payload[] = {0xde, 0xad, 0xbe, 0xef};
+
+/* Builds an advertisement the way a device owning the key would */
+static void test_adv_get(size_t key_index, uint32_t time_counter,
+			 uint16_t seq_no, struct test_adv *adv)
+{
+	zassert_ok(hubble_init(time_counter * TIMER_COUNTER_FREQUENCY,
+			       test_keys[key_index]));
+	test_seq_override = seq_no;
+
+	adv->len = sizeof(adv->data);
+	zassert_ok(hubble_ble_advertise_get(test_payload, sizeof(test_payload),
+					    adv->data, &adv->len));
+
+	memcpy(&adv->eid, &adv->data[ADV_EID], sizeof(adv->eid));
+	adv->seq_no = ((adv->data[ADV_SEQ_NO] & 0x03) << 8) |
+		      adv->data[ADV_SEQ_NO + 1];
+}
+
+static bool test_index_has(uint32_t eid, size_t key_index,
+			   uint32_t time_counter)
+{
+	struct hubble_eid_index_entry matches[4];
+	size_t count = hubble_eid_index_lookup(test_index, eid, matches,
+					       ARRAY_SIZE(matches));
+
+	for (size_t i = 0; i < MIN(count, ARRAY_SIZE(matches)); i++) {
+		if ((matches[i].key_index == key_index) &&
+		    (matches[i].time_counter == time_counter)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void *eid_index_setup(void)
+{
+	for (size_t k = 0; k < TEST_KEY_COUNT; k++) {
+		for (size_t i = 0; i < CONFIG_HUBBLE_KEY_SIZE; i++) {
+			test_keys[k][i] = (uint8_t)((k * 37U) + (i * 11U) + 1U);
+		}
+	}
+
+	return NULL;
+}
+
+static void eid_index_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	zassert_ok(hubble_eid_index_init(test_index, sizeof(test_index_buffer),
+					 TEST_KEY_COUNT, TEST_WINDOW));
+}
+
+ZTEST(eid_index_test, test_invalid_args)
+{
+	size_t size = hubble_eid_index_size(TEST_KEY_COUNT, TEST_WINDOW);
+
+	zassert_true(size > 0U);
+	zassert_true(size <= sizeof(test_index_buffer));
+
+	zassert_equal(hubble_eid_index_size(0U, TEST_WINDOW), 0U);
+	zassert_equal(hubble_eid_index_size(TEST_KEY_COUNT, 0U), 0U);
+	zassert_equal(hubble_eid_index_size(HUBBLE_EID_INDEX_KEY_NONE, 1U),
+		      0U);
+
+	zassert_equal(hubble_eid_index_init(test_index, size - 1U,
+					    TEST_KEY_COUNT, TEST_WINDOW),
+		      -EINVAL);
+	zassert_equal(hubble_eid_index_update(test_index, NULL, 0U), -EINVAL);
+
+	zassert_ok(hubble_eid_index_init(test_index, size, TEST_KEY_COUNT,
+					 TEST_WINDOW));
+	zassert_ok(hubble_eid_index_check(test_index, size));
+	zassert_equal(hubble_eid_index_check(test_index, size + 4U), -EINVAL);
+
+	test_index->magic = 0U;
+	zassert_equal(hubble_eid_index_check(test_index, size), -EINVAL);
+}
+
+ZTEST(eid_index_test, test_lookup_matches_advertisements)
+{
+	struct test_adv adv;
+
+	zassert_ok(hubble_eid_index_update(test_index, test_keys,
+					   TEST_TIME_COUNTER));
+	zassert_equal(test_index->entry_count, TEST_KEY_COUNT * TEST_WINDOW);
+
+	for (size_t k = 0; k < TEST_KEY_COUNT; k++) {
+		for (uint32_t d = 0; d < TEST_WINDOW; d++) {
+			test_adv_get(k, TEST_TIME_COUNTER + d, 0, &adv);
+			zassert_true(test_index_has(adv.eid, k,
+						    TEST_TIME_COUNTER + d),
+				     "key %zu day %u not found", k, d);
+		}
+	}
+
+	/* Outside of the window */
+	test_adv_get(0, TEST_TIME_COUNTER + TEST_WINDOW, 0, &adv);
+	zassert_false(test_index_has(adv.eid, 0,
+				     TEST_TIME_COUNTER + TEST_WINDOW));
+}
+
+ZTEST(eid_index_test, test_update_slides_window)
+{
+	struct test_adv first;
+	struct test_adv last;
+	size_t size = hubble_eid_index_size(TEST_KEY_COUNT, TEST_WINDOW);
+
+	test_adv_get(3, TEST_TIME_COUNTER, 0, &first);
+	test_adv_get(3, TEST_TIME_COUNTER + TEST_WINDOW, 0, &last);
+
+	zassert_ok(hubble_eid_index_update(test_index, test_keys,
+					   TEST_TIME_COUNTER));
+	zassert_true(test_index_has(first.eid, 3, TEST_TIME_COUNTER));
+	zassert_false(test_index_has(last.eid, 3,
+				     TEST_TIME_COUNTER + TEST_WINDOW));
+
+	/* One day later */
+	zassert_ok(hubble_eid_index_update(test_index, test_keys,
+					   TEST_TIME_COUNTER + 1U));
+	zassert_false(test_index_has(first.eid, 3, TEST_TIME_COUNTER));
+	zassert_true(test_index_has(last.eid, 3,
+				    TEST_TIME_COUNTER + TEST_WINDOW));
+	zassert_equal(test_index->entry_count, TEST_KEY_COUNT * TEST_WINDOW);
+	zassert_ok(hubble_eid_index_check(test_index, size));
+
+	/* Back in time, without overlap */
+	zassert_ok(hubble_eid_index_update(test_index, test_keys,
+					   TEST_TIME_COUNTER - TEST_WINDOW));
+	zassert_false(test_index_has(last.eid, 3,
+				     TEST_TIME_COUNTER + TEST_WINDOW));
+	zassert_equal(test_index->time_counter,
+		      TEST_TIME_COUNTER - TEST_WINDOW);
+	zassert_equal(test_index->entry_count, TEST_KEY_COUNT * TEST_WINDOW);
+}
+
+ZTEST(eid_index_test, test_resolve)
+{
+	struct test_adv adv;
+	struct hubble_eid_index_entry match;
+
+	zassert_ok(hubble_eid_index_update(test_index, test_keys,
+					   TEST_TIME_COUNTER));
+
+	for (size_t k = 0; k < TEST_KEY_COUNT; k++) {
+		test_adv_get(k, TEST_TIME_COUNTER + 1U, 100U + k, &adv);
+
+		zassert_ok(hubble_eid_index_resolve(
+			test_index, test_keys, adv.eid, adv.seq_no,
+			&adv.data[ADV_DATA], adv.len - ADV_DATA,
+			&adv.data[ADV_AUTH_TAG], ADV_TAG_SIZE, &match));
+		zassert_equal(match.key_index, k);
+		zassert_equal(match.time_counter, TEST_TIME_COUNTER + 1U);
+
+		/* Wrong sequence number */
+		zassert_equal(hubble_eid_index_resolve(
+				      test_index, test_keys, adv.eid,
+				      adv.seq_no + 1U, &adv.data[ADV_DATA],
+				      adv.len - ADV_DATA,
+				      &adv.data[ADV_AUTH_TAG], ADV_TAG_SIZE,
+				      &match),
+			      -ENOENT);
+
+		/* Tampered payload */
+		adv.data[ADV_DATA] ^= 0x01;
+		zassert_equal(hubble_eid_index_resolve(
+				      test_index, test_keys, adv.eid,
+				      adv.seq_no, &adv.data[ADV_DATA],
+				      adv.len - ADV_DATA,
+				      &adv.data[ADV_AUTH_TAG], ADV_TAG_SIZE,
+				      &match),
+			      -ENOENT);
+	}
+}
+
+ZTEST(eid_index_test, test_resolve_sat)
+{
+	struct test_adv adv;
+	struct hubble_eid_index_entry match;
+	uint8_t payload[sizeof(test_payload)];
+
+	zassert_ok(hubble_eid_index_update(test_index, test_keys,
+					   TEST_TIME_COUNTER));
+
+	/* Same tag as a satellite packet carrying the payload in clear */
+	test_adv_get(5, TEST_TIME_COUNTER + 2U, 7U, &adv);
+	memcpy(payload, test_payload, sizeof(payload));
+
+	zassert_ok(hubble_eid_index_resolve_sat(
+		test_index, test_keys, adv.eid, adv.seq_no, payload,
+		sizeof(payload), &adv.data[ADV_AUTH_TAG], ADV_TAG_SIZE,
+		&match));
+	zassert_equal(match.key_index, 5U);
+	zassert_equal(match.time_counter, TEST_TIME_COUNTER + 2U);
+
+	/* The encrypted payload is not what a satellite packet carries */
+	zassert_equal(hubble_eid_index_resolve_sat(
+			      test_index, test_keys, adv.eid, adv.seq_no,
+			      &adv.data[ADV_DATA], adv.len - ADV_DATA,
+			      &adv.data[ADV_AUTH_TAG], ADV_TAG_SIZE, &match),
+		      -ENOENT);
+
+	payload[0] ^= 0x01;
+	zassert_equal(hubble_eid_index_resolve_sat(
+			      test_index, test_keys, adv.eid, adv.seq_no,
+			      payload, sizeof(payload),
+			      &adv.data[ADV_AUTH_TAG], ADV_TAG_SIZE, &match),
+		      -ENOENT);
+}
+
+ZTEST(eid_index_test, test_check_slots)
+{
+	size_t size = hubble_eid_index_size(TEST_KEY_COUNT, TEST_WINDOW);
+	struct hubble_eid_index_entry *slot = NULL;
+
+	zassert_ok(hubble_eid_index_update(test_index, test_keys,
+					   TEST_TIME_COUNTER));
+	zassert_ok(hubble_eid_index_check(test_index, size));
+
+	for (size_t i = 0; slot == NULL; i++) {
+		if (test_index->slots[i].key_index !=
+		    HUBBLE_EID_INDEX_KEY_NONE) {
+			slot = &test_index->slots[i];
+		}
+	}
+
+	/* Key out of the key array */
+	slot->key_index = TEST_KEY_COUNT;
+	zassert_equal(hubble_eid_index_check(test_index, size), -EINVAL);
+	slot->key_index = 0U;
+	zassert_ok(hubble_eid_index_check(test_index, size));
+
+	/* Time counter out of the window */
+	slot->time_counter = TEST_TIME_COUNTER + TEST_WINDOW;
+	zassert_equal(hubble_eid_index_check(test_index, size), -EINVAL);
+	slot->time_counter = TEST_TIME_COUNTER;
+
+	/* More slots used than entries, e.g. no free slot left */
+	for (uint64_t i = 0; i < (1ULL << test_index->slot_bits); i++) {
+		if (test_index->slots[i].key_index ==
+		    HUBBLE_EID_INDEX_KEY_NONE) {
+			test_index->slots[i] = *slot;
+			break;
+		}
+	}
+	zassert_equal(hubble_eid_index_check(test_index, size), -EINVAL);
+}
+
+ZTEST_SUITE(eid_index_test, NULL, eid_index_setup, eid_index_before, NULL,
+	    NULL);
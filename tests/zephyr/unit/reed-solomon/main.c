@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2026 Hubble Network, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Test the Reed-Solomon encoder, and the decoder against it */
+
+#include <zephyr/ztest.h>
+
+#include <reed_solomon_decoder.h>
+#include <reed_solomon_encoder.h>
+
+#include <errno.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define NN 63
+
+/* Trials per code and error pattern */
+#define TEST_TRIALS 64
+
+/* Codes used by the satellite packets: PHY header and payloads */
+static const struct {
+	int kk;
+	int tt;
+} test_codes[] = {
+	{2, 2}, {13, 5}, {18, 6}, {25, 7}, {30, 8},
+};
+
+static uint32_t test_prng_state;
+
+static uint32_t test_prng(void)
+{
+	test_prng_state = (test_prng_state * 1103515245U) + 12345U;
+
+	return test_prng_state >> 8;
+}
+
+static void test_codeword_get(int kk, int tt, uint8_t *codeword)
+{
+	for (int i = 0; i < kk; i++) {
+		codeword[i] = test_prng() % (NN + 1);
+	}
+
+	zassert_ok(rse_rs_encode(codeword, kk, tt, &codeword[kk]));
+}
+
+/*
+ * Changes @p errors symbols and overwrites @p erasure_count other ones
+ * with random values, returns the erased positions in @p erasures.
+ */
+static void test_corrupt(uint8_t *codeword, int n, int errors,
+			 int erasure_count, int *erasures)
+{
+	bool used[NN] = {false};
+
+	for (int i = 0; i < errors + erasure_count; i++) {
+		int pos;
+
+		do {
+			pos = test_prng() % n;
+		} while (used[pos]);
+		used[pos] = true;
+
+		if (i < errors) {
+			codeword[pos] ^= 1 + (test_prng() % NN);
+		} else {
+			codeword[pos] = test_prng() % (NN + 1);
+			erasures[i - errors] = pos;
+		}
+	}
+}
+
+static bool test_is_codeword(const uint8_t *codeword, int kk, int tt)
+{
+	uint8_t expected[NN];
+
+	memcpy(expected, codeword, kk);
+	if (rse_rs_encode(expected, kk, tt, &expected[kk]) != 0) {
+		return false;
+	}
+
+	return memcmp(expected, codeword, kk + (2 * tt)) == 0;
+}
+
+/* Parity symbols computed when the generators were built at run time */
+ZTEST(reed_solomon, test_encode_vectors)
+{
+	static const struct {
+		int kk;
+		int tt;
+		uint8_t parity[2 * RSE_TT_MAX];
+	} vectors[] = {
+		{2, 2, {9, 36, 34, 22}},
+		{13, 5, {18, 31, 52, 27, 39, 29, 18, 28, 0, 23}},
+		{30, 8, {62, 32, 58, 54, 23, 29, 24, 32, 8, 33, 2, 52, 8, 24, 2,
+			 62}},
+	};
+	uint8_t data[NN];
+	uint8_t parity[2 * RSE_TT_MAX];
+
+	for (int i = 0; i < NN; i++) {
+		data[i] = ((i * 23) + 7) % (NN + 1);
+	}
+
+	for (size_t v = 0; v < ARRAY_SIZE(vectors); v++) {
+		zassert_ok(rse_rs_encode(data, vectors[v].kk, vectors[v].tt,
+					 parity));
+		zassert_mem_equal(parity, vectors[v].parity, 2 * vectors[v].tt);
+	}
+}
+
+ZTEST(reed_solomon, test_encode_invalid)
+{
+	uint8_t data[NN] = {0};
+	uint8_t parity[2 * RSE_TT_MAX];
+
+	zassert_equal(rse_rs_encode(NULL, 30, 8, parity), -EINVAL);
+	zassert_equal(rse_rs_encode(data, 30, 8, NULL), -EINVAL);
+	zassert_equal(rse_rs_encode(data, 0, 8, parity), -EINVAL);
+	zassert_equal(rse_rs_encode(data, NN - 15, 8, parity), -EINVAL);
+
+	/* No generator for these */
+	zassert_equal(rse_rs_encode(data, 30, 3, parity), -EINVAL);
+	zassert_equal(rse_rs_encode(data, 30, RSE_TT_MAX + 1, parity),
+		      -EINVAL);
+
+	/* Not a 6 bits symbol */
+	data[3] = NN + 1;
+	zassert_equal(rse_rs_encode(data, 30, 8, parity), -EINVAL);
+}
+
+ZTEST(reed_solomon, test_no_errors)
+{
+	uint8_t codeword[NN];
+	uint8_t received[NN];
+
+	test_prng_state = 1U;
+
+	for (size_t c = 0; c < ARRAY_SIZE(test_codes); c++) {
+		int kk = test_codes[c].kk;
+		int tt = test_codes[c].tt;
+		int n = kk + 2 * tt;
+
+		test_codeword_get(kk, tt, codeword);
+		memcpy(received, codeword, n);
+
+		zassert_equal(rsd_rs_decode(received, kk, tt, NULL, 0), 0);
+		zassert_mem_equal(received, codeword, n);
+	}
+}
+
+ZTEST(reed_solomon, test_errors_and_erasures)
+{
+	uint8_t codeword[NN];
+	uint8_t received[NN];
+	int erasures[NN];
+
+	test_prng_state = 2U;
+
+	for (size_t c = 0; c < ARRAY_SIZE(test_codes); c++) {
+		int kk = test_codes[c].kk;
+		int tt = test_codes[c].tt;
+		int n = kk + 2 * tt;
+
+		/* Every split of the parity symbols in errors and erasures */
+		for (int errors = 0; errors <= tt; errors++) {
+			int erasure_count = 2 * (tt - errors);
+
+			for (int trial = 0; trial < TEST_TRIALS; trial++) {
+				int ret;
+
+				test_codeword_get(kk, tt, codeword);
+				memcpy(received, codeword, n);
+				test_corrupt(received, n, errors,
+					     erasure_count, erasures);
+
+				ret = rsd_rs_decode(received, kk, tt, erasures,
+						    erasure_count);
+				zassert_true(ret >= errors,
+					     "RS(%d, %d): %d errors, %d "
+					     "erasures, returned %d",
+					     n, kk, errors, erasure_count, ret);
+				zassert_true(ret <= errors + erasure_count);
+				zassert_mem_equal(received, codeword,
+						  n);
+			}
+		}
+	}
+}
+
+ZTEST(reed_solomon, test_too_many_errors)
+{
+	uint8_t codeword[NN];
+	uint8_t received[NN];
+
+	test_prng_state = 3U;
+
+	for (size_t c = 0; c < ARRAY_SIZE(test_codes); c++) {
+		int kk = test_codes[c].kk;
+		int tt = test_codes[c].tt;
+		int n = kk + 2 * tt;
+
+		for (int trial = 0; trial < TEST_TRIALS; trial++) {
+			int ret;
+
+			test_codeword_get(kk, tt, codeword);
+			memcpy(received, codeword, n);
+			test_corrupt(received, n, tt + 1, 0, NULL);
+
+			/* Either detected, or decoded to another codeword */
+			ret = rsd_rs_decode(received, kk, tt, NULL, 0);
+			if (ret >= 0) {
+				zassert_true(
+					test_is_codeword(received, kk, tt));
+				zassert_true(memcmp(received, codeword,
+						    n) != 0);
+			} else {
+				zassert_equal(ret, -EBADMSG);
+			}
+		}
+	}
+}
+
+ZTEST(reed_solomon, test_invalid)
+{
+	uint8_t codeword[NN];
+	int erasures[2 * RSD_TT_MAX + 1];
+
+	test_prng_state = 4U;
+	test_codeword_get(30, 8, codeword);
+
+	zassert_equal(rsd_rs_decode(NULL, 30, 8, NULL, 0), -EINVAL);
+	zassert_equal(rsd_rs_decode(codeword, 0, 8, NULL, 0), -EINVAL);
+	zassert_equal(rsd_rs_decode(codeword, 30, 0, NULL, 0), -EINVAL);
+	zassert_equal(rsd_rs_decode(codeword, 30, RSD_TT_MAX + 1, NULL, 0),
+		      -EINVAL);
+	zassert_equal(rsd_rs_decode(codeword, NN - 15, 8, NULL, 0), -EINVAL);
+	zassert_equal(rsd_rs_decode(codeword, 30, 8, NULL, 1), -EINVAL);
+
+	erasures[0] = 30 + (2 * 8);
+	zassert_equal(rsd_rs_decode(codeword, 30, 8, erasures, 1), -EINVAL);
+
+	/* More erasures than parity symbols */
+	for (int i = 0; i < ARRAY_SIZE(erasures); i++) {
+		erasures[i] = i;
+	}
+	zassert_equal(rsd_rs_decode(codeword, 30, 8, erasures,
+				    ARRAY_SIZE(erasures)),
+		      -EBADMSG);
+
+	/* Not a 6 bits symbol */
+	codeword[3] = NN + 1;
+	zassert_equal(rsd_rs_decode(codeword, 30, 8, NULL, 0), -EINVAL);
+}
+
+ZTEST_SUITE(reed_solomon, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2026 Hubble Network, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Check the generated satellite packet tables against the encoders */
+
+#include <zephyr/ztest.h>
+
+#include <hubble_sat_packet_tables.h>
+#include <reed_solomon_encoder.h>
+#include <utils/bitarray.h>
+
+/* Bit at a time LFSR of the whitening */
+static uint8_t test_whitening_symbol(uint8_t *state)
+{
+	uint8_t symbol = 0U;
+
+	for (int i = 0; i < 6; i++) {
+		uint8_t fb = ((*state >> 6) ^ (*state >> 3)) & 1U;
+
+		symbol = (symbol << 1) | ((*state >> 6) & 1U);
+		*state = ((*state << 1) & 0x7FU) | fb;
+	}
+
+	return symbol;
+}
+
+ZTEST(sat_packet_tables, test_whitening)
+{
+	for (uint8_t channel = 0; channel < HUBBLE_SAT_NUM_CHANNELS;
+	     channel++) {
+		uint8_t state = (3U << 5) | 0x40U | channel;
+
+		for (size_t i = 0; i < HUBBLE_SAT_WHITENING_SIZE; i++) {
+			zassert_equal(_whitening_symbols[channel][i],
+				      test_whitening_symbol(&state),
+				      "channel %u, symbol %zu", channel, i);
+		}
+	}
+}
+
+/* Every header, built the way the packets used to build it */
+ZTEST(sat_packet_tables, test_phy_headers)
+{
+	for (uint8_t payload = 0; payload < 4; payload++) {
+		for (uint8_t hop = 0; hop < 4; hop++) {
+			for (uint8_t channel = 0; channel < 16; channel++) {
+				struct hubble_bitarray bit_array;
+				uint8_t header[HUBBLE_SAT_PHY_HEADER_SIZE];
+
+				hubble_bitarray_init(&bit_array);
+				zassert_ok(hubble_bitarray_append_value(
+					&bit_array, 1, 4));
+				zassert_ok(hubble_bitarray_append_value(
+					&bit_array, payload, 2));
+				zassert_ok(hubble_bitarray_append_value(
+					&bit_array, hop, 2));
+				zassert_ok(hubble_bitarray_append_value(
+					&bit_array, channel, 4));
+				zassert_equal(hubble_bitarray_symbols_get(
+						      &bit_array, header, 2),
+					      2);
+				zassert_ok(rse_rs_encode(header, 2, 2,
+							 &header[2]));
+
+				zassert_mem_equal(
+					_phy_headers[payload][hop][channel],
+					header, sizeof(header),
+					"payload %u, hop %u, channel %u",
+					payload, hop, channel);
+			}
+		}
+	}
+}
+
+ZTEST_SUITE(sat_packet_tables, NULL, NULL, NULL, NULL, NULL);
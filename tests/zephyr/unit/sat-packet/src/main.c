@@ -0,0 +1,379 @@
+/*
+ * Copyright (c) 2026 Hubble Network, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <hubble/hubble.h>
+#include <hubble/port/sat_radio.h>
+#include <hubble/sat.h>
+#include <hubble/sat/packet.h>
+
+#include <zephyr/sys/util.h>
+#include <zephyr/types.h>
+#include <zephyr/ztest.h>
+
+#include <errno.h>
+#include <string.h>
+
+#define TIMER_COUNTER_FREQUENCY 86400000ULL
+
+/* Symbols of the PHY header, followed by the payload codeword */
+#define PHY_HEADER_SIZE 6U
+#define PHY_HEADER_ECC  4U
+
+/* Trials per number of errors and erasures */
+#define TEST_TRIALS 8U
+
+static const uint64_t test_utc = 1760210751803ULL;
+
+/* zRWlq8BgtnKIph5E6ZW6d9FAvUZWS4jeQcFaknOwzoU= */
+static const uint8_t test_key[CONFIG_HUBBLE_KEY_SIZE] = {
+	0xcd, 0x15, 0xa5, 0xab, 0xc0, 0x60, 0xb6, 0x72, 0x88, 0xa6, 0x1e,
+	0x44, 0xe9, 0x95, 0xba, 0x77, 0xd1, 0x40, 0xbd, 0x46, 0x56, 0x4b,
+	0x88, 0xde, 0x41, 0xc1, 0x5a, 0x92, 0x73, 0xb0, 0xce, 0x85};
+
+static const uint8_t test_other_key[CONFIG_HUBBLE_KEY_SIZE] = {0x42};
+
+static const uint8_t test_payload[HUBBLE_SAT_PAYLOAD_MAX] = {
+	0x48, 0x75, 0x62, 0x62, 0x6c, 0x65, 0x20,
+	0x4e, 0x65, 0x74, 0x77, 0x6f, 0x72};
+
+/* Payload lengths and their number of payload parity symbols */
+static const struct {
+	size_t len;
+	size_t ecc;
+} test_sizes[] = {
+	{0, 10},
+	{4, 12},
+	{9, 14},
+	{13, 16},
+};
+
+static uint16_t test_seq_override;
+static uint32_t test_prng_state;
+
+uint16_t hubble_sequence_counter_get(void)
+{
+	return test_seq_override;
+}
+
+/* Implement sat board support. */
+int hubble_sat_board_init(void)
+{
+	return 0;
+}
+
+int hubble_sat_board_enable(void)
+{
+	return 0;
+}
+
+int hubble_sat_board_disable(void)
+{
+	return 0;
+}
+
+int hubble_sat_board_packet_send(const struct hubble_sat_packet *packet)
+{
+	ARG_UNUSED(packet);
+
+	return 0;
+}
+
+/* Reproducible corruption patterns */
+static uint32_t test_prng(void)
+{
+	test_prng_state = (test_prng_state * 1103515245U) + 12345U;
+
+	return test_prng_state >> 8;
+}
+
+static uint32_t test_time_counter(void)
+{
+	return test_utc / TIMER_COUNTER_FREQUENCY;
+}
+
+static void test_packet_build(size_t len, uint16_t seq_no,
+			      struct hubble_sat_packet *packet)
+{
+	test_seq_override = seq_no;
+	zassert_ok(hubble_sat_packet_get(packet, test_payload, len));
+}
+
+/*
+ * Changes @p errors symbols and erases @p erasure_count other ones,
+ * picked at random in [start, start + len).
+ */
+static size_t test_corrupt(struct hubble_sat_packet *packet, size_t start,
+			   size_t len, size_t errors, size_t erasure_count,
+			   uint8_t *erasures)
+{
+	bool used[HUBBLE_PACKET_MAX_SIZE] = {false};
+
+	for (size_t i = 0; i < errors + erasure_count; i++) {
+		size_t pos;
+
+		do {
+			pos = start + (test_prng() % len);
+		} while (used[pos]);
+		used[pos] = true;
+
+		if (i < errors) {
+			packet->data[pos] ^= 1U + (test_prng() % 63U);
+		} else {
+			/* Erased symbols can hold anything */
+			packet->data[pos] = test_prng() & 0xFFU;
+			erasures[i - errors] = pos;
+		}
+	}
+
+	return erasure_count;
+}
+
+/*
+ * Decodes a packet, returns 0 if the original payload comes out and
+ * -EFAULT if another payload is authenticated.
+ */
+static int test_decode(const struct hubble_sat_packet *packet,
+		       const uint8_t *erasures, size_t erasure_count,
+		       size_t len)
+{
+	struct hubble_sat_frame frame;
+	uint8_t payload[HUBBLE_SAT_PAYLOAD_MAX];
+	size_t payload_len;
+	int ret;
+
+	ret = hubble_sat_packet_frame_get(packet, erasures, erasure_count,
+					  &frame);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = hubble_sat_frame_verify(&frame, test_key, test_time_counter(),
+				      payload, &payload_len);
+	if (ret != 0) {
+		return ret;
+	}
+
+	if ((payload_len != len) || (memcmp(payload, test_payload, len) != 0)) {
+		return -EFAULT;
+	}
+
+	return 0;
+}
+
+ZTEST(sat_packet_test, test_loopback)
+{
+	struct hubble_sat_packet packet;
+	struct hubble_sat_frame frame;
+	uint8_t payload[HUBBLE_SAT_PAYLOAD_MAX];
+	size_t payload_len;
+
+	for (size_t i = 0; i < ARRAY_SIZE(test_sizes); i++) {
+		for (uint16_t seq_no = 0; seq_no < 1024; seq_no += 257) {
+			size_t len = test_sizes[i].len;
+
+			test_packet_build(len, seq_no, &packet);
+			zassert_equal(packet.length,
+				      PHY_HEADER_SIZE + test_sizes[i].ecc +
+					      DIV_ROUND_UP(76 + (len * 8), 6));
+
+			zassert_ok(hubble_sat_packet_frame_get(&packet, NULL, 0,
+							       &frame));
+			zassert_equal(frame.seq_no, seq_no);
+			zassert_equal(frame.data_len, len);
+			zassert_equal(frame.channel, packet.channel & 0xF);
+			zassert_equal(frame.hopping_sequence,
+				      packet.hopping_sequence);
+			zassert_equal(frame.corrected, 0);
+
+			zassert_ok(hubble_sat_frame_verify(
+				&frame, test_key, test_time_counter(), payload,
+				&payload_len));
+			zassert_equal(payload_len, len);
+			zassert_mem_equal(payload, test_payload, len);
+		}
+	}
+}
+
+ZTEST(sat_packet_test, test_wrong_key)
+{
+	struct hubble_sat_packet packet;
+	struct hubble_sat_frame frame;
+	uint8_t payload[HUBBLE_SAT_PAYLOAD_MAX];
+	size_t payload_len;
+
+	test_packet_build(HUBBLE_SAT_PAYLOAD_MAX, 7, &packet);
+	zassert_ok(hubble_sat_packet_frame_get(&packet, NULL, 0, &frame));
+
+	zassert_equal(hubble_sat_frame_verify(&frame, test_other_key,
+					      test_time_counter(), payload,
+					       &payload_len),
+		      -EBADMSG);
+	zassert_equal(hubble_sat_frame_verify(&frame, test_key,
+					      test_time_counter() + 1,
+					      payload, &payload_len),
+		      -EBADMSG);
+
+	/* Valid codeword, but not the one that was authenticated */
+	frame.seq_no ^= 1U;
+	zassert_equal(hubble_sat_frame_verify(&frame, test_key,
+					      test_time_counter(), payload,
+					       &payload_len),
+		      -EBADMSG);
+	frame.seq_no ^= 1U;
+
+	frame.data[0] ^= 1U;
+	zassert_equal(hubble_sat_frame_verify(&frame, test_key,
+					      test_time_counter(), payload,
+					       &payload_len),
+		      -EBADMSG);
+}
+
+ZTEST(sat_packet_test, test_invalid)
+{
+	struct hubble_sat_packet packet;
+	struct hubble_sat_frame frame;
+	uint8_t erasure;
+
+	test_packet_build(4, 1, &packet);
+
+	zassert_equal(hubble_sat_packet_frame_get(NULL, NULL, 0, &frame),
+		      -EINVAL);
+	zassert_equal(hubble_sat_packet_frame_get(&packet, NULL, 0, NULL),
+		      -EINVAL);
+	zassert_equal(hubble_sat_packet_frame_get(&packet, NULL, 1, &frame),
+		      -EINVAL);
+
+	erasure = packet.length;
+	zassert_equal(hubble_sat_packet_frame_get(&packet, &erasure, 1,
+						  &frame),
+		      -EINVAL);
+
+	/* Length does not match the header */
+	packet.length--;
+	zassert_equal(hubble_sat_packet_frame_get(&packet, NULL, 0, &frame),
+		      -EINVAL);
+	packet.length++;
+
+	/* Whitened for another channel */
+	packet.channel = (packet.channel + 1) % HUBBLE_SAT_NUM_CHANNELS;
+	zassert_equal(hubble_sat_packet_frame_get(&packet, NULL, 0, &frame),
+		      -EBADMSG);
+}
+
+/* The sequences themselves are checked by the sat-packet-tables test */
+ZTEST(sat_packet_test, test_dewhiten)
+{
+	struct hubble_sat_packet packet;
+	struct hubble_sat_packet whitened;
+	uint8_t *symbols = &packet.data[PHY_HEADER_SIZE];
+	size_t len;
+
+	test_packet_build(HUBBLE_SAT_PAYLOAD_MAX, 3, &packet);
+	whitened = packet;
+	len = packet.length - PHY_HEADER_SIZE;
+
+	zassert_ok(hubble_sat_packet_dewhiten(packet.channel, symbols, len));
+	zassert_true(memcmp(symbols, &whitened.data[PHY_HEADER_SIZE], len) !=
+		     0);
+
+	/* Whitening again gives the packet back */
+	zassert_ok(hubble_sat_packet_dewhiten(packet.channel, symbols, len));
+	zassert_mem_equal(packet.data, whitened.data, packet.length);
+
+	zassert_equal(hubble_sat_packet_dewhiten(HUBBLE_SAT_NUM_CHANNELS,
+						 symbols, len),
+		      -EINVAL);
+	zassert_equal(hubble_sat_packet_dewhiten(0, symbols,
+						 HUBBLE_PACKET_MAX_SIZE -
+							 PHY_HEADER_SIZE + 1),
+		      -EINVAL);
+	zassert_equal(hubble_sat_packet_dewhiten(0, NULL, 1), -EINVAL);
+}
+
+/*
+ * Checks that every pattern with 2 * errors + erasures within the parity
+ * symbols of each codeword is corrected, and reports how often packets
+ * with more errors are still recovered.
+ */
+ZTEST(sat_packet_test, test_error_tolerance)
+{
+	struct hubble_sat_packet packet;
+	struct hubble_sat_packet corrupted;
+	uint8_t erasures[HUBBLE_PACKET_MAX_SIZE];
+	int ret;
+
+	test_prng_state = 1U;
+
+	for (size_t i = 0; i < ARRAY_SIZE(test_sizes); i++) {
+		size_t len = test_sizes[i].len;
+		size_t ecc = test_sizes[i].ecc;
+
+		test_packet_build(len, 42, &packet);
+
+		for (size_t errors = 0; errors <= (ecc / 2) + 2; errors++) {
+			size_t recovered = 0;
+
+			for (size_t trial = 0; trial < TEST_TRIALS; trial++) {
+				size_t erasure_count = 0;
+				size_t header_errors = trial % 3;
+				size_t header_erasures =
+					PHY_HEADER_ECC - (2 * header_errors);
+				size_t payload_erasures =
+					(errors <= ecc / 2)
+						? ecc - (2 * errors)
+						: 0;
+
+				corrupted = packet;
+
+				/* Header at its limit too */
+				erasure_count += test_corrupt(
+					&corrupted, 0, PHY_HEADER_SIZE,
+					header_errors, header_erasures,
+					&erasures[erasure_count]);
+
+				/* Erasures on half of the trials only */
+				if ((trial % 2) != 0) {
+					payload_erasures = 0;
+				}
+
+				erasure_count += test_corrupt(
+					&corrupted, PHY_HEADER_SIZE,
+					packet.length - PHY_HEADER_SIZE,
+					errors, payload_erasures,
+					&erasures[erasure_count]);
+
+				ret = test_decode(&corrupted, erasures,
+						  erasure_count, len);
+
+				/* Never authenticate a wrong payload */
+				zassert_not_equal(ret, -EFAULT);
+
+				if (ret == 0) {
+					recovered++;
+				} else {
+					zassert_true(errors > ecc / 2,
+						     "%zu bytes, %zu errors, "
+						     "%zu erasures not "
+						     "corrected",
+						     len, errors,
+						     payload_erasures);
+				}
+			}
+
+			TC_PRINT("ecc %2zu: %2zu errors, %zu/%u recovered\n",
+				 ecc, errors, recovered, TEST_TRIALS);
+		}
+	}
+}
+
+static void *sat_packet_test_setup(void)
+{
+	zassert_ok(hubble_init(test_utc, test_key));
+
+	return NULL;
+}
+
+ZTEST_SUITE(sat_packet_test, NULL, sat_packet_test_setup, NULL, NULL, NULL);
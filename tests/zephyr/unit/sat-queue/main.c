@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2026 Hubble Network, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Run the transmit priority queue from a single context */
+
+#include <zephyr/ztest.h>
+
+#include <hubble_sat_queue.h>
+
+#include <errno.h>
+#include <string.h>
+
+#define TEST_RING    4
+#define TEST_ENTRIES 4
+
+struct test_packet {
+	int status;
+	int done_count;
+};
+
+static struct hubble_sat_queue_item test_ring[TEST_RING + 1];
+static struct hubble_sat_queue_entry test_pool[TEST_ENTRIES];
+static struct hubble_sat_queue test_queue =
+	HUBBLE_SAT_QUEUE_INITIALIZER(test_ring, test_pool);
+
+static void test_done_cb(int status, void *user_data)
+{
+	struct test_packet *p = user_data;
+
+	p->status = status;
+	p->done_count++;
+}
+
+static void test_insert(struct test_packet *p, uint8_t priority,
+			uint16_t key, uint32_t lifetime_ms, uint64_t now_ms)
+{
+	struct hubble_sat_queue_item item = {
+		.cb = test_done_cb,
+		.user_data = p,
+		.lifetime_ms = lifetime_ms,
+		.key = key,
+		.priority = priority,
+		.retries = 1,
+	};
+
+	hubble_sat_queue_insert(&test_queue, &item, now_ms);
+}
+
+static struct test_packet *test_pop(uint64_t now_ms, uint64_t *deadline_ms)
+{
+	struct hubble_sat_queue_item item;
+	uint64_t deadline;
+
+	if (!hubble_sat_queue_pop(&test_queue, now_ms, &item, &deadline)) {
+		return NULL;
+	}
+
+	if (deadline_ms != NULL) {
+		*deadline_ms = deadline;
+	}
+
+	return item.user_data;
+}
+
+ZTEST(sat_queue, test_ring)
+{
+	struct hubble_sat_queue_item item = {0};
+
+	zassert_false(hubble_sat_queue_get(&test_queue, &item));
+
+	/* In the order they were pushed, one slot is kept empty */
+	for (int i = 0; i < TEST_RING; i++) {
+		item.retries = i + 1;
+		zassert_ok(hubble_sat_queue_push(&test_queue, &item));
+	}
+	zassert_equal(hubble_sat_queue_push(&test_queue, &item), -EAGAIN);
+
+	for (int i = 0; i < TEST_RING; i++) {
+		zassert_true(hubble_sat_queue_get(&test_queue, &item));
+		zassert_equal(item.retries, i + 1);
+	}
+	zassert_false(hubble_sat_queue_get(&test_queue, &item));
+
+	/* Wraps around */
+	for (int i = 0; i < 3 * TEST_RING; i++) {
+		item.retries = i;
+		zassert_ok(hubble_sat_queue_push(&test_queue, &item));
+		zassert_true(hubble_sat_queue_get(&test_queue, &item));
+		zassert_equal(item.retries, i);
+	}
+}
+
+ZTEST(sat_queue, test_order)
+{
+	struct test_packet p[TEST_ENTRIES];
+	uint64_t deadline_ms;
+
+	test_insert(&p[0], 0, 0, 0, 0);
+	test_insert(&p[1], 1, 0, 0, 0);
+	test_insert(&p[2], 0, 0, 0, 0);
+	test_insert(&p[3], 1, 0, 0, 0);
+	zassert_true(hubble_sat_queue_full(&test_queue));
+
+	/* Highest priority, then freshest */
+	zassert_equal_ptr(test_pop(0, &deadline_ms), &p[3]);
+	zassert_equal(deadline_ms, UINT64_MAX);
+	zassert_false(hubble_sat_queue_full(&test_queue));
+	zassert_equal_ptr(test_pop(0, NULL), &p[1]);
+	zassert_equal_ptr(test_pop(0, NULL), &p[2]);
+	zassert_equal_ptr(test_pop(0, NULL), &p[0]);
+	zassert_is_null(test_pop(0, NULL));
+}
+
+ZTEST(sat_queue, test_coalesce)
+{
+	struct test_packet a = {0};
+	struct test_packet b = {0};
+	struct test_packet c = {0};
+
+	test_insert(&a, 0, 7, 0, 0);
+	test_insert(&b, 0, 0, 0, 0);
+	test_insert(&c, 0, 7, 1000, 100);
+
+	/* The newer reading took the place of the older one */
+	zassert_equal(a.done_count, 1);
+	zassert_equal(a.status, -ECANCELED);
+	zassert_equal(test_queue.count, 2);
+
+	zassert_equal_ptr(test_pop(100, NULL), &c);
+	zassert_equal_ptr(test_pop(100, NULL), &b);
+	zassert_is_null(test_pop(100, NULL));
+	zassert_equal(c.done_count, 0);
+}
+
+ZTEST(sat_queue, test_evict)
+{
+	struct test_packet p[TEST_ENTRIES] = {0};
+	struct test_packet high = {0};
+	struct test_packet low = {0};
+
+	test_insert(&p[0], 1, 0, 0, 0);
+	test_insert(&p[1], 1, 0, 0, 0);
+	test_insert(&p[2], 2, 0, 0, 0);
+	test_insert(&p[3], 1, 0, 0, 0);
+
+	/* The oldest with the lowest priority makes room */
+	test_insert(&high, 1, 0, 0, 0);
+	zassert_equal(p[0].done_count, 1);
+	zassert_equal(p[0].status, -ENOBUFS);
+	zassert_equal(test_queue.count, TEST_ENTRIES);
+
+	/* Not for a lower priority */
+	test_insert(&low, 0, 0, 0, 0);
+	zassert_equal(low.done_count, 1);
+	zassert_equal(low.status, -ENOBUFS);
+
+	zassert_equal_ptr(test_pop(0, NULL), &p[2]);
+	zassert_equal_ptr(test_pop(0, NULL), &high);
+	zassert_equal(p[1].done_count + p[2].done_count + p[3].done_count, 0);
+}
+
+ZTEST(sat_queue, test_expire)
+{
+	struct test_packet a = {0};
+	struct test_packet b = {0};
+	uint64_t deadline_ms;
+
+	test_insert(&a, 1, 0, 500, 1000);
+	test_insert(&b, 0, 0, 2000, 1000);
+
+	zassert_equal_ptr(test_pop(1200, &deadline_ms), &a);
+	zassert_equal(deadline_ms, 1500U);
+	zassert_equal(a.done_count, 0);
+
+	test_insert(&a, 1, 0, 500, 1200);
+	zassert_equal_ptr(test_pop(2000, &deadline_ms), &b);
+	zassert_equal(deadline_ms, 3000U);
+	zassert_equal(a.done_count, 1);
+	zassert_equal(a.status, -ETIMEDOUT);
+	zassert_is_null(test_pop(2000, NULL));
+}
+
+static void test_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	memset(test_pool, 0, sizeof(test_pool));
+	test_queue.count = 0;
+	/* Freshness must hold across the wrap of the sequence */
+	test_queue.seq = UINT32_MAX - 1;
+	atomic_store(&test_queue.head, 0);
+	atomic_store(&test_queue.tail, 0);
+}
+
+ZTEST_SUITE(sat_queue, NULL, NULL, test_before, NULL, NULL);
@@ -0,0 +1,414 @@
+/*
+ * Copyright (c) 2026 Hubble Network, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Run the transmit scheduler against a fake clock */
+
+#include <zephyr/ztest.h>
+
+#include <hubble_sat_scheduler.h>
+
+#include <errno.h>
+#include <string.h>
+
+#define TEST_ENTRIES 4
+#define TEST_LOG_MAX 64
+
+/* Time on air of a packet */
+#define TEST_TX_MS   500U
+
+struct test_packet {
+	int id;
+	int status;
+	uint64_t done_ms;
+	int done_count;
+};
+
+static struct hubble_sat_scheduler_entry test_entries[TEST_ENTRIES];
+static struct hubble_sat_scheduler test_sched;
+static struct hubble_sat_packet test_pkt;
+
+/* Transmissions: id of the packet and start time */
+static int test_log_id[TEST_LOG_MAX];
+static uint64_t test_log_ms[TEST_LOG_MAX];
+static int test_log_count;
+
+static uint64_t test_now_ms;
+
+static void test_sent_cb(int status, void *user_data)
+{
+	struct test_packet *p = user_data;
+
+	p->status = status;
+	p->done_ms = test_now_ms;
+	p->done_count++;
+}
+
+/*
+ * Runs the scheduler until it is empty, every transmission takes
+ * TEST_TX_MS and the offsets are taken in turn from @p offsets.
+ */
+static void test_run(const int16_t *offsets, size_t offset_count,
+		     int fail_at)
+{
+	struct hubble_sat_scheduler_entry *entry;
+	uint64_t wait_ms;
+	size_t offset_idx = 0;
+	int16_t offset;
+	int status;
+
+	for (;;) {
+		entry = hubble_sat_scheduler_next(&test_sched, test_now_ms,
+						  &wait_ms);
+		if (entry == NULL) {
+			if (wait_ms == HUBBLE_SAT_SCHEDULER_WAIT_FOREVER) {
+				return;
+			}
+			zassert_true(wait_ms > 0);
+			test_now_ms += wait_ms;
+			continue;
+		}
+
+		zassert_true(test_log_count < TEST_LOG_MAX);
+		test_log_id[test_log_count] =
+			((struct test_packet *)entry->user_data)->id;
+		test_log_ms[test_log_count] = test_now_ms;
+		test_log_count++;
+
+		status = (test_log_count == fail_at) ? -EIO : 0;
+		offset = (offset_count > 0) ? offsets[offset_idx % offset_count]
+					    : 0;
+		offset_idx++;
+
+		test_now_ms += TEST_TX_MS;
+		hubble_sat_scheduler_done(&test_sched, entry, status,
+					  test_now_ms, offset);
+	}
+}
+
+ZTEST(sat_scheduler, test_single)
+{
+	struct test_packet a = {.id = 1};
+	uint64_t wait_ms;
+
+	zassert_is_null(hubble_sat_scheduler_next(&test_sched, 0, &wait_ms));
+	zassert_equal(wait_ms, HUBBLE_SAT_SCHEDULER_WAIT_FOREVER);
+
+	test_now_ms = 1000U;
+	zassert_ok(hubble_sat_scheduler_add(&test_sched, &test_pkt, 3, 10,
+					    test_sent_cb, &a, test_now_ms));
+	test_run(NULL, 0, 0);
+
+	/* Same timing as the blocking transmission */
+	zassert_equal(test_log_count, 3);
+	zassert_equal(test_log_ms[0], 1000U);
+	zassert_equal(test_log_ms[1], 1000U + TEST_TX_MS + 10000U);
+	zassert_equal(test_log_ms[2], 1000U + 2 * (TEST_TX_MS + 10000U));
+
+	zassert_equal(a.done_count, 1);
+	zassert_ok(a.status);
+	zassert_equal(a.done_ms, test_log_ms[2] + TEST_TX_MS);
+}
+
+ZTEST(sat_scheduler, test_interleave)
+{
+	struct test_packet a = {.id = 1};
+	struct test_packet b = {.id = 2};
+	struct test_packet c = {.id = 3};
+	static const int expected[] = {1, 2, 3, 3, 1, 2, 3, 1, 2, 1};
+
+	zassert_ok(hubble_sat_scheduler_add(&test_sched, &test_pkt, 4, 20,
+					    test_sent_cb, &a, 0));
+	zassert_ok(hubble_sat_scheduler_add(&test_sched, &test_pkt, 3, 20,
+					    test_sent_cb, &b, 0));
+	zassert_ok(hubble_sat_scheduler_add(&test_sched, &test_pkt, 3, 10,
+					    test_sent_cb, &c, 0));
+	test_run(NULL, 0, 0);
+
+	zassert_equal(test_log_count, ARRAY_SIZE(expected));
+	for (int i = 0; i < test_log_count; i++) {
+		zassert_equal(test_log_id[i], expected[i], "transmission %d",
+			      i);
+	}
+
+	/* The retries of b and c fill the gaps of a, a is not delayed */
+	zassert_equal(a.done_ms, 3 * (TEST_TX_MS + 20000U) + TEST_TX_MS);
+	zassert_equal(b.done_ms, a.done_ms - 20000U);
+	zassert_ok(a.status);
+	zassert_ok(b.status);
+	zassert_ok(c.status);
+
+	/* Each packet still waits its interval between two retries */
+	for (int i = 0; i < test_log_count; i++) {
+		for (int j = i + 1; j < test_log_count; j++) {
+			if (test_log_id[j] != test_log_id[i]) {
+				continue;
+			}
+
+			zassert_true(test_log_ms[j] - test_log_ms[i] >=
+				     TEST_TX_MS +
+					     ((test_log_id[i] == 3) ? 10000U
+								    : 20000U));
+			break;
+		}
+	}
+}
+
+ZTEST(sat_scheduler, test_offset)
+{
+	struct test_packet a = {.id = 1};
+	struct test_packet b = {.id = 2};
+	static const int16_t offsets[] = {1000, -1000, -500};
+
+	zassert_ok(hubble_sat_scheduler_add(&test_sched, &test_pkt, 4, 10,
+					    test_sent_cb, &a, 0));
+	test_run(offsets, ARRAY_SIZE(offsets), 0);
+
+	zassert_equal(test_log_count, 4);
+	zassert_equal(test_log_ms[1] - test_log_ms[0], TEST_TX_MS + 11000U);
+	zassert_equal(test_log_ms[2] - test_log_ms[1], TEST_TX_MS + 9000U);
+	zassert_equal(test_log_ms[3] - test_log_ms[2], TEST_TX_MS + 9500U);
+
+	/* An offset larger than the interval does not go back in time */
+	test_log_count = 0;
+	test_now_ms = 100000U;
+	zassert_ok(hubble_sat_scheduler_add(&test_sched, &test_pkt, 2, 0,
+					    test_sent_cb, &b, test_now_ms));
+	test_run(&offsets[1], 1, 0);
+
+	zassert_equal(test_log_count, 2);
+	zassert_equal(test_log_ms[1], test_log_ms[0] + TEST_TX_MS);
+}
+
+ZTEST(sat_scheduler, test_failure)
+{
+	struct test_packet a = {.id = 1};
+	struct test_packet b = {.id = 2};
+
+	zassert_ok(hubble_sat_scheduler_add(&test_sched, &test_pkt, 3, 10,
+					    test_sent_cb, &a, 0));
+	zassert_ok(hubble_sat_scheduler_add(&test_sched, &test_pkt, 3, 10,
+					    test_sent_cb, &b, 0));
+
+	/* Second transmission, first one of b, fails */
+	test_run(NULL, 0, 2);
+
+	zassert_equal(test_log_count, 4);
+	zassert_equal(b.done_count, 1);
+	zassert_equal(b.status, -EIO);
+	zassert_equal(b.done_ms, test_log_ms[1] + TEST_TX_MS);
+	zassert_equal(a.done_count, 1);
+	zassert_ok(a.status);
+}
+
+static struct test_packet test_chained = {.id = 2};
+
+static void test_chain_cb(int status, void *user_data)
+{
+	test_sent_cb(status, user_data);
+
+	/* The entry is free again when the callback runs */
+	zassert_ok(hubble_sat_scheduler_add(&test_sched, &test_pkt, 1, 0,
+					    test_sent_cb, &test_chained,
+					    test_now_ms));
+}
+
+ZTEST(sat_scheduler, test_full)
+{
+	struct test_packet p[TEST_ENTRIES + 1];
+
+	zassert_equal(hubble_sat_scheduler_add(&test_sched, &test_pkt, 0, 10,
+					       test_sent_cb, &p[0], 0),
+		      -EINVAL);
+
+	for (int i = 0; i < TEST_ENTRIES; i++) {
+		p[i] = (struct test_packet){.id = 1};
+		zassert_false(hubble_sat_scheduler_full(&test_sched));
+		zassert_ok(hubble_sat_scheduler_add(
+			&test_sched, &test_pkt, 1, 0,
+			(i == 0) ? test_chain_cb : test_sent_cb, &p[i], 0));
+	}
+
+	zassert_true(hubble_sat_scheduler_full(&test_sched));
+	zassert_equal(hubble_sat_scheduler_add(&test_sched, &test_pkt, 1, 0,
+					       test_sent_cb,
+					       &p[TEST_ENTRIES], 0),
+		      -EAGAIN);
+
+	test_run(NULL, 0, 0);
+
+	zassert_equal(test_log_count, TEST_ENTRIES + 1);
+	zassert_equal(test_log_id[TEST_ENTRIES], 2);
+	zassert_equal(test_chained.done_count, 1);
+	zassert_false(hubble_sat_scheduler_full(&test_sched));
+}
+
+ZTEST(sat_scheduler, test_window)
+{
+	struct test_packet a = {.id = 1};
+	struct test_packet b = {.id = 2};
+	uint64_t wait_ms;
+
+	/* Held until the window opens */
+	hubble_sat_scheduler_window_set(&test_sched, 5000U, 27000U);
+	zassert_ok(hubble_sat_scheduler_add(&test_sched, &test_pkt, 4, 10,
+					    test_sent_cb, &a, 0));
+	zassert_ok(hubble_sat_scheduler_add(&test_sched, &test_pkt, 2, 10,
+					    test_sent_cb, &b, 1000U));
+	zassert_is_null(hubble_sat_scheduler_next(&test_sched, 0, &wait_ms));
+	zassert_equal(wait_ms, 5000U);
+
+	/* The retries that do not fit wait for the next window */
+	test_run(NULL, 0, 0);
+	zassert_true(hubble_sat_scheduler_window_over(&test_sched,
+						      test_now_ms));
+	zassert_equal(test_now_ms, 27000U);
+	zassert_equal(test_log_count, 5);
+	zassert_equal(test_log_ms[0], 5000U);
+	zassert_equal(test_log_ms[1], 5000U + TEST_TX_MS);
+	zassert_equal(test_log_ms[4], 5000U + 2 * (TEST_TX_MS + 10000U));
+	zassert_equal(b.done_count, 1);
+	zassert_equal(a.done_count, 0);
+	zassert_is_null(hubble_sat_scheduler_next(&test_sched, test_now_ms,
+						  &wait_ms));
+	zassert_equal(wait_ms, HUBBLE_SAT_SCHEDULER_WAIT_FOREVER);
+
+	hubble_sat_scheduler_window_set(&test_sched, 100000U, 200000U);
+	test_run(NULL, 0, 0);
+	zassert_equal(test_log_count, 6);
+	zassert_equal(test_log_ms[5], 100000U);
+	zassert_equal(a.done_count, 1);
+	zassert_ok(a.status);
+
+	/* No restriction anymore */
+	hubble_sat_scheduler_window_clear(&test_sched);
+	zassert_ok(hubble_sat_scheduler_add(&test_sched, &test_pkt, 1, 0,
+					    test_sent_cb, &b, test_now_ms));
+	zassert_not_null(hubble_sat_scheduler_next(&test_sched, test_now_ms,
+						   &wait_ms));
+	zassert_false(hubble_sat_scheduler_window_over(&test_sched,
+						       test_now_ms));
+}
+
+ZTEST(sat_scheduler, test_priority)
+{
+	struct test_packet a = {.id = 1};
+	struct test_packet b = {.id = 2};
+	struct test_packet c = {.id = 3};
+	static const int expected[] = {2, 3, 1, 3, 1};
+
+	zassert_ok(hubble_sat_scheduler_add_priority(
+		&test_sched, &test_pkt, 2, 10, 0, 0,
+		HUBBLE_SAT_SCHEDULER_WAIT_FOREVER, test_sent_cb, &a, 0));
+	zassert_ok(hubble_sat_scheduler_add_priority(
+		&test_sched, &test_pkt, 2, 10, 1, 0,
+		HUBBLE_SAT_SCHEDULER_WAIT_FOREVER, test_sent_cb, &c, 0));
+	zassert_ok(hubble_sat_scheduler_add_priority(
+		&test_sched, &test_pkt, 1, 10, 2, 0,
+		HUBBLE_SAT_SCHEDULER_WAIT_FOREVER, test_sent_cb, &b, 0));
+	test_run(NULL, 0, 0);
+
+	/* Highest priority first among the due ones only */
+	zassert_equal(test_log_count, ARRAY_SIZE(expected));
+	for (int i = 0; i < test_log_count; i++) {
+		zassert_equal(test_log_id[i], expected[i], "transmission %d",
+			      i);
+	}
+	zassert_equal(test_log_ms[3], 2 * TEST_TX_MS + 10000U);
+}
+
+ZTEST(sat_scheduler, test_deadline)
+{
+	struct test_packet a = {.id = 1};
+	struct test_packet b = {.id = 2};
+	uint64_t wait_ms;
+
+	/* Expires while held until the window opens */
+	hubble_sat_scheduler_window_set(&test_sched, 5000U, 100000U);
+	zassert_ok(hubble_sat_scheduler_add_priority(&test_sched, &test_pkt,
+						     1, 0, 0, 0, 3000U,
+						     test_sent_cb, &a, 0));
+	zassert_ok(hubble_sat_scheduler_add_priority(&test_sched, &test_pkt,
+						     2, 10, 0, 0, 6000U,
+						     test_sent_cb, &b, 0));
+	zassert_is_null(hubble_sat_scheduler_next(&test_sched, 0, &wait_ms));
+	zassert_equal(wait_ms, 3000U);
+
+	test_run(NULL, 0, 0);
+	zassert_equal(a.done_count, 1);
+	zassert_equal(a.status, -ETIMEDOUT);
+	zassert_equal(a.done_ms, 3000U);
+
+	/* Only the first transmission has to meet the deadline */
+	zassert_equal(test_log_count, 2);
+	zassert_equal(test_log_id[0], 2);
+	zassert_equal(test_log_ms[0], 5000U);
+	zassert_equal(test_log_ms[1], 5000U + TEST_TX_MS + 10000U);
+	zassert_equal(b.done_count, 1);
+	zassert_ok(b.status);
+}
+
+ZTEST(sat_scheduler, test_replace)
+{
+	struct test_packet a = {.id = 1};
+	struct test_packet b = {.id = 2};
+	struct test_packet c = {.id = 3};
+	uint64_t wait_ms;
+
+	zassert_equal(hubble_sat_scheduler_replace(
+			      &test_sched, &test_pkt, 1, 0, 0, 7,
+			      HUBBLE_SAT_SCHEDULER_WAIT_FOREVER, test_sent_cb,
+			      &b, 0),
+		      -ENOENT);
+	zassert_equal(hubble_sat_scheduler_replace(
+			      &test_sched, &test_pkt, 1, 0, 0, 0,
+			      HUBBLE_SAT_SCHEDULER_WAIT_FOREVER, test_sent_cb,
+			      &b, 0),
+		      -EINVAL);
+
+	/* Superseded while held until the window opens */
+	hubble_sat_scheduler_window_set(&test_sched, 5000U, 100000U);
+	zassert_ok(hubble_sat_scheduler_add_priority(
+		&test_sched, &test_pkt, 2, 10, 0, 7,
+		HUBBLE_SAT_SCHEDULER_WAIT_FOREVER, test_sent_cb, &a, 0));
+	zassert_ok(hubble_sat_scheduler_replace(
+		&test_sched, &test_pkt, 1, 0, 1, 7,
+		HUBBLE_SAT_SCHEDULER_WAIT_FOREVER, test_sent_cb, &b, 1000U));
+	zassert_equal(a.done_count, 1);
+	zassert_equal(a.status, -ECANCELED);
+	zassert_equal(test_sched.count, 1);
+
+	/* Not once its first transmission started */
+	zassert_is_null(hubble_sat_scheduler_next(&test_sched, 0, &wait_ms));
+	test_now_ms = 5000U;
+	zassert_not_null(hubble_sat_scheduler_next(&test_sched, test_now_ms,
+						   &wait_ms));
+	zassert_equal(hubble_sat_scheduler_replace(
+			      &test_sched, &test_pkt, 1, 0, 0, 7,
+			      HUBBLE_SAT_SCHEDULER_WAIT_FOREVER, test_sent_cb,
+			      &c, test_now_ms),
+		      -ENOENT);
+
+	test_run(NULL, 0, 0);
+	zassert_equal(test_log_count, 1);
+	zassert_equal(test_log_id[0], 2);
+	zassert_equal(b.done_count, 1);
+	zassert_ok(b.status);
+	zassert_equal(c.done_count, 0);
+}
+
+static void test_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	hubble_sat_scheduler_init(&test_sched, test_entries,
+				  ARRAY_SIZE(test_entries));
+	memset(&test_pkt, 0, sizeof(test_pkt));
+	test_log_count = 0;
+	test_now_ms = 0U;
+	test_chained.done_count = 0;
+}
+
+ZTEST_SUITE(sat_scheduler, NULL, NULL, test_before, NULL, NULL);
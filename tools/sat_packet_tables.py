@@ -0,0 +1,216 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2026 Hubble Network, Inc.
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""Generate the constant tables used to build V1 satellite packets.
+
+The output is src/hubble_sat_packet_tables.h, run the script again when
+the packet format changes.
+"""
+
+import argparse
+import os
+
+
+NUM_CHANNELS = 19
+SYMBOL_SIZE = 6
+
+# Payload symbols and their parity symbols, the PHY header is not whitened
+WHITENING_SIZE = 46
+
+# PHY header fields and their values
+PHY_PROTOCOL_VERSION = 1
+PHY_PAYLOAD_SYMBOLS = 4
+PHY_HOPPING_SEQUENCES = 4
+PHY_CHANNEL_SIZE = 4
+
+# PHY header: 2 data symbols, 4 parity symbols (t = 2)
+PHY_SYMBOLS = 2
+PHY_TT = 2
+
+# GF(2^6), p(X) = 1 + X + X^6
+GF_POLY = 0x43
+GF_SIZE = 63
+
+HEADER = """/*
+ * Copyright (c) 2026 Hubble Network, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * This file contents was automatically generated by
+ * tools/sat_packet_tables.py, do not edit.
+ */
+
+#ifndef SRC_HUBBLE_SAT_PACKET_TABLES_H
+#define SRC_HUBBLE_SAT_PACKET_TABLES_H
+
+#include <stdint.h>
+
+#include <hubble/port/sat_radio.h>
+"""
+
+FOOTER = """
+#endif /* SRC_HUBBLE_SAT_PACKET_TABLES_H */
+"""
+
+
+def whitening_symbols(channel: int, count: int) -> list:
+    """Output of the 7 bits LFSR (x^7 + x^4 + 1) seeded with the channel."""
+    state = 0x60 | channel
+    symbols = []
+
+    for _ in range(count):
+        symbol = 0
+        for _ in range(SYMBOL_SIZE):
+            symbol = (symbol << 1) | ((state >> 6) & 1)
+            feedback = ((state >> 6) ^ (state >> 3)) & 1
+            state = ((state << 1) & 0x7F) | feedback
+        symbols.append(symbol)
+
+    return symbols
+
+
+def gf_tables() -> tuple:
+    """Antilog and log tables of GF(2^6)."""
+    exp = []
+    log = [0] * (GF_SIZE + 1)
+    value = 1
+
+    for i in range(GF_SIZE):
+        exp.append(value)
+        log[value] = i
+        value <<= 1
+        if value & 0x40:
+            value ^= GF_POLY
+
+    return exp, log
+
+
+GF_EXP, GF_LOG = gf_tables()
+
+
+def gf_mul(a: int, b: int) -> int:
+    if a == 0 or b == 0:
+        return 0
+
+    return GF_EXP[(GF_LOG[a] + GF_LOG[b]) % GF_SIZE]
+
+
+def rs_parity(data: list, tt: int) -> list:
+    """Parity symbols, as src/reed_solomon_encoder.c computes them."""
+    # Product of (X + alpha^i), i = 1 .. 2tt, lowest degree first
+    gen = [1]
+    for i in range(1, 2 * tt + 1):
+        nxt = [0] * (len(gen) + 1)
+        for j, coeff in enumerate(gen):
+            nxt[j + 1] ^= coeff
+            nxt[j] ^= gf_mul(coeff, GF_EXP[i])
+        gen = nxt
+
+    bb = [0] * (2 * tt)
+    for symbol in data:
+        feedback = symbol ^ bb[-1]
+        bb = [0] + bb[:-1]
+        for j in range(2 * tt):
+            bb[j] ^= gf_mul(gen[j], feedback)
+
+    return bb[::-1]
+
+
+def phy_header(payload: int, hopping_sequence: int, channel: int) -> list:
+    """Symbols of the PHY header: 4 bits version, 2 bits payload length
+    symbol, 2 bits hopping sequence, 4 bits channel, then parity."""
+    bits = (PHY_PROTOCOL_VERSION << 8) | (payload << 6) | \
+        (hopping_sequence << 4) | channel
+    data = [(bits >> 6) & 0x3F, bits & 0x3F]
+
+    return data + rs_parity(data, PHY_TT)
+
+
+def format_values(values: list, indent: int) -> str:
+    """Comma separated values, wrapped at 80 columns (8 columns tabs)."""
+    lines = []
+    line = ""
+
+    for value in values:
+        item = f"{value},"
+        if line and (indent * 8 + len(line) + 1 + len(item)) > 80:
+            lines.append(line)
+            line = ""
+        line = f"{line} {item}" if line else item
+
+    lines.append(line)
+
+    return "\n".join("\t" * indent + line for line in lines)
+
+
+def whitening_table() -> str:
+    rows = []
+
+    for channel in range(NUM_CHANNELS):
+        values = format_values(whitening_symbols(channel, WHITENING_SIZE), 2)
+        rows.append(f"\t/* Channel {channel} */\n\t{{\n{values}\n\t}},")
+
+    return f"""
+/* Symbols of a payload and its parity symbols, the PHY header excluded */
+#define HUBBLE_SAT_WHITENING_SIZE {WHITENING_SIZE}U
+
+/* Whitening symbols, XORed to the payload symbols, for each channel */
+static const uint8_t _whitening_symbols[HUBBLE_SAT_NUM_CHANNELS]
+				       [HUBBLE_SAT_WHITENING_SIZE] = {{
+{chr(10).join(rows)}
+}};
+"""
+
+
+def phy_header_table() -> str:
+    blocks = []
+    channels = 1 << PHY_CHANNEL_SIZE
+
+    for payload in range(PHY_PAYLOAD_SYMBOLS):
+        hops = []
+        for hop in range(PHY_HOPPING_SEQUENCES):
+            rows = []
+            for channel in range(channels):
+                values = ", ".join(str(x) for x in
+                                   phy_header(payload, hop, channel))
+                rows.append(f"\t\t\t{{{values}}},")
+            hops.append(f"\t\t/* Hopping sequence {hop} */\n\t\t{{\n" +
+                        "\n".join(rows) + "\n\t\t},")
+        blocks.append(f"\t/* Payload length symbol {payload} */\n\t{{\n" +
+                      "\n".join(hops) + "\n\t},")
+
+    return f"""
+/* PHY header data and parity symbols */
+#define HUBBLE_SAT_PHY_HEADER_SIZE {PHY_SYMBOLS + 2 * PHY_TT}U
+
+/*
+ * PHY headers of version {PHY_PROTOCOL_VERSION} for each payload length symbol, hopping
+ * sequence and channel field (the {PHY_CHANNEL_SIZE} least significant bits of the
+ * channel).
+ */
+static const uint8_t _phy_headers[{PHY_PAYLOAD_SYMBOLS}][{PHY_HOPPING_SEQUENCES}][{channels}]
+				 [HUBBLE_SAT_PHY_HEADER_SIZE] = {{
+{chr(10).join(blocks)}
+}};
+"""
+
+
+def main() -> None:
+    default = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..",
+                           "src", "hubble_sat_packet_tables.h")
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("-o", "--output", default=default,
+                        help="Output file (default: %(default)s)")
+    args = parser.parse_args()
+
+    with open(args.output, "w", encoding="utf-8") as f:
+        f.write(HEADER + whitening_table() + phy_header_table() + FOOTER)
+
+
+if __name__ == "__main__":
+    main()